@@ -0,0 +1,312 @@
+#include "../include/adsl/adsl_api.hpp"
+#include "../include/adsl/adsl_groups.hpp"
+#include "../include/adsl/adsl_stream.hpp"
+#include "adsl_corpus.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+    #define NOMINMAX
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+/*
+ *   adsl_bench [--entities=N] [--fields=N] [--list=N] [--types=N] [--groups=N]
+ *              [--group-density=P] [--comments=P] [--seed=N] [--repeat=N]
+ *              [--corpus=PATH] [--out=PATH]
+ *
+ * Generates a corpus (adsl_corpus.hpp), writes it to --corpus (default
+ * adsl_bench_corpus.adsl, removed afterwards) and times every operation
+ * --repeat times. The JSON report (stdout or --out) gives the best run of
+ * each : seconds, MB/s over the text read or written and entities/s for whole-database
+ * operations, calls/s and results/s for queries, then the process' peak RSS.
+ */
+
+using namespace adsl::bench;
+
+namespace {
+
+    double now()
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    std::uint64_t peakRss()
+    {
+#if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS pmc;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return pmc.PeakWorkingSetSize;
+        return 0;
+#else
+        struct rusage ru;
+        if (getrusage(RUSAGE_SELF, &ru) != 0) return 0;
+    #if defined(__APPLE__)
+        return std::uint64_t(ru.ru_maxrss);             // bytes
+    #else
+        return std::uint64_t(ru.ru_maxrss) * 1024;      // kilobytes
+    #endif
+#endif
+    }
+
+    struct Result {
+        std::string name;
+        double      seconds  = 0;                       // best run
+        double      bytes    = 0;                       // processed per run (0 : not a text operation)
+        double      entities = 0;                       // per run
+        double      calls    = 0;                       // queries per run (0 : not a query)
+        double      results  = 0;                       // items returned per run
+    };
+
+    class Bench
+    {
+    public:
+        explicit Bench(int repeat) : m_repeat(repeat < 1 ? 1 : repeat) {}
+
+        // fn() runs the operation once; 'r' carries its sizes
+        template<typename Fn>
+        void run(Result r, Fn&& fn)
+        {
+            r.seconds = 1e300;
+            for (int i = 0; i < m_repeat; ++i) {
+                double t = now();
+                fn();
+                r.seconds = std::min(r.seconds, now() - t);
+            }
+            if (r.seconds <= 0) r.seconds = 1e-9;
+            std::fprintf(stderr, "%-28s %10.3f ms\n", r.name.c_str(), r.seconds * 1e3);
+            m_results.push_back(std::move(r));
+        }
+
+        const std::vector<Result>& results() const { return m_results; }
+
+    private:
+        int                 m_repeat;
+        std::vector<Result> m_results;
+    };
+
+    /* the first four corpus fields : string, int, float, bool */
+    struct Row { std::string f0; int f1 = 0; float f2 = 0; bool f3 = false; };
+    ADSL_BIND(Row, f0, f1, f2, f3)
+
+    /* keeps the optimizer from dropping a result */
+    volatile std::size_t g_sink = 0;
+
+    bool arg(const char* a, const char* name, const char*& value)
+    {
+        std::size_t n = std::strlen(name);
+        if (std::strncmp(a, name, n) != 0 || a[n] != '=') return false;
+        value = a + n + 1;
+        return true;
+    }
+
+    void writeReport(std::FILE* out, const CorpusOptions& o, const Corpus& c, const std::vector<Result>& results)
+    {
+        std::fprintf(out, "{\n  \"corpus\": {\"entities\": %zu, \"fields_per_entity\": %zu, \"list_length\": %zu, "
+                          "\"types\": %zu, \"groups\": %zu, \"group_density\": %g, \"comment_ratio\": %g, "
+                          "\"seed\": %llu, \"bytes\": %zu},\n",
+                     o.entities, o.fields, o.listLength, c.types.size(), c.groups.size(), o.groupDensity,
+                     o.commentRatio, static_cast<unsigned long long>(o.seed), c.text.size());
+        std::fprintf(out, "  \"results\": [\n");
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            const Result& r = results[i];
+            std::fprintf(out, "    {\"name\": \"%s\", \"seconds\": %.6g", r.name.c_str(), r.seconds);
+            if (r.bytes)    std::fprintf(out, ", \"mb_per_s\": %.6g", r.bytes / r.seconds / 1e6);
+            if (r.entities) std::fprintf(out, ", \"entities_per_s\": %.6g", r.entities / r.seconds);
+            if (r.calls)    std::fprintf(out, ", \"calls\": %.0f, \"calls_per_s\": %.6g, \"results\": %.0f, \"results_per_s\": %.6g",
+                                         r.calls, r.calls / r.seconds, r.results, r.results / r.seconds);
+            std::fprintf(out, "}%s\n", i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(out, "  ],\n  \"peak_rss_bytes\": %llu\n}\n", static_cast<unsigned long long>(peakRss()));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    CorpusOptions o;
+    int repeat = 5;
+    std::string corpusPath = "adsl_bench_corpus.adsl";
+    std::string outPath;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* v = nullptr;
+        if      (arg(argv[i], "--entities", v))      o.entities     = std::strtoull(v, nullptr, 10);
+        else if (arg(argv[i], "--fields", v))        o.fields       = std::strtoull(v, nullptr, 10);
+        else if (arg(argv[i], "--list", v))          o.listLength   = std::strtoull(v, nullptr, 10);
+        else if (arg(argv[i], "--types", v))         o.types        = std::strtoull(v, nullptr, 10);
+        else if (arg(argv[i], "--groups", v))        o.groups       = std::strtoull(v, nullptr, 10);
+        else if (arg(argv[i], "--group-density", v)) o.groupDensity = std::strtod(v, nullptr);
+        else if (arg(argv[i], "--comments", v))      o.commentRatio = std::strtod(v, nullptr);
+        else if (arg(argv[i], "--seed", v))          o.seed         = std::strtoull(v, nullptr, 10);
+        else if (arg(argv[i], "--repeat", v))        repeat         = std::atoi(v);
+        else if (arg(argv[i], "--corpus", v))        corpusPath     = v;
+        else if (arg(argv[i], "--out", v))           outPath        = v;
+        else {
+            std::fprintf(stderr, "usage: %s [--entities=N] [--fields=N] [--list=N] [--types=N] [--groups=N]\n"
+                                 "          [--group-density=P] [--comments=P] [--seed=N] [--repeat=N]\n"
+                                 "          [--corpus=PATH] [--out=PATH]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    const Corpus corpus = generateCorpus(o);
+    {
+        std::ofstream f(corpusPath, std::ios::binary);
+        if (!f.write(corpus.text.data(), std::streamsize(corpus.text.size()))) {
+            std::fprintf(stderr, "cannot write %s\n", corpusPath.c_str());
+            return 1;
+        }
+    }
+
+    const double bytes    = double(corpus.text.size());
+    const double entities = double(o.entities);
+    Bench bench(repeat);
+
+    /* --- parsing and writing --- */
+    bench.run({ "parseAdslFile", 0, bytes, entities }, [&]{
+        AdslDatabase db;
+        parseAdslFile(corpusPath, db);
+        g_sink = g_sink + db.entities.size();
+    });
+    bench.run({ "parseAdslString", 0, bytes, entities }, [&]{
+        AdslDatabase db;
+        parseAdslString(corpus.text, db);
+        g_sink = g_sink + db.entities.size();
+    });
+    bench.run({ "parseAdslString (handler)", 0, bytes, entities }, [&]{
+        struct Count : AdslHandler {
+            std::size_t n = 0;
+            void onEntityBegin(std::string_view, const std::vector<std::string_view>&) override { ++n; }
+        } h;
+        parseAdslString(corpus.text, h);
+        g_sink = g_sink + h.n;
+    });
+
+    bench.run({ "StreamParser (4 KB chunks)", 0, bytes, entities }, [&]{
+        AdslDatabase db;
+        adsl::StreamParser parser(db);
+        for (std::size_t pos = 0; pos < corpus.text.size(); pos += 4096)
+            parser.feed(corpus.text.data() + pos, std::min<std::size_t>(4096, corpus.text.size() - pos));
+        parser.finish();
+        g_sink = g_sink + db.entities.size();
+    });
+
+    adsl::API api;
+    api.loadString(corpus.text);
+    const AdslDatabase& db = api.db();
+
+    const double written = double(adsl::serialize(db).size());
+    bench.run({ "serialize", 0, written, entities }, [&]{
+        g_sink = g_sink + adsl::serialize(db).size();
+    });
+
+    /* --- queries : every type and every group once per run --- */
+    auto query = [&](const char* name, std::size_t calls, auto&& fn) {
+        std::size_t found = 0;
+        for (std::size_t i = 0; i < calls; ++i) found += fn(i);
+        bench.run({ name, 0, 0, 0, double(calls), double(found) }, [&]{
+            std::size_t n = 0;
+            for (std::size_t i = 0; i < calls; ++i) n += fn(i);
+            g_sink = g_sink + n;
+        });
+    };
+    const std::size_t types = corpus.types.size(), groups = corpus.groups.size();
+
+    query("findEntitiesByType",  types,  [&](std::size_t i){ return db.findEntitiesByType(corpus.types[i]).size(); });
+    query("findEntitiesByGroup", groups, [&](std::size_t i){ return db.findEntitiesByGroup(corpus.groups[i]).size(); });
+    query("findFieldsByGroup",   groups, [&](std::size_t i){ return db.findFieldsByGroup(corpus.groups[i]).size(); });
+    query("API::entitiesByType", types,  [&](std::size_t i){ return std::as_const(api).entitiesByType(corpus.types[i]).size(); });
+    query("API::entitiesByGroup", groups, [&](std::size_t i){ return std::as_const(api).entitiesByGroup(corpus.groups[i]).size(); });
+    query("API::fieldsByGroup",  groups, [&](std::size_t i){ return std::as_const(api).fieldsByGroup(corpus.groups[i]).size(); });
+
+    /* two groups at once : a & b and a & ~b, by bitmaps vs by merging position lists */
+    if (groups > 1) {
+        auto pair = [&](std::size_t i) { return std::make_pair(AdslSymbol(corpus.groups[i]), AdslSymbol(corpus.groups[(i + 1) % groups])); };
+        query("GroupExpr::count(a & b)", groups, [&](std::size_t i){
+            auto [a, b] = pair(i);
+            return (adsl::inGroup(a) & adsl::inGroup(b)).count(db);
+        });
+        query("GroupExpr::count(a & ~b)", groups, [&](std::size_t i){
+            auto [a, b] = pair(i);
+            return (adsl::inGroup(a) & ~adsl::inGroup(b)).count(db);
+        });
+        query("findEntitiesByGroup a & b", groups, [&](std::size_t i){
+            std::vector<const AdslEntity*> x = db.findEntitiesByGroup(corpus.groups[i]);
+            std::vector<const AdslEntity*> y = db.findEntitiesByGroup(corpus.groups[(i + 1) % groups]), both;
+            std::sort(x.begin(), x.end());              // by address : segments are not in address order
+            std::sort(y.begin(), y.end());
+            std::set_intersection(x.begin(), x.end(), y.begin(), y.end(), std::back_inserter(both));
+            return both.size();
+        });
+    }
+
+    /* typed access : one int field of every entity */
+    if (o.fields > 1) {
+        const AdslSymbol f1("f1");
+        bench.run({ "API::get<int>", 0, 0, entities }, [&]{
+            std::int64_t sum = 0;
+            for (const AdslEntity& e : db.entities) sum += api.getOr<int>(e, f1, 0);
+            g_sink = g_sink + std::size_t(sum);
+        });
+    }
+
+    /* typed bindings : every entity into a struct, from the database and while parsing */
+    if (o.fields > 3) {
+        bench.run({ "adsl::load<T>", 0, 0, entities }, [&]{
+            std::size_t n = 0;
+            for (const std::string& type : corpus.types) n += adsl::load<Row>(db, type).size();
+            g_sink = g_sink + n;
+        });
+        bench.run({ "adsl::loadString<T>", 0, bytes, entities / double(corpus.types.size()) }, [&]{
+            std::vector<Row> rows;
+            adsl::loadString(corpus.text, corpus.types[0], rows);
+            g_sink = g_sink + rows.size();
+        });
+    }
+
+    /* building through the API : reserve() up front, values moved in */
+    std::vector<std::string> fieldNames;
+    for (std::size_t f = 0; f < o.fields; ++f) fieldNames.push_back("f" + std::to_string(f));
+    bench.run({ "API::addEntity/addField", 0, 0, entities }, [&]{
+        adsl::API built;
+        built.reserve(std::size_t(entities));
+        for (std::size_t i = 0; i < std::size_t(entities); ++i) {
+            AdslEntity& e = built.addEntity(corpus.types[i % corpus.types.size()]);
+            for (std::size_t f = 0; f < fieldNames.size(); ++f)
+                built.addField(e, fieldNames[f], AdslValue(int(i + f)));
+        }
+        g_sink = g_sink + built.db().entities.size();
+    });
+
+    /* tombstones : every other entity removed, then compacted (includes the copy) */
+    bench.run({ "copy + removeIf (1/2) + compact", 0, 0, entities }, [&]{
+        AdslDatabase copy(db);
+        std::size_t i = 0;
+        copy.removeIf([&i](const AdslEntity&){ return i++ % 2 == 0; });
+        g_sink = g_sink + copy.compact();
+    });
+
+    std::remove(corpusPath.c_str());
+
+    std::FILE* out = outPath.empty() ? stdout : std::fopen(outPath.c_str(), "w");
+    if (!out) {
+        std::fprintf(stderr, "cannot write %s\n", outPath.c_str());
+        return 1;
+    }
+    writeReport(out, o, corpus, bench.results());
+    if (out != stdout) std::fclose(out);
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include "adsl_corpus.hpp"
+
+using namespace adsl::bench;
+
+namespace {
+
+    class Rng
+    {
+    public:
+        explicit Rng(std::uint64_t seed) : m_state(seed) {}
+
+        std::uint64_t next()
+        {
+            std::uint64_t z = (m_state += 0x9e3779b97f4a7c15ull);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
+        }
+        std::uint64_t below(std::uint64_t n) { return n ? next() % n : 0; }
+        bool chance(double p) { return double(next() >> 11) * 0x1p-53 < p; }
+
+    private:
+        std::uint64_t m_state;
+    };
+
+    void putGroup(std::string& out, Rng& rng, const Corpus& c)
+    {
+        out += " @";
+        out += c.groups[rng.below(c.groups.size())];
+    }
+
+    void putFloat(std::string& out, Rng& rng)
+    {
+        out += std::to_string(rng.below(100000));
+        out += '.';
+        out += std::to_string(rng.below(100));
+    }
+
+    void putValue(std::string& out, Rng& rng, std::size_t kind, std::size_t listLength)
+    {
+        auto list = [&](auto item) {
+            out += '[';
+            for (std::size_t i = 0; i < listLength; ++i) {
+                if (i) out += ", ";
+                item();
+            }
+            out += ']';
+        };
+        switch (kind % 8) {
+            case 0: out += "\"value "; out += std::to_string(rng.below(1000000)); out += '"'; break;
+            case 1: out += std::to_string(std::int64_t(rng.below(2000000)) - 1000000); break;
+            case 2: putFloat(out, rng); break;
+            case 3: out += rng.below(2) ? "true" : "false"; break;
+            case 4: list([&]{ out += std::to_string(rng.below(10000)); }); break;
+            case 5: list([&]{ out += "\"s"; out += std::to_string(rng.below(1000)); out += '"'; }); break;
+            case 6: list([&]{ putFloat(out, rng); }); break;
+            default: list([&]{ out += rng.below(2) ? "true" : "false"; }); break;
+        }
+    }
+}
+
+Corpus adsl::bench::generateCorpus(const CorpusOptions& o)
+{
+    Corpus c;
+    Rng rng(o.seed);
+    for (std::size_t i = 0; i < (o.types ? o.types : 1); ++i)  c.types.push_back("type" + std::to_string(i));
+    for (std::size_t i = 0; i < o.groups; ++i)                  c.groups.push_back("g" + std::to_string(i));
+
+    std::string& out = c.text;
+    out.reserve(o.entities * (o.fields * (24 + 6 * o.listLength) + 16));
+
+    out += "// generated corpus, seed " + std::to_string(o.seed) + "\n";
+    for (std::size_t i = 0; i < c.groups.size(); ++i)
+        out += "@" + c.groups[i] + (i % 2 ? "[a, b]\n" : "\n");
+    out += '\n';
+
+    const bool groups = !c.groups.empty();
+    for (std::size_t e = 0; e < o.entities; ++e)
+    {
+        if (rng.chance(o.commentRatio)) out += "// entity " + std::to_string(e) + "\n";
+        out += '#';
+        out += c.types[e % c.types.size()];
+        if (groups && rng.chance(o.groupDensity)) putGroup(out, rng, c);
+        out += '\n';
+
+        for (std::size_t k = 0; k < o.fields; ++k)
+        {
+            out += "    - f";
+            out += std::to_string(k);
+            out += '=';
+            putValue(out, rng, k, o.listLength ? o.listLength : 1);
+            if (groups && rng.chance(o.groupDensity)) putGroup(out, rng, c);
+            if (rng.chance(o.commentRatio)) out += " // note";
+            out += '\n';
+            ++c.fieldCount;
+        }
+        out += '\n';
+    }
+    return c;
+}
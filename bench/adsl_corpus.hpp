@@ -0,0 +1,47 @@
+#ifndef ADSL_CORPUS_HPP
+#define ADSL_CORPUS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace adsl {
+namespace bench {
+
+/* ******************************************************************** */
+/*  ------------------------ Synthetic corpora ------------------------ */
+/* ******************************************************************** */
+/*
+ * Same options and seed -> byte-identical text on every platform : the
+ * generator uses its own PRNG (splitmix64) rather than <random> distributions,
+ * whose output is left to the standard library.
+ *
+ * Field k of an entity is named "f<k>" and its kind cycles through
+ *     string, int, float, bool, int list, string list, float list, bool list
+ * so every value decoder is exercised in the same proportion at any scale.
+ */
+
+struct CorpusOptions {
+    std::size_t   entities     = 100000;
+    std::size_t   fields       = 8;         // per entity
+    std::size_t   listLength   = 4;         // items per list field
+    std::size_t   types        = 4;         // #type0 .. #type<n-1>
+    std::size_t   groups       = 8;         // @g0 .. @g<n-1>, all defined up front
+    double        groupDensity = 0.25;      // chance an entity / a field carries a group
+    double        commentRatio = 0.10;      // chance of a comment line before an entity, and of a trailing comment
+    std::uint64_t seed         = 42;
+};
+
+struct Corpus {
+    std::string              text;
+    std::vector<std::string> types;         // entity types used
+    std::vector<std::string> groups;        // group names defined
+    std::size_t              fieldCount = 0;
+};
+
+Corpus generateCorpus(const CorpusOptions& options);
+
+} // namespace bench
+} // namespace adsl
+#endif // ADSL_CORPUS_HPP
@@ -2,10 +2,27 @@
 #define ADSL_HPP
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 #include <memory>
-#include <variant>
+#include <memory_resource>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <cstdint>
+#include <chrono>
+#include <iosfwd>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
 
 /**
  * ADSL - Advanced Data Structuring Language
@@ -13,30 +30,308 @@
  * 
  */
 
+// --- Interned names (entity types, field names, group names) --- //
+// A 4-byte id into a process-wide, append-only symbol table : comparing two
+// symbols is an integer compare. Symbols still read as std::string (implicit
+// conversion, ==/!= against strings, operator<<) so string-based code keeps working.
+// The table is shared by every AdslDatabase, so entities can move between
+// databases (parallel chunks, merges) without remapping ids.
+//
+// Lifetime and cap : names are never removed while the process runs, even when
+// the databases that used them are gone, and the table holds at most kMaxCount
+// names (the next new name throws std::runtime_error "ADSL symbol table full").
+// A long-running process that keeps loading files with fresh names (generated
+// keys, user input) can watch count() and call reset() between workloads.
+class AdslSymbol {
+public:
+    AdslSymbol() = default;                                // "" (id 0)
+    AdslSymbol(std::string_view s);                        // interns s (thread-safe)
+    AdslSymbol(const std::string& s) : AdslSymbol(std::string_view(s)) {}
+    AdslSymbol(const char* s)        : AdslSymbol(std::string_view(s)) {}
+
+    // Look a name up without interning it (empty if it was never seen)
+    static std::optional<AdslSymbol> find(std::string_view s);
+
+    static constexpr std::size_t kMaxCount = std::size_t(1) << 24;
+    static std::size_t count();                            // interned names, "" included
+
+    // Forget every name and free the table. Only call it when no AdslSymbol made
+    // before is used again : no database, API, GroupExpr, parsed handler data or
+    // saved symbol from before may outlive the call, and no other thread may
+    // touch symbols meanwhile. Old ids would name other strings, or none.
+    static void reset();
+
+    std::uint32_t      id()    const { return m_id; }
+    const std::string& str()   const;
+    std::string_view   view()  const { return str(); }
+    const char*        c_str() const { return str().c_str(); }
+    std::size_t        size()  const { return str().size(); }
+    bool               empty() const { return m_id == 0; }
+
+    operator const std::string&() const { return str(); }
+
+    friend bool operator==(AdslSymbol a, AdslSymbol b) { return a.m_id == b.m_id; }
+    friend bool operator!=(AdslSymbol a, AdslSymbol b) { return a.m_id != b.m_id; }
+
+    friend bool operator==(AdslSymbol a, std::string_view b)   { return a.view() == b; }
+    friend bool operator==(std::string_view a, AdslSymbol b)   { return b == a; }
+    friend bool operator==(AdslSymbol a, const std::string& b) { return a.view() == b; }
+    friend bool operator==(const std::string& a, AdslSymbol b) { return b == a; }
+    friend bool operator==(AdslSymbol a, const char* b)        { return a.view() == b; }
+    friend bool operator==(const char* a, AdslSymbol b)        { return b == a; }
+    template<typename S> friend bool operator!=(AdslSymbol a, const S& b) { return !(a == b); }
+    template<typename S> friend bool operator!=(const S& a, AdslSymbol b) { return !(b == a); }
+
+private:
+    std::uint32_t m_id = 0;
+};
+
+std::ostream& operator<<(std::ostream& os, AdslSymbol s);
+
+namespace std {
+    template<> struct hash<AdslSymbol> {
+        size_t operator()(AdslSymbol s) const noexcept { return s.id(); }
+    };
+}
+
 // --- Value type management --- //
-using AdslValue = std::variant<
-    std::string,             // string
-    int,                     // integer
-    float,                   // float
-    bool,                    // boolean
-    std::vector<std::string>,// list of strings
-    std::vector<int>,        // list of ints
-    std::vector<float>,      // list of floats
-    std::vector<bool>        // list of bools
->;
+enum class AdslValueType {
+    String, Int, Float, Bool,
+    StringList, IntList, FloatList, BoolList,
+    Int64, Double, Int64List, DoubleList,
+    Unknown
+};
+
+// Read-only view of contiguous items (std::span is C++20)
+template<typename T>
+class AdslSpan {
+public:
+    AdslSpan() = default;
+    AdslSpan(const T* data, std::size_t size) : m_data(data), m_size(size) {}
+
+    const T*    data()  const { return m_data; }
+    std::size_t size()  const { return m_size; }
+    bool        empty() const { return m_size == 0; }
+    const T*    begin() const { return m_data; }
+    const T*    end()   const { return m_data + m_size; }
+    const T&    operator[](std::size_t i) const { return m_data[i]; }
+    const T&    front() const { return m_data[0]; }
+    const T&    back()  const { return m_data[m_size - 1]; }
+
+private:
+    const T*    m_data = nullptr;
+    std::size_t m_size = 0;
+};
+
+namespace adsl { namespace detail { struct ValueAccess; } }
+
+// --- Value : 16 bytes --- //
+// Numbers, bools and strings of up to 14 chars are stored inline. Longer strings
+// and lists take one block : owned by the value, or carved from the database's
+// arena when parsed into one (AdslAllocation::Arena). Copies always own theirs.
+// The parser stores numbers in the narrowest type that holds them (int before
+// int64_t, float before double); adsl::getIf / getOr widen when reading.
+class AdslValue {
+public:
+    AdslValue() noexcept : m_small(0), m_tag(std::uint8_t(AdslValueType::String)) {}   // ""
+    AdslValue(int v)          noexcept { setScalar(AdslValueType::Int, v); }
+    AdslValue(std::int64_t v) noexcept { setScalar(AdslValueType::Int64, v); }
+    AdslValue(float v)        noexcept { setScalar(AdslValueType::Float, v); }
+    AdslValue(double v)       noexcept { setScalar(AdslValueType::Double, v); }
+    AdslValue(bool v)         noexcept { setScalar(AdslValueType::Bool, v); }
+    AdslValue(std::string_view s);
+    AdslValue(const std::string& s) : AdslValue(std::string_view(s)) {}
+    AdslValue(const char* s)        : AdslValue(std::string_view(s)) {}
+
+    AdslValue(AdslSpan<std::string_view> items);
+    AdslValue(AdslSpan<int> items);
+    AdslValue(AdslSpan<float> items);
+    AdslValue(AdslSpan<bool> items);
+    AdslValue(AdslSpan<std::int64_t> items);
+    AdslValue(AdslSpan<double> items);
+    AdslValue(const std::vector<std::string>& items);
+    AdslValue(const std::vector<int>& items)          : AdslValue(AdslSpan<int>(items.data(), items.size())) {}
+    AdslValue(const std::vector<float>& items)        : AdslValue(AdslSpan<float>(items.data(), items.size())) {}
+    AdslValue(const std::vector<bool>& items);
+    AdslValue(const std::vector<std::int64_t>& items) : AdslValue(AdslSpan<std::int64_t>(items.data(), items.size())) {}
+    AdslValue(const std::vector<double>& items)       : AdslValue(AdslSpan<double>(items.data(), items.size())) {}
+
+    AdslValue(const AdslValue& other);
+    AdslValue(AdslValue&& other) noexcept : m_small(other.m_small), m_tag(other.m_tag)
+    {
+        std::memcpy(m_data, other.m_data, sizeof(m_data));
+        other.m_small = 0;
+        other.m_tag   = std::uint8_t(AdslValueType::String);
+    }
+    AdslValue& operator=(const AdslValue& other)     { if (this != &other) *this = AdslValue(other); return *this; }
+    AdslValue& operator=(AdslValue&& other) noexcept
+    {
+        if (this != &other) { release(); new (this) AdslValue(std::move(other)); }
+        return *this;
+    }
+    ~AdslValue() { release(); }
+
+    AdslValueType type() const { return AdslValueType(m_tag & kTypeMask); }
+
+    // Scalars and strings (undefined result if type() does not match). The view of
+    // a short string points into the value itself : it dies with it (or a move).
+    int              asInt()    const { return load<std::int32_t>(); }
+    float            asFloat()  const { return load<float>(); }
+    bool             asBool()   const { return load<bool>(); }
+    std::int64_t     asInt64()  const { return load<std::int64_t>(); }
+    double           asDouble() const { return load<double>(); }
+    std::string_view asString() const
+    {
+        if (m_small == kExternal) return { static_cast<const char*>(block()), blockSize() };
+        return { reinterpret_cast<const char*>(m_data), m_small };
+    }
+
+    // Lists (empty unless type() matches)
+    std::size_t                 listSize() const { return isList() ? blockSize() : 0; }
+    AdslSpan<std::string_view>  strings()  const { return list<std::string_view>(AdslValueType::StringList); }
+    AdslSpan<int>               ints()     const { return list<int>(AdslValueType::IntList); }
+    AdslSpan<float>             floats()   const { return list<float>(AdslValueType::FloatList); }
+    AdslSpan<bool>              bools()    const { return list<bool>(AdslValueType::BoolList); }
+    AdslSpan<std::int64_t>      int64s()   const { return list<std::int64_t>(AdslValueType::Int64List); }
+    AdslSpan<double>            doubles()  const { return list<double>(AdslValueType::DoubleList); }
+
+    friend bool operator==(const AdslValue& a, const AdslValue& b);
+    friend bool operator!=(const AdslValue& a, const AdslValue& b) { return !(a == b); }
+
+private:
+    friend struct adsl::detail::ValueAccess;
+
+    static constexpr std::uint8_t kTypeMask = 0x0f;
+    static constexpr std::uint8_t kBorrowed = 0x80;     // block in an arena : never freed here
+    static constexpr std::uint8_t kExternal = 0xff;     // m_small of a string kept in a block
+
+    template<typename T>
+    void setScalar(AdslValueType t, T v) noexcept
+    {
+        std::memcpy(m_data, &v, sizeof(T));
+        m_small = 0;
+        m_tag   = std::uint8_t(t);
+    }
+    template<typename T>
+    T load() const { T v; std::memcpy(&v, m_data, sizeof(T)); return v; }
+
+    bool isList() const
+    {
+        switch (type()) {
+            case AdslValueType::String: case AdslValueType::Int:   case AdslValueType::Float:
+            case AdslValueType::Bool:   case AdslValueType::Int64: case AdslValueType::Double: return false;
+            default: return true;
+        }
+    }
+    bool          hasBlock()  const { return isList() || m_small == kExternal; }
+    const void*   block()     const { return load<const void*>(); }
+    std::uint32_t blockSize() const { std::uint32_t n; std::memcpy(&n, m_data + sizeof(void*), sizeof(n)); return n; }
+
+    template<typename T>
+    AdslSpan<T> list(AdslValueType t) const
+    {
+        if (type() != t) return {};
+        return { static_cast<const T*>(block()), blockSize() };
+    }
+
+    void release() noexcept;
+
+    alignas(8) unsigned char m_data[14];  // scalar, inline string, or block pointer + item count
+    std::uint8_t             m_small;     // String : inline length, or kExternal
+    std::uint8_t             m_tag;       // AdslValueType, | kBorrowed
+};
+
+// --- Allocation --- //
+// Entities, fields and their group lists are std::pmr containers, so an
+// AdslDatabase can place all of them in one arena. The allocator-extended
+// constructors below are what lets std::pmr::vector hand its resource down
+// to the elements; plain construction still allocates from the heap.
+using AdslAllocator = std::pmr::polymorphic_allocator<std::byte>;
+
+namespace adsl { namespace detail { struct FieldAccess; } }
 
 // --- ADSL Field (key, value, groups) --- //
 struct AdslField {
-    std::string name;                          // The field name (e.g. "color", "age")
-    AdslValue value;                           // The field value (could be str, int, etc.)
-    std::vector<std::string> groups;           // Associated groups (may be empty)
+    using allocator_type = AdslAllocator;
+
+    AdslSymbol name;                           // The field name (e.g. "color", "age")
+private:
+    friend class AdslDatabase;
+    bool m_removed = false;                    // tombstone (declared here, it fits in name's padding)
+public:
+    AdslValue value;                           // The field value (could be str, int, etc.) ; see get()
+    std::pmr::vector<AdslSymbol> groups;       // Associated groups (may be empty)
+
+    AdslField() = default;
+    explicit AdslField(const allocator_type& alloc) : groups(alloc) {}
+    AdslField(AdslSymbol name, AdslValue value, const std::vector<AdslSymbol>& groups = {},
+              const allocator_type& alloc = {})
+        : name(name), value(std::move(value)), groups(groups.begin(), groups.end(), alloc) {}
+
+    AdslField(const AdslField&) = default;
+    AdslField(AdslField&&) = default;
+    AdslField(const AdslField& other, const allocator_type& alloc)
+        : name(other.name), m_removed(other.m_removed), value(other.value), groups(other.groups, alloc)
+        , m_raw(other.m_raw), m_rawSize(other.m_rawSize), m_line(other.m_line) {}
+    // Moving to another resource copies the value too : its block may live in other's arena
+    AdslField(AdslField&& other, const allocator_type& alloc)
+        : name(other.name), m_removed(other.m_removed)
+        , value(alloc == other.groups.get_allocator() ? std::move(other.value) : other.value)
+        , groups(std::move(other.groups), alloc)
+        , m_raw(other.m_raw), m_rawSize(other.m_rawSize), m_line(other.m_line) {}
+
+    AdslField& operator=(const AdslField&) = default;
+    AdslField& operator=(AdslField&&) = default;
+
+    // The value, decoded first if the field was parsed lazily (AdslValues::Lazy).
+    // Decoding caches into 'value'; a bad value throws std::runtime_error with
+    // its line. Read lazy fields through get() : 'value' is empty until then.
+    const AdslValue& get() const { if (m_raw) decode(); return value; }
+    AdslValue&       get()       { if (m_raw) decode(); return value; }
+    void             set(AdslValue v) { value = std::move(v); m_raw = nullptr; }
+
+    bool             decoded()  const { return m_raw == nullptr; }
+    std::string_view rawValue() const { return { m_raw, m_rawSize }; }  // text not decoded yet
+    std::size_t      line()     const { return m_line; }                 // 0 unless parsed lazily
+    bool             removed()  const { return m_removed; }              // see AdslDatabase::removeField
+
+private:
+    friend struct adsl::detail::FieldAccess;
+    void decode() const;
+
+    // Lazy value : text in the database's retained input, decoded by get()
+    mutable const char* m_raw = nullptr;
+    std::uint32_t       m_rawSize = 0;
+    std::uint32_t       m_line = 0;
 };
 
 // --- Entity : a set of fields with a type --- //
 struct AdslEntity {
-    std::string type;                          // e.g. "car", "person"
-    std::vector<AdslField> fields;             // Fields for this entity
-    std::vector<std::string> groups;           // groups attached to the entity itself (optional)
+    using allocator_type = AdslAllocator;
+
+    AdslSymbol type;                           // e.g. "car", "person"
+private:
+    friend class AdslDatabase;
+    bool m_removed = false;                    // tombstone (declared here, it fits in type's padding)
+public:
+    std::pmr::vector<AdslField> fields;        // Fields for this entity (removed ones too : see removed())
+    std::pmr::vector<AdslSymbol> groups;       // groups attached to the entity itself (optional)
+
+    AdslEntity() = default;
+    explicit AdslEntity(const allocator_type& alloc) : fields(alloc), groups(alloc) {}
+
+    AdslEntity(const AdslEntity&) = default;
+    AdslEntity(AdslEntity&&) = default;
+    AdslEntity(const AdslEntity& other, const allocator_type& alloc)
+        : type(other.type), m_removed(other.m_removed), fields(other.fields, alloc), groups(other.groups, alloc) {}
+    AdslEntity(AdslEntity&& other, const allocator_type& alloc)
+        : type(other.type), m_removed(other.m_removed)
+        , fields(std::move(other.fields), alloc), groups(std::move(other.groups), alloc) {}
+
+    AdslEntity& operator=(const AdslEntity&) = default;
+    AdslEntity& operator=(AdslEntity&&) = default;
+
+    bool removed() const { return m_removed; }  // see AdslDatabase::removeEntity
 };
 
 // --- Group : possible to have metadata for each group (see '@group[values]') --- //
@@ -45,15 +340,371 @@ struct AdslGroup {
     std::vector<std::string> values;
 };
 
+// --- Position of a field inside AdslDatabase::entities (a handle : see AdslDatabase::field) --- //
+struct AdslFieldRef {
+    std::size_t entity;                        // index in AdslDatabase::entities
+    std::size_t field;                         // index in AdslEntity::fields
+};
+
+// --- When the DOM parser decodes field values --- //
+enum class AdslValues {
+    Eager,      // every value while parsing (default)
+    Lazy        // on first AdslField::get() ; the database keeps the input text alive
+};
+
+// --- Where an AdslDatabase allocates its entities, fields and group lists --- //
+enum class AdslAllocation {
+    Heap,       // one allocation per container (default)
+    Arena       // bump allocation from an arena owned by the database; clear() frees it in one go
+};
+
+// --- Entity storage : a vector whose elements never move --- //
+// Segment k holds 16 << k elements. Growing allocates the next segment and
+// leaves the others alone, so references, pointers and iterators stay valid
+// across emplace_back / push_back / reserve / growing resize, and nothing is
+// ever copied to make room. Indexing stays O(1) (one bit scan), at most half
+// the capacity is unused, as with std::vector. insert, erase and a shrinking
+// resize move elements like std::vector does. pmr rules as std::pmr::vector :
+// the resource is fixed at construction (copies use the default one).
+template<typename T>
+class AdslStableVector {
+    template<bool Const> class Iter;
+
+public:
+    using value_type      = T;
+    using allocator_type  = std::pmr::polymorphic_allocator<T>;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference       = T&;
+    using const_reference = const T&;
+    using iterator        = Iter<false>;
+    using const_iterator  = Iter<true>;
+
+    static constexpr std::size_t npos = std::size_t(-1);
+
+    AdslStableVector() noexcept = default;
+    explicit AdslStableVector(const allocator_type& alloc) noexcept : m_alloc(alloc) {}
+    AdslStableVector(const AdslStableVector& other) : AdslStableVector(other, allocator_type()) {}
+    AdslStableVector(const AdslStableVector& other, const allocator_type& alloc) : m_alloc(alloc) { append(other); }
+    AdslStableVector(AdslStableVector&& other) noexcept : m_alloc(other.m_alloc) { steal(other); }
+    AdslStableVector(AdslStableVector&& other, const allocator_type& alloc) : m_alloc(alloc)
+    {
+        if (m_alloc == other.m_alloc) steal(other);
+        else append(std::move(other));
+    }
+
+    AdslStableVector& operator=(const AdslStableVector& other)
+    {
+        if (this != &other) { clear(); append(other); }
+        return *this;
+    }
+    // Equal resources : takes other's segments. Otherwise moves the elements over.
+    AdslStableVector& operator=(AdslStableVector&& other)
+    {
+        if (this == &other) return *this;
+        if (m_alloc == other.m_alloc) { release(); steal(other); }
+        else { clear(); append(std::move(other)); }
+        return *this;
+    }
+
+    ~AdslStableVector() { release(); }
+
+    allocator_type get_allocator() const noexcept { return m_alloc; }
+
+    std::size_t size()     const noexcept { return m_size; }
+    bool        empty()    const noexcept { return m_size == 0; }
+    std::size_t capacity() const noexcept { return kFirst * ((std::size_t(1) << m_segments) - 1); }
+
+    // Allocated segments, and how many elements segment k holds
+    std::size_t        segments() const noexcept { return m_segments; }
+    static std::size_t segmentCapacity(std::size_t k) noexcept { return kFirst << k; }
+
+    T&       operator[](std::size_t i)       noexcept { return *slot(i); }
+    const T& operator[](std::size_t i) const noexcept { return *slot(i); }
+    T&       front()       noexcept { return *m_segment[0]; }
+    const T& front() const noexcept { return *m_segment[0]; }
+    T&       back()        noexcept { return *slot(m_size - 1); }
+    const T& back()  const noexcept { return *slot(m_size - 1); }
+
+    // Position of the element 'p' points to; npos if it is not one of ours
+    std::size_t indexOf(const T* p) const noexcept
+    {
+        const std::less<const T*> less;
+        std::size_t first = 0;
+        for (std::size_t k = 0; k < m_segments; first += segmentCapacity(k), ++k)
+            if (!less(p, m_segment[k]) && less(p, m_segment[k] + segmentCapacity(k))) {
+                std::size_t i = first + std::size_t(p - m_segment[k]);
+                return i < m_size ? i : npos;
+            }
+        return npos;
+    }
+
+    void reserve(std::size_t n) { while (capacity() < n) grow(); }
+
+    template<typename... Args>
+    T& emplace_back(Args&&... args)
+    {
+        if (m_size == capacity()) grow();
+        T* p = slot(m_size);
+        m_alloc.construct(p, std::forward<Args>(args)...);      // uses-allocator construction
+        ++m_size;
+        return *p;
+    }
+    void push_back(const T& v) { emplace_back(v); }
+    void push_back(T&& v)      { emplace_back(std::move(v)); }
+    void pop_back() noexcept   { --m_size; slot(m_size)->~T(); }
+
+    void resize(std::size_t n)
+    {
+        reserve(n);
+        while (m_size < n) emplace_back();
+        while (m_size > n) pop_back();
+    }
+    void clear() noexcept { while (m_size) pop_back(); }      // keeps the segments
+
+    // Frees the segments past the last element
+    void shrink_to_fit() noexcept
+    {
+        while (m_segments && capacity() - segmentCapacity(m_segments - 1) >= m_size) {
+            --m_segments;
+            m_alloc.deallocate(m_segment[m_segments], segmentCapacity(m_segments));
+        }
+    }
+
+    // Appends [first, last), then rotates it into place
+    template<typename It>
+    iterator insert(const_iterator pos, It first, It last)
+    {
+        const std::size_t at = pos.index(), old = m_size;
+        for (; first != last; ++first) emplace_back(*first);
+        std::rotate(begin() + difference_type(at), begin() + difference_type(old), end());
+        return begin() + difference_type(at);
+    }
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        const std::size_t a = first.index(), b = last.index();
+        if (a == b) return begin() + difference_type(a);     // moving the tail onto itself would empty it
+        std::move(begin() + difference_type(b), end(), begin() + difference_type(a));
+        for (std::size_t n = b - a; n; --n) pop_back();
+        return begin() + difference_type(a);
+    }
+
+    // Equal resources only (as std::pmr::vector)
+    void swap(AdslStableVector& other) noexcept
+    {
+        std::swap(m_segment, other.m_segment);
+        std::swap(m_segments, other.m_segments);
+        std::swap(m_size, other.m_size);
+    }
+
+    iterator       begin()        noexcept { return iterator(this, 0); }
+    iterator       end()          noexcept { return iterator(this, m_size); }
+    const_iterator begin()  const noexcept { return const_iterator(this, 0); }
+    const_iterator end()    const noexcept { return const_iterator(this, m_size); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend()   const noexcept { return end(); }
+
+private:
+    static constexpr unsigned    kFirstBits   = 4;
+    static constexpr std::size_t kFirst       = std::size_t(1) << kFirstBits;   // segment 0
+    static constexpr std::size_t kMaxSegments = 40;                            // 16 * (2^40 - 1) elements
+
+    static unsigned highestBit(std::uint64_t bits) noexcept
+    {
+#ifdef _MSC_VER
+        unsigned long i; _BitScanReverse64(&i, bits); return unsigned(i);
+#else
+        return 63u - unsigned(__builtin_clzll(bits));
+#endif
+    }
+
+    // Segment k starts at element kFirst * (2^k - 1) : i + kFirst has its top bit at kFirstBits + k
+    T* slot(std::size_t i) const noexcept
+    {
+        const std::size_t j = i + kFirst;
+        const unsigned    k = highestBit(j) - kFirstBits;
+        return m_segment[k] + (j - (kFirst << k));
+    }
+
+    void grow()
+    {
+        if (m_segments == kMaxSegments) throw std::length_error("AdslStableVector: too many elements");
+        m_segment[m_segments] = m_alloc.allocate(segmentCapacity(m_segments));
+        ++m_segments;
+    }
+
+    void release() noexcept
+    {
+        clear();
+        for (std::size_t k = 0; k < m_segments; ++k) m_alloc.deallocate(m_segment[k], segmentCapacity(k));
+        m_segments = 0;
+    }
+
+    void steal(AdslStableVector& other) noexcept
+    {
+        for (std::size_t k = 0; k < other.m_segments; ++k) m_segment[k] = other.m_segment[k];
+        m_segments = std::exchange(other.m_segments, 0);
+        m_size     = std::exchange(other.m_size, 0);
+    }
+
+    void append(const AdslStableVector& other)
+    {
+        reserve(m_size + other.size());
+        for (const T& v : other) emplace_back(v);
+    }
+    void append(AdslStableVector&& other)
+    {
+        reserve(m_size + other.size());
+        for (T& v : other) emplace_back(std::move(v));
+    }
+
+    allocator_type m_alloc;
+    T*             m_segment[kMaxSegments] = {};
+    std::size_t    m_segments = 0;
+    std::size_t    m_size     = 0;
+
+    // Walks a segment by pointer, finds the next one with a bit scan
+    template<bool Const>
+    class Iter {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = std::conditional_t<Const, const T*, T*>;
+        using reference         = std::conditional_t<Const, const T&, T&>;
+
+        Iter() = default;
+        template<bool C = Const, typename = std::enable_if_t<C>>
+        Iter(const Iter<false>& other) noexcept
+            : m_vec(other.m_vec), m_index(other.m_index), m_ptr(other.m_ptr), m_end(other.m_end) {}
+
+        reference operator*()  const noexcept { return *m_ptr; }
+        pointer   operator->() const noexcept { return m_ptr; }
+        reference operator[](difference_type n) const noexcept { return *m_vec->slot(m_index + std::size_t(n)); }
+
+        Iter& operator++() noexcept { ++m_index; if (++m_ptr == m_end) seek(); return *this; }
+        Iter& operator--() noexcept { --m_index; seek(); return *this; }
+        Iter  operator++(int) noexcept { Iter t = *this; ++*this; return t; }
+        Iter  operator--(int) noexcept { Iter t = *this; --*this; return t; }
+        Iter& operator+=(difference_type n) noexcept { m_index += std::size_t(n); seek(); return *this; }
+        Iter& operator-=(difference_type n) noexcept { m_index -= std::size_t(n); seek(); return *this; }
+
+        friend Iter operator+(Iter it, difference_type n) noexcept { return it += n; }
+        friend Iter operator+(difference_type n, Iter it) noexcept { return it += n; }
+        friend Iter operator-(Iter it, difference_type n) noexcept { return it -= n; }
+        friend difference_type operator-(const Iter& a, const Iter& b) noexcept
+        {
+            return difference_type(a.m_index) - difference_type(b.m_index);
+        }
+
+        friend bool operator==(const Iter& a, const Iter& b) noexcept { return a.m_index == b.m_index; }
+        friend bool operator!=(const Iter& a, const Iter& b) noexcept { return a.m_index != b.m_index; }
+        friend bool operator< (const Iter& a, const Iter& b) noexcept { return a.m_index <  b.m_index; }
+        friend bool operator> (const Iter& a, const Iter& b) noexcept { return a.m_index >  b.m_index; }
+        friend bool operator<=(const Iter& a, const Iter& b) noexcept { return a.m_index <= b.m_index; }
+        friend bool operator>=(const Iter& a, const Iter& b) noexcept { return a.m_index >= b.m_index; }
+
+        std::size_t index() const noexcept { return m_index; }
+
+    private:
+        friend class AdslStableVector;
+        template<bool> friend class Iter;
+
+        Iter(const AdslStableVector* vec, std::size_t index) noexcept : m_vec(vec), m_index(index) { seek(); }
+
+        /* past the last segment (end() of a full vector) : nothing to point at */
+        void seek() noexcept
+        {
+            if (m_index >= m_vec->capacity()) { m_ptr = m_end = nullptr; return; }
+            const std::size_t j = m_index + kFirst;
+            const unsigned    k = highestBit(j) - kFirstBits;
+            m_ptr = m_vec->m_segment[k] + (j - (kFirst << k));
+            m_end = m_vec->m_segment[k] + segmentCapacity(k);
+        }
+
+        const AdslStableVector* m_vec   = nullptr;
+        std::size_t             m_index = 0;
+        T*                      m_ptr   = nullptr;
+        T*                      m_end   = nullptr;
+    };
+};
+
+namespace adsl { namespace detail { struct IdSetAccess; } }
+
+// --- Set of positions (entity ids), roaring-style --- //
+// Ids are split in chunks of 65536. A chunk holding up to 4096 ids is a sorted
+// array of 16-bit offsets (2 bytes per id); a fuller one is a 1024-word bitmap
+// (8 KB whatever its count), turned back into an array below half that count.
+// Inserting in ascending order appends. See adsl_groups.hpp for set algebra.
+class AdslIdSet {
+public:
+    static constexpr std::size_t kChunkBits  = 16;
+    static constexpr std::size_t kChunkWords = (std::size_t(1) << kChunkBits) / 64;
+    static constexpr std::size_t kArrayMax   = 4096;
+
+    bool        empty() const { return m_chunks.empty(); }
+    std::size_t count() const;
+    bool        contains(std::size_t id) const;
+    void        insert(std::size_t id);
+    void        erase(std::size_t id);
+    void        clear() { m_chunks.clear(); }
+
+    std::vector<std::size_t> ids() const;               // ascending
+    std::size_t              memoryBytes() const;       // heap held by the chunks
+
+private:
+    friend struct adsl::detail::IdSetAccess;
+
+    struct Chunk {
+        std::uint32_t              key   = 0;           // id >> kChunkBits
+        std::uint32_t              count = 0;
+        std::vector<std::uint16_t> array;               // sorted, while count <= kArrayMax
+        std::vector<std::uint64_t> bits;                // kChunkWords words, above that
+    };
+    std::vector<Chunk> m_chunks;                        // ascending keys, none empty
+
+    Chunk*       find(std::uint32_t key);
+    const Chunk* find(std::uint32_t key) const;
+};
+
+// --- When AdslDatabase drops removed entities and fields for good (see setCompaction) --- //
+struct AdslCompaction {
+    std::size_t minRemoved = 0;     // tombstones before a remove* call compacts (0 : only compact() does)
+    double      minRatio   = 0.25;  // ... and at least this many tombstones per entity
+};
+
+namespace adsl { namespace detail { class Arena; struct DatabaseAccess; } }
+
 // --- The database : all parsed content --- //
 class AdslDatabase {
+    std::unique_ptr<adsl::detail::Arena> m_arena;   // declared first : outlives 'entities'
+
 public:
-    // All parsed entities (by type)
-    std::vector<AdslEntity> entities;
+    // All parsed entities (by type). Adding entities never moves the existing ones :
+    // references and positions stay valid until clear() or replaceEntities.
+    AdslStableVector<AdslEntity> entities;
     
     // All defined groups (by name)
     std::unordered_map<std::string, AdslGroup> groups;
 
+    AdslDatabase();
+    explicit AdslDatabase(AdslAllocation allocation);
+    // Allocate from a caller-owned resource (not owned, must outlive the database)
+    explicit AdslDatabase(std::pmr::memory_resource* resource);
+
+    AdslDatabase(const AdslDatabase& other);                // the copy allocates from the heap
+    AdslDatabase(AdslDatabase&& other) noexcept;            // takes the arena along
+    AdslDatabase& operator=(const AdslDatabase& other);
+    AdslDatabase& operator=(AdslDatabase&& other) noexcept;
+    ~AdslDatabase();
+
+    std::pmr::memory_resource* resource() const { return entities.get_allocator().resource(); }
+    bool        usesArena() const { return m_arena != nullptr; }
+    std::size_t arenaBytes() const;                         // bytes reserved by the arena (0 without one)
+    // Bytes held by the database : containers by capacity, values, group
+    // definitions and indexes (with an arena, its blocks instead of what sits in them)
+    std::size_t memoryFootprint() const;
+
     // API
 
     // Find all entities of a given type (e.g. #car)
@@ -65,30 +716,206 @@ public:
     // Find all entities with a group attached to them (not just their fields)
     std::vector<const AdslEntity*> findEntitiesByGroup(const std::string& group) const;
 
-    // Clear DB
+    // Clear DB (with an arena : destroys the contents, then frees the arena at once)
     void clear();
+
+    // Indexes (type -> entities, group -> entities, group -> fields)
+    // The parser and adsl::API keep them current, so the find* queries cost O(result).
+    // After editing 'entities' by hand, call reindex() (adding or removing entities
+    // is detected and falls back to a full scan until then; editing fields is not).
+    void reindex();
+    void indexEntity(std::size_t entity);                     // entity + all of its fields
+    void indexField (std::size_t entity, std::size_t field);  // one field added later
+    bool isIndexed() const { return m_indexedEntities == entities.size(); }
+
+    // Replace entities[first, first+count) with the contents of 'with' (moved in),
+    // keeping the indexes current without a full reindex. Entities before the range
+    // are untouched; those after it shift by with.size() - count. When both sizes
+    // match, the replaced entities are assigned in place (no element moves).
+    void replaceEntities(std::size_t first, std::size_t count, AdslStableVector<AdslEntity>&& with);
+
+    // Handles : an entity position and an AdslFieldRef stay valid as long as entities
+    // and fields are only added. An AdslField& is only good until the next field is
+    // added to the same entity (its fields are a vector) : keep an AdslFieldRef instead.
+    AdslField&       field(const AdslFieldRef& ref)       { return entities[ref.entity].fields[ref.field]; }
+    const AdslField& field(const AdslFieldRef& ref) const { return entities[ref.entity].fields[ref.field]; }
+    std::size_t      indexOf(const AdslEntity& e) const   { return entities.indexOf(&e); }  // npos if not in 'entities'
+
+    // Removal : removeEntity / removeField only mark a tombstone, in O(1). Positions,
+    // references and indexes stay as they were; find*, compiled queries, serialize,
+    // saveBinary, projections and adsl::API skip what is removed (code walking
+    // 'entities' by hand checks removed() on entities and fields). They return false
+    // for something removed already. compact() drops the tombstones : later entities
+    // move down (positions, references and AdslFieldRefs change) and the indexes are
+    // rebuilt. setCompaction() makes remove* calls compact once enough piled up,
+    // so a database with steady deletes stays within minRatio of its live size.
+    bool        removeEntity(std::size_t entity);
+    bool        removeField (const AdslFieldRef& ref);
+    std::size_t removeIf(const std::function<bool(const AdslEntity&)>& pred);   // returns how many
+    std::size_t removedEntities() const { return m_removedEntities; }
+    std::size_t removedFields()   const { return m_removedFields; }
+    std::size_t compact();                                                      // returns the tombstones dropped
+    void                  setCompaction(const AdslCompaction& policy) { m_compaction = policy; }
+    const AdslCompaction& compaction() const { return m_compaction; }
+
+    // Raw index lists (positions in 'entities', ascending); nullptr while !isIndexed().
+    // They keep removed entities until compact() : check removed().
+    const std::vector<std::size_t>* indexedByType (AdslSymbol type)  const;
+    const std::vector<std::size_t>* indexedByGroup(AdslSymbol group) const;
+
+    // Group membership bitmaps over the same positions, kept with the indexes (same
+    // rules) : entities with 'group' attached, and entities holding at least one
+    // field in 'group'. adsl::GroupExpr (adsl_groups.hpp) combines them.
+    const AdslIdSet* groupSet     (AdslSymbol group) const;
+    const AdslIdSet* fieldGroupSet(AdslSymbol group) const;
+
+    // Changes whenever the content may have changed (clear, parse, reindex, index*,
+    // remove*, compact, assignment). Values are unique across databases. Derived data such as
+    // adsl::Projection compares it to know whether it is still current.
+    // After editing fields or values by hand, call touch() (or reindex()).
+    std::uint64_t version() const { return m_version; }
+    void          touch();
+
+    // Lazy databases : decode every value not read yet (call it before sharing the
+    // database between threads, since get() caches into the field it decodes)
+    void decodeAll();
+    bool isLazy() const { return m_source != nullptr; }
+
+private:
+    friend struct adsl::detail::DatabaseAccess;
+    std::unordered_map<AdslSymbol, std::vector<std::size_t>>  m_entitiesByType;
+    std::unordered_map<AdslSymbol, std::vector<std::size_t>>  m_entitiesByGroup;
+    std::unordered_map<AdslSymbol, std::vector<AdslFieldRef>> m_fieldsByGroup;
+    std::unordered_map<AdslSymbol, AdslIdSet>                 m_groupSets;       // m_entitiesByGroup as bitmaps
+    std::unordered_map<AdslSymbol, AdslIdSet>                 m_fieldGroupSets;  // entities of m_fieldsByGroup
+    std::size_t m_indexedEntities = 0;
+    std::size_t m_removedEntities = 0;
+    std::size_t m_removedFields = 0;
+    AdslCompaction m_compaction;
+    std::uint64_t m_version;
+    std::shared_ptr<const void> m_source;   // input text of lazy fields (shared by copies)
+
+    void resetEntities(std::pmr::memory_resource* resource);
+    void dropIndexes();
+    void addToIndexes(std::size_t entity);
+    void addFieldToIndexes(std::size_t entity, std::size_t field);
+    void removeFromIndexes(std::size_t entity);
+    void shiftIndexes(std::size_t from, std::ptrdiff_t delta);
+    void rebuildGroupSets();
+    void countRemoved(const AdslEntity& e, bool leaving);
+    void compactIfDue();
+};
+
+// --- Streaming (SAX-style) parsing --- //
+// Receives the document as a sequence of events instead of an AdslDatabase.
+// Nothing is retained once a callback returns (the string_views die with the
+// call), so memory stays constant whatever the input size. Events arrive in
+// file order; onEntityEnd closes an entity when the next '#' header or the end
+// of input is reached, so '@group' definitions may arrive between its fields.
+namespace adsl { namespace detail { struct HandlerAccess; } }
+
+class AdslHandler {
+public:
+    virtual ~AdslHandler() = default;
+
+    virtual void onGroup      (std::string_view /*name*/, const std::vector<std::string_view>& /*values*/) {}
+    virtual void onEntityBegin(std::string_view /*type*/, const std::vector<std::string_view>& /*groups*/) {}
+    virtual void onField      (std::string_view /*name*/, AdslValue& /*value*/,      // may be moved from
+                               const std::vector<std::string_view>& /*groups*/) {}
+    virtual void onEntityEnd  () {}
+    virtual void onInclude    (std::string_view /*path*/) {}              // not followed : load it yourself if needed
+
+    std::size_t line()    const { return m_line; }      // line of the event being delivered
+    void        stop()          { m_stopped = true; }   // no more events after this one
+    bool        stopped() const { return m_stopped; }
+
+private:
+    friend struct adsl::detail::HandlerAccess;
+    std::size_t m_line    = 0;
+    bool        m_stopped = false;
 };
 
 // --- Parsing ---
+// A line '#include "path"' merges another file in at that point (relative paths
+// start from the including file's directory, or the current one for text). Every
+// file reached is merged once; a cycle throws. Included files are loaded in
+// parallel and kept parsed for the whole process, keyed by path and checked by
+// modification time, then content, before reuse. A group defined in several
+// files keeps the including file's definition, else the first included one's.
 
 // Parse a file into AdslDatabase; returns true on success, false otherwise.
 // Throws std::runtime_error if fatal syntax error.
+// The file is memory-mapped and tokenized in place (no per-line copies).
 bool parseAdslFile(const std::string& filepath, AdslDatabase& db);
 
 // Parse a memory buffer (data), useful for testing or embedding.
 bool parseAdslString(const std::string& data, AdslDatabase& db);
 
+// Same, for a raw buffer that is not NUL-terminated (e.g. a mapping owned by the caller).
+bool parseAdslBuffer(const char* data, std::size_t size, AdslDatabase& db);
+
+// Lazy variants : values are decoded on first AdslField::get() (see AdslValues).
+// Syntax errors in a value surface then, with their line, instead of here.
+// The file stays mapped (a string or buffer is copied) for the database's lifetime.
+bool parseAdslFile  (const std::string& filepath, AdslDatabase& db, AdslValues values);
+bool parseAdslString(const std::string& data, AdslDatabase& db, AdslValues values);
+bool parseAdslBuffer(const char* data, std::size_t size, AdslDatabase& db, AdslValues values);
+
+// Parallel variants : the input is cut at '#type' entity headers, chunks are parsed
+// on 'threads' workers (0 = hardware concurrency) and merged back in file order.
+// Result and error messages (line numbers included) match the sequential parser.
+bool parseAdslFileParallel(const std::string& filepath, AdslDatabase& db, unsigned threads = 0);
+bool parseAdslBufferParallel(const char* data, std::size_t size, AdslDatabase& db, unsigned threads = 0);
+
+// Event-driven variants (see AdslHandler). Syntax errors throw like the DOM parser.
+// parseAdslFile/parseAdslStream read in fixed-size blocks rather than mapping the file.
+bool parseAdslFile  (const std::string& filepath, AdslHandler& handler);
+bool parseAdslStream(std::istream& in, AdslHandler& handler);
+bool parseAdslString(const std::string& data, AdslHandler& handler);
+bool parseAdslBuffer(const char* data, std::size_t size, AdslHandler& handler);
+
+// Forget every file kept for '#include' (their memory is released once no parse uses them).
+void clearAdslIncludeCache();
+
 // --- Helpers for value access/type management --- //
 
-enum class AdslValueType {
-    String, Int, Float, Bool,
-    StringList, IntList, FloatList, BoolList,
-    Unknown
+// --- Instrumentation --- //
+// Filled by the parse overloads taking an AdslParseStats* (nullptr : plain parse).
+// The plain overloads are not instrumented at all; these ones run some 10% slower.
+struct AdslParseStats {
+    std::size_t bytes    = 0;                  // input size
+    std::size_t lines    = 0;
+    std::size_t entities = 0;
+    std::size_t fields   = 0;
+    std::size_t groups   = 0;                  // '@group' definition lines
+    std::size_t values[std::size_t(AdslValueType::Unknown)] = {};  // fields by AdslValueType
+
+    // Phases : read (opening / mapping the file), lex (finding lines, names,
+    // groups and value tokens), decode (value tokens to AdslValue) and build
+    // (storing into the database, indexes included). total covers all of them.
+    std::chrono::nanoseconds readTime{0};
+    std::chrono::nanoseconds lexTime{0};
+    std::chrono::nanoseconds decodeTime{0};
+    std::chrono::nanoseconds buildTime{0};
+    std::chrono::nanoseconds totalTime{0};
+
+    // Blocks the database requested to store the result (values, containers,
+    // group definitions, indexes), from the heap or from its arena
+    std::size_t allocations    = 0;
+    std::size_t allocatedBytes = 0;
+    std::size_t memoryFootprint = 0;           // db.memoryFootprint() once parsed
 };
 
+bool parseAdslFile  (const std::string& filepath, AdslDatabase& db, AdslParseStats* stats);
+bool parseAdslString(const std::string& data, AdslDatabase& db, AdslParseStats* stats);
+bool parseAdslBuffer(const char* data, std::size_t size, AdslDatabase& db, AdslParseStats* stats);
+
 // Get the type of an AdslValue
 AdslValueType getAdslValueType(const AdslValue& v);
 
+// Name of a value type for messages ("int", "string list", ...)
+const char* adslValueTypeName(AdslValueType t);
+
 // Convert AdslValue to string (for debugging, display, etc.)
 std::string adslValueToString(const AdslValue& v);
 
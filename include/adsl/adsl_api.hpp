@@ -2,8 +2,13 @@
 #define ADSL_API_HPP
 
 #include "adsl.hpp"
+#include <array>
 #include <optional>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
 #include <functional>
+#include <utility>
 
 namespace adsl {
 /*
@@ -33,11 +38,79 @@ namespace adsl {
 
 
 /* ----------------------------- value helpers ----------------------------- */
-// Safe cast : returns std::optional<DesiredType> (empty if bad type)
+// The number a float was written as ("0.1" -> 0.1, not 0.100000001490116)
+double widenFloat(float f);
+
+namespace detail {
+    template<typename T> struct AlwaysFalse : std::false_type {};
+
+    template<typename T, typename S>
+    std::vector<T> toVector(AdslSpan<S> items) { return std::vector<T>(items.begin(), items.end()); }
+}
+
+// Safe cast : returns std::optional<DesiredType> (empty if bad type).
+// T is a scalar, std::string, a std::vector of those (copies), or
+// std::string_view / AdslSpan<item> (views into the value, no widening).
+// The parser stores numbers in the narrowest type that holds them, so
+// std::int64_t also reads int values and double also reads float values
+// (likewise for their vectors).
 template<typename T>
 std::optional<T> getIf(const AdslValue& v)
 {
-    if (auto p = std::get_if<T>(&v)) return *p;
+    using V = AdslValueType;
+    const V t = v.type();
+    if constexpr (std::is_same_v<T, int>) {
+        if (t == V::Int) return v.asInt();
+    }
+    else if constexpr (std::is_same_v<T, float>) {
+        if (t == V::Float) return v.asFloat();
+    }
+    else if constexpr (std::is_same_v<T, bool>) {
+        if (t == V::Bool) return v.asBool();
+    }
+    else if constexpr (std::is_same_v<T, std::int64_t>) {
+        if (t == V::Int64) return v.asInt64();
+        if (t == V::Int)   return v.asInt();
+    }
+    else if constexpr (std::is_same_v<T, double>) {
+        if (t == V::Double) return v.asDouble();
+        if (t == V::Float)  return widenFloat(v.asFloat());
+    }
+    else if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>) {
+        if (t == V::String) return T(v.asString());
+    }
+    else if constexpr (std::is_same_v<T, std::vector<std::string>>) {
+        if (t == V::StringList) return detail::toVector<std::string>(v.strings());
+    }
+    else if constexpr (std::is_same_v<T, std::vector<int>>) {
+        if (t == V::IntList) return detail::toVector<int>(v.ints());
+    }
+    else if constexpr (std::is_same_v<T, std::vector<float>>) {
+        if (t == V::FloatList) return detail::toVector<float>(v.floats());
+    }
+    else if constexpr (std::is_same_v<T, std::vector<bool>>) {
+        if (t == V::BoolList) return detail::toVector<bool>(v.bools());
+    }
+    else if constexpr (std::is_same_v<T, std::vector<std::int64_t>>) {
+        if (t == V::Int64List) return detail::toVector<std::int64_t>(v.int64s());
+        if (t == V::IntList)   return detail::toVector<std::int64_t>(v.ints());
+    }
+    else if constexpr (std::is_same_v<T, std::vector<double>>) {
+        if (t == V::DoubleList) return detail::toVector<double>(v.doubles());
+        if (t == V::FloatList) {
+            T out;
+            out.reserve(v.listSize());
+            for (float f : v.floats()) out.push_back(widenFloat(f));
+            return out;
+        }
+    }
+    else if constexpr (std::is_same_v<T, AdslSpan<std::string_view>>) { if (t == V::StringList) return v.strings(); }
+    else if constexpr (std::is_same_v<T, AdslSpan<int>>)              { if (t == V::IntList)    return v.ints(); }
+    else if constexpr (std::is_same_v<T, AdslSpan<float>>)            { if (t == V::FloatList)  return v.floats(); }
+    else if constexpr (std::is_same_v<T, AdslSpan<bool>>)             { if (t == V::BoolList)   return v.bools(); }
+    else if constexpr (std::is_same_v<T, AdslSpan<std::int64_t>>)     { if (t == V::Int64List)  return v.int64s(); }
+    else if constexpr (std::is_same_v<T, AdslSpan<double>>)           { if (t == V::DoubleList) return v.doubles(); }
+    else static_assert(detail::AlwaysFalse<T>::value, "getIf : no ADSL value type matches T");
     return std::nullopt;
 }
 
@@ -45,17 +118,280 @@ std::optional<T> getIf(const AdslValue& v)
 template<typename T>
 T getOr(const AdslValue& v, const T& def)
 {
-    if (auto p = std::get_if<T>(&v)) return *p;
+    if (auto r = getIf<T>(v)) return *std::move(r);
     return def;
 }
 
+/* ------------------------------ shape cache ------------------------------ */
+// Entities of one #type nearly always list the same fields in the same order.
+// ShapeCache remembers, per type, the slot where each field name was first seen;
+// find() checks that slot and only scans the entity when it deviates. Entries
+// are hints verified on every lookup, so a stale cache is never wrong, just slower.
+class ShapeCache
+{
+public:
+    void clear() { m_types.clear(); m_typeCount = 0; }
+    void learn(const AdslEntity& e);                            // all fields of e
+    void learn(AdslSymbol type, AdslSymbol name, std::size_t slot);
+
+    const AdslField* find(const AdslEntity& e, AdslSymbol name) const
+    {
+        std::size_t slot = slotOf(e.type, name);
+        if (slot < e.fields.size() && e.fields[slot].name == name && !e.fields[slot].removed()) return &e.fields[slot];
+        for (auto& f : e.fields)
+            if (f.name == name && !f.removed()) return &f;
+        return nullptr;
+    }
+
+private:
+    struct Entry { std::uint32_t name = 0; std::uint32_t slot = 0; };   // name 0 = empty
+    struct Shape {                                                      // open addressing, power-of-2 size
+        std::uint32_t      type = 0;                                    // type id + 1 (0 = empty slot of m_types)
+        std::vector<Entry> table;
+        std::size_t        count = 0;
+    };
+
+    const Shape* shapeOf(AdslSymbol type) const
+    {
+        if (m_types.empty()) return nullptr;
+        std::size_t mask = m_types.size() - 1;
+        for (std::size_t i = type.id() & mask; m_types[i].type != 0; i = (i + 1) & mask)
+            if (m_types[i].type == type.id() + 1) return &m_types[i];
+        return nullptr;
+    }
+    Shape& shapeFor(AdslSymbol type);
+
+    std::size_t slotOf(AdslSymbol type, AdslSymbol name) const
+    {
+        const Shape* shape = shapeOf(type);
+        if (!shape) return std::size_t(-1);
+        const std::vector<Entry>& t = shape->table;
+        std::size_t mask = t.size() - 1;
+        for (std::size_t i = name.id() & mask; t[i].name != 0; i = (i + 1) & mask)
+            if (t[i].name == name.id()) return t[i].slot;
+        return std::size_t(-1);
+    }
+
+    /* keyed by type id, sized by the types of this database (not by every symbol
+     * the process has interned) */
+    std::vector<Shape> m_types;
+    std::size_t        m_typeCount = 0;
+};
+
+/* ---------------------------- typed bindings ----------------------------- */
+// Map an entity type onto a struct once, at namespace scope next to the struct :
+//
+//   struct Person { std::string name; int age = 0; bool isActive = false; std::vector<std::string> skills; };
+//   ADSL_BIND(Person, name, age, isActive, skills)
+//
+//   std::vector<Person> people = api.load<Person>("person");          // from a database
+//   adsl::loadFile("people.adsl", "person", people);                  // or while parsing
+//
+// The name -> member table is built at compile time. A field binds to the member
+// of the same name; a missing field leaves the member as constructed, an unknown
+// one is skipped. Members hold what getIf reads into an owned value (numbers,
+// bool, std::string, std::vector of those), or a std::optional of one. A field
+// of another type throws std::runtime_error, prefixed "Line N: " when the line
+// is known : always while parsing, only for lazy databases after a load.
+// loadFile / loadString bind from the event parser (see AdslHandler) : no
+// AdslField is built, and '#include' lines are not followed. Up to 32 members.
+
+namespace bind {
+    template<typename C, typename M>
+    struct Member { std::string_view name; M C::* ptr; };
+
+    template<typename C, typename M>
+    constexpr Member<C, M> member(std::string_view name, M C::* ptr) { return { name, ptr }; }
+
+    template<typename... Ms>
+    constexpr std::tuple<Ms...> members(Ms... ms) { return { ms... }; }
+
+    // The table ADSL_BIND defined for T (found by argument-dependent lookup)
+    template<typename T>
+    constexpr auto membersOf() { return adslBindingOf(static_cast<const T*>(nullptr)); }
+
+    template<typename M> struct IsOptional : std::false_type {};
+    template<typename M> struct IsOptional<std::optional<M>> : std::true_type {};
+
+    template<typename M> struct IsView : std::is_same<M, std::string_view> {};
+    template<typename I> struct IsView<AdslSpan<I>> : std::true_type {};
+
+    // false if 'v' does not read as M
+    template<typename M>
+    bool assign(M& out, const AdslValue& v)
+    {
+        static_assert(!IsView<M>::value, "ADSL_BIND : members must own their data (std::string, std::vector)");
+        if constexpr (IsOptional<M>::value) {
+            typename M::value_type x{};
+            if (!assign(x, v)) return false;
+            out = std::move(x);
+            return true;
+        }
+        else if constexpr (std::is_same_v<M, std::string>) {
+            if (v.type() != AdslValueType::String) return false;
+            out.assign(v.asString());                           // reuses out's buffer
+            return true;
+        }
+        else {
+            auto r = getIf<M>(v);
+            if (r) out = std::move(*r);
+            return r.has_value();
+        }
+    }
+
+    // "Line 12: #person.age : string does not fit the bound member" (no prefix for line 0)
+    [[noreturn]] void mismatch(std::size_t line, std::string_view type, std::string_view field, AdslValueType got);
+
+    // State of one extraction : member names (as symbols for database fields), and
+    // where each member was last found (entities of one type share a layout).
+    template<typename T>
+    class Binder
+    {
+    public:
+        static constexpr auto        kMembers = membersOf<T>();
+        static constexpr std::size_t kCount   = std::tuple_size_v<decltype(kMembers)>;
+
+        Binder()
+        {
+            for (std::size_t i = 0; i < kCount; ++i) m_symbols[i] = AdslSymbol(kNames[i]);
+        }
+
+        // Every bound field of a database entity into 'out'
+        void read(const AdslEntity& e, T& out) { readAll(e, out, std::make_index_sequence<kCount>()); }
+
+        // One parsed field, 'slot' being its position in the entity
+        void set(T& out, std::string_view name, std::size_t slot, const AdslValue& v,
+                 std::size_t line, std::string_view type)
+        {
+            std::size_t i = indexOf(name, slot);
+            if (i == kCount) return;
+            if (!setAt(i, out, v, std::make_index_sequence<kCount>()))
+                mismatch(line, type, name, v.type());
+        }
+
+    private:
+        template<std::size_t... I>
+        static constexpr std::array<std::string_view, kCount> namesOf(std::index_sequence<I...>)
+        {
+            return { { std::get<I>(kMembers).name... } };
+        }
+        static constexpr std::array<std::string_view, kCount> kNames = namesOf(std::make_index_sequence<kCount>());
+
+        const AdslField* find(const AdslEntity& e, std::size_t i)
+        {
+            std::size_t slot = m_slots[i];
+            if (slot < e.fields.size() && e.fields[slot].name == m_symbols[i] && !e.fields[slot].removed()) return &e.fields[slot];
+            for (std::size_t k = 0; k < e.fields.size(); ++k)
+                if (e.fields[k].name == m_symbols[i] && !e.fields[k].removed()) { m_slots[i] = k; return &e.fields[k]; }
+            return nullptr;
+        }
+
+        template<std::size_t I>
+        void readOne(const AdslEntity& e, T& out)
+        {
+            const AdslField* f = find(e, I);
+            if (!f) return;
+            const AdslValue& v = f->get();
+            if (!assign(out.*(std::get<I>(kMembers).ptr), v))
+                mismatch(f->line(), e.type.view(), kNames[I], v.type());
+        }
+
+        template<std::size_t... I>
+        void readAll(const AdslEntity& e, T& out, std::index_sequence<I...>) { (readOne<I>(e, out), ...); }
+
+        template<std::size_t... I>
+        static bool setAt(std::size_t i, T& out, const AdslValue& v, std::index_sequence<I...>)
+        {
+            bool ok = false;
+            ((i == I ? (ok = assign(out.*(std::get<I>(kMembers).ptr), v)) : false), ...);
+            return ok;
+        }
+
+        // member bound to 'name' (kCount : none), checking the one last seen at 'slot' first
+        std::size_t indexOf(std::string_view name, std::size_t slot)
+        {
+            if (slot < m_bySlot.size() && m_bySlot[slot] < kCount && kNames[m_bySlot[slot]] == name)
+                return m_bySlot[slot];
+            std::size_t i = 0;
+            while (i < kCount && kNames[i] != name) ++i;
+            if (slot >= m_bySlot.size()) m_bySlot.resize(slot + 1, kCount);
+            m_bySlot[slot] = i;
+            return i;
+        }
+
+        std::array<AdslSymbol, kCount>  m_symbols;
+        std::array<std::size_t, kCount> m_slots{};
+        std::vector<std::size_t>        m_bySlot;
+    };
+
+    // Collects the entities of one type while a file is parsed
+    template<typename T>
+    class Handler : public AdslHandler
+    {
+    public:
+        Handler(std::string type, std::vector<T>& out) : m_type(std::move(type)), m_out(out) {}
+
+        void onEntityBegin(std::string_view type, const std::vector<std::string_view>&) override
+        {
+            m_active = type == m_type;
+            m_slot   = 0;
+            if (m_active) m_out.emplace_back();
+        }
+
+        void onField(std::string_view name, AdslValue& value, const std::vector<std::string_view>&) override
+        {
+            if (m_active) m_binder.set(m_out.back(), name, m_slot++, value, line(), m_type);
+        }
+
+    private:
+        std::string     m_type;
+        std::vector<T>& m_out;
+        Binder<T>       m_binder;
+        bool            m_active = false;
+        std::size_t     m_slot   = 0;
+    };
+} // namespace bind
+
+// Every entity of 'type' in 'db', bound to T (in database order)
+template<typename T>
+std::vector<T> load(const AdslDatabase& db, const std::string& type)
+{
+    std::vector<const AdslEntity*> entities = db.findEntitiesByType(type);
+    std::vector<T> out(entities.size());
+    bind::Binder<T> binder;
+    for (std::size_t i = 0; i < entities.size(); ++i) binder.read(*entities[i], out[i]);
+    return out;
+}
+
+// Same, straight from the text : entities of 'type' are appended to 'out'
+template<typename T>
+bool loadFile(const std::string& path, const std::string& type, std::vector<T>& out)
+{
+    bind::Handler<T> handler(type, out);
+    return parseAdslFile(path, handler);
+}
+
+template<typename T>
+bool loadString(const std::string& data, const std::string& type, std::vector<T>& out)
+{
+    bind::Handler<T> handler(type, out);
+    return parseAdslString(data, handler);
+}
+
 /* ----------------------------- AdslAPI class ----------------------------- */
+// Not synchronized : loadFile/loadString rebuild the database in place. To serve
+// concurrent readers across reloads, use adsl::LiveDatabase (adsl_live.hpp).
+// After a lazy load (AdslValues::Lazy) even reads write : the first get of a
+// field decodes it in place.
 
 class API
 {
 public:
-    bool loadFile (const std::string& path);                // reader
-    bool loadString(const std::string& data);               // reader
+    API() = default;
+    explicit API(AdslAllocation allocation) : m_db(allocation) {}   // Arena : see AdslDatabase
+
+    bool loadFile (const std::string& path, AdslValues values = AdslValues::Eager);     // reader
+    bool loadString(const std::string& data, AdslValues values = AdslValues::Eager);    // reader
     bool saveFile (const std::string& path) const;          // writer
     std::string toString() const;                           // writer
 
@@ -79,6 +415,81 @@ public:
                           const AdslValue&   value,
                           const std::vector<std::string>& groups = {});
 
+    // Bulk building : entities already added never move (AdslStableVector), and
+    // reserve() allocates room for 'entities' in total up front. The overloads
+    // below move the value, or a whole entity / field with its groups, in.
+    // The returned AdslField& lasts until the next field of 'ent' : keep an
+    // AdslFieldRef (db().field(ref)) for longer.
+    void        reserve  (std::size_t entities);
+    AdslEntity& addEntity(AdslEntity&& entity);
+    AdslField&  addField (AdslEntity& ent,
+                          const std::string& name,
+                          AdslValue&&        value,
+                          const std::vector<std::string>& groups = {});
+    AdslField&  addField (AdslEntity& ent, AdslField&& field);
+
+    // Removal : O(1) tombstones (see AdslDatabase::removeEntity). False if 'ent'
+    // does not live in db() or is removed already. compact() drops them for good.
+    bool        removeEntity(const AdslEntity& ent);
+    bool        removeField (const AdslEntity& ent, const AdslField& field);
+    std::size_t removeIf    (const std::function<bool(const AdslEntity&)>& pred);
+    std::size_t compact     () { return m_db.compact(); }
+
+    // Typed field access through the shape cache : empty if 'ent' has no such
+    // field or it holds another type. In hot loops build the names once
+    // (AdslSymbol age("age");) so nothing is hashed per call. Names given as text
+    // are looked up (AdslSymbol::find), never interned : a name nothing was ever
+    // called finds no field and leaves the symbol table as it was.
+    template<typename Name>
+    using IfText = std::enable_if_t<std::is_convertible_v<const Name&, std::string_view>
+                                    && !std::is_same_v<Name, AdslSymbol>, int>;
+
+    template<typename T>
+    std::optional<T> get(const AdslEntity& ent, AdslSymbol name) const
+    {
+        const AdslField* f = field(ent, name);
+        return f ? getIf<T>(f->get()) : std::nullopt;
+    }
+    template<typename T, typename Name, IfText<Name> = 0>
+    std::optional<T> get(const AdslEntity& ent, const Name& name) const
+    {
+        const AdslField* f = field(ent, name);
+        return f ? getIf<T>(f->get()) : std::nullopt;
+    }
+
+    template<typename T>
+    T getOr(const AdslEntity& ent, AdslSymbol name, const T& def) const
+    {
+        const AdslField* f = field(ent, name);
+        return f ? adsl::getOr<T>(f->get(), def) : def;
+    }
+    template<typename T, typename Name, IfText<Name> = 0>
+    T getOr(const AdslEntity& ent, const Name& name, const T& def) const
+    {
+        const AdslField* f = field(ent, name);
+        return f ? adsl::getOr<T>(f->get(), def) : def;
+    }
+
+    // Every entity of 'type' bound to T (see ADSL_BIND)
+    template<typename T>
+    std::vector<T> load(const std::string& type) const { return adsl::load<T>(m_db, type); }
+
+    const AdslField* field(const AdslEntity& ent, AdslSymbol name) const { return m_shapes.find(ent, name); }
+    AdslField*       field(AdslEntity& ent, AdslSymbol name)             { return const_cast<AdslField*>(m_shapes.find(ent, name)); }
+
+    template<typename Name, IfText<Name> = 0>
+    const AdslField* field(const AdslEntity& ent, const Name& name) const
+    {
+        std::optional<AdslSymbol> s = AdslSymbol::find(name);
+        return s ? field(ent, *s) : nullptr;
+    }
+    template<typename Name, IfText<Name> = 0>
+    AdslField* field(AdslEntity& ent, const Name& name)
+    {
+        std::optional<AdslSymbol> s = AdslSymbol::find(name);
+        return s ? field(ent, *s) : nullptr;
+    }
+
     // Iterate with custom lambda
     void forEachEntity(const std::function<void(AdslEntity&)>& fn);
 
@@ -87,13 +498,63 @@ public:
     const AdslDatabase& db() const { return m_db; }
 
     // Reset everything
-    void clear() { m_db.clear(); }
+    void clear() { m_db.clear(); m_shapes.clear(); }
 
 private:
+    void learnShapes();
+    AdslField& fieldAdded(AdslEntity& ent);
+
     AdslDatabase m_db;
+    ShapeCache   m_shapes;      // kept current by load*/add*; edits through db() may leave it stale
 };
 
 std::string serialize(const AdslDatabase& db);   // same impl used by API::toString()
 
 } // namespace adsl
+
+// ADSL_BIND(Type, member, ...) : see "typed bindings" above. Use it in Type's namespace.
+#define ADSL_BIND(Type, ...) \
+    inline constexpr auto adslBindingOf(const Type*) { return ::adsl::bind::members(ADSL_BIND_EACH(Type, __VA_ARGS__)); }
+
+#define ADSL_BIND_X(x) x                                 /* MSVC's traditional preprocessor */
+#define ADSL_BIND_M(T, m) ::adsl::bind::member(#m, &T::m)
+#define ADSL_BIND_1(T, m) ADSL_BIND_M(T, m)
+#define ADSL_BIND_2(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_1(T, __VA_ARGS__))
+#define ADSL_BIND_3(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_2(T, __VA_ARGS__))
+#define ADSL_BIND_4(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_3(T, __VA_ARGS__))
+#define ADSL_BIND_5(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_4(T, __VA_ARGS__))
+#define ADSL_BIND_6(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_5(T, __VA_ARGS__))
+#define ADSL_BIND_7(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_6(T, __VA_ARGS__))
+#define ADSL_BIND_8(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_7(T, __VA_ARGS__))
+#define ADSL_BIND_9(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_8(T, __VA_ARGS__))
+#define ADSL_BIND_10(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_9(T, __VA_ARGS__))
+#define ADSL_BIND_11(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_10(T, __VA_ARGS__))
+#define ADSL_BIND_12(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_11(T, __VA_ARGS__))
+#define ADSL_BIND_13(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_12(T, __VA_ARGS__))
+#define ADSL_BIND_14(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_13(T, __VA_ARGS__))
+#define ADSL_BIND_15(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_14(T, __VA_ARGS__))
+#define ADSL_BIND_16(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_15(T, __VA_ARGS__))
+#define ADSL_BIND_17(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_16(T, __VA_ARGS__))
+#define ADSL_BIND_18(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_17(T, __VA_ARGS__))
+#define ADSL_BIND_19(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_18(T, __VA_ARGS__))
+#define ADSL_BIND_20(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_19(T, __VA_ARGS__))
+#define ADSL_BIND_21(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_20(T, __VA_ARGS__))
+#define ADSL_BIND_22(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_21(T, __VA_ARGS__))
+#define ADSL_BIND_23(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_22(T, __VA_ARGS__))
+#define ADSL_BIND_24(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_23(T, __VA_ARGS__))
+#define ADSL_BIND_25(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_24(T, __VA_ARGS__))
+#define ADSL_BIND_26(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_25(T, __VA_ARGS__))
+#define ADSL_BIND_27(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_26(T, __VA_ARGS__))
+#define ADSL_BIND_28(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_27(T, __VA_ARGS__))
+#define ADSL_BIND_29(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_28(T, __VA_ARGS__))
+#define ADSL_BIND_30(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_29(T, __VA_ARGS__))
+#define ADSL_BIND_31(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_30(T, __VA_ARGS__))
+#define ADSL_BIND_32(T, m, ...) ADSL_BIND_M(T, m), ADSL_BIND_X(ADSL_BIND_31(T, __VA_ARGS__))
+#define ADSL_BIND_PICK(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, N, ...) N
+#define ADSL_BIND_EACH(T, ...) ADSL_BIND_X(ADSL_BIND_PICK(__VA_ARGS__, \
+    ADSL_BIND_32, ADSL_BIND_31, ADSL_BIND_30, ADSL_BIND_29, ADSL_BIND_28, ADSL_BIND_27, \
+    ADSL_BIND_26, ADSL_BIND_25, ADSL_BIND_24, ADSL_BIND_23, ADSL_BIND_22, ADSL_BIND_21, \
+    ADSL_BIND_20, ADSL_BIND_19, ADSL_BIND_18, ADSL_BIND_17, ADSL_BIND_16, ADSL_BIND_15, \
+    ADSL_BIND_14, ADSL_BIND_13, ADSL_BIND_12, ADSL_BIND_11, ADSL_BIND_10, ADSL_BIND_9, ADSL_BIND_8, \
+    ADSL_BIND_7, ADSL_BIND_6, ADSL_BIND_5, ADSL_BIND_4, ADSL_BIND_3, ADSL_BIND_2, ADSL_BIND_1, 0)(T, __VA_ARGS__))
 #endif // ADSL_API_HPP
\ No newline at end of file
@@ -0,0 +1,141 @@
+#ifndef ADSL_BINARY_HPP
+#define ADSL_BINARY_HPP
+
+#include "adsl.hpp"
+#include <memory>
+
+namespace adsl {
+
+/* ******************************************************************** */
+/*  ------------------ Compiled binary format (.adslb) ---------------- */
+/* ******************************************************************** */
+/*
+ * Layout (little-endian, every section 8-byte aligned) :
+ *   header      magic, version, byte order, file size, checksum, section table
+ *   strings     sorted string table (offsets + bytes); every name/string value is an id
+ *   groups      group definitions + their metadata values
+ *   entities    fixed 20-byte records  (type, fields range, groups range)
+ *   fields      fixed 24-byte records  (name, groups range, value type, payload)
+ *   lists       typed list payloads (int32 / float / uint8 bool / string ids)
+ *   indexes     type -> entities, group -> entities, group -> fields
+ *
+ * BinaryDatabase maps the file and answers queries from those tables directly;
+ * nothing is copied into AdslEntity/AdslField unless toDatabase() is called.
+ */
+
+constexpr std::uint32_t kBinaryVersion = 2;       // 2 : int64 / double values; version 1 files still load
+
+// Write 'db' in binary form. Returns false if the file cannot be written,
+// throws std::runtime_error if the database exceeds the format limits.
+bool saveBinary(const AdslDatabase& db, const std::string& path);
+std::string serializeBinary(const AdslDatabase& db);
+
+class BinaryDatabase;
+
+// --- Field stored in a binary file (cheap handle, valid while the file is open) --- //
+class BinaryField
+{
+public:
+    std::string_view name() const;
+    AdslValueType    type() const;
+    std::size_t      groupCount() const;
+    std::string_view group(std::size_t i) const;
+    bool             hasGroup(std::string_view g) const;
+
+    // Scalars (undefined result if type() does not match)
+    int              asInt()    const;
+    float            asFloat()  const;
+    bool             asBool()   const;
+    std::int64_t     asInt64()  const;
+    double           asDouble() const;
+    std::string_view asString() const;
+
+    // Lists
+    std::size_t      listSize() const;
+    std::string_view stringAt(std::size_t i) const;
+    const std::int32_t* intData()   const;
+    const float*        floatData() const;
+    const std::uint8_t* boolData()  const;          // one byte per value (0/1)
+    const std::int64_t* int64Data() const;
+    const double*       doubleData() const;
+
+    // Decode into a regular value
+    AdslValue value() const;
+
+    std::size_t index() const { return m_index; }   // position in the field table
+
+private:
+    friend class BinaryDatabase;
+    friend class BinaryEntity;
+    BinaryField(const BinaryDatabase* db, std::size_t index) : m_db(db), m_index(index) {}
+    const BinaryDatabase* m_db;
+    std::size_t           m_index;
+};
+
+// --- Entity stored in a binary file --- //
+class BinaryEntity
+{
+public:
+    std::string_view type() const;
+    std::size_t      fieldCount() const;
+    BinaryField      field(std::size_t i) const;
+    std::optional<BinaryField> field(std::string_view name) const;
+    std::size_t      groupCount() const;
+    std::string_view group(std::size_t i) const;
+    bool             hasGroup(std::string_view g) const;
+
+    std::size_t index() const { return m_index; }   // position in file order
+
+private:
+    friend class BinaryDatabase;
+    BinaryEntity(const BinaryDatabase* db, std::size_t index) : m_db(db), m_index(index) {}
+    const BinaryDatabase* m_db;
+    std::size_t           m_index;
+};
+
+// --- Read-only, memory-mapped view of a .adslb file --- //
+class BinaryDatabase
+{
+public:
+    BinaryDatabase();
+    ~BinaryDatabase();
+    BinaryDatabase(BinaryDatabase&&) noexcept;
+    BinaryDatabase& operator=(BinaryDatabase&&) noexcept;
+
+    // Map and validate 'path'. Returns false if the file cannot be opened,
+    // throws std::runtime_error on a bad magic/version/checksum or a corrupt table.
+    // verifyChecksum = false skips hashing the payload (structure is still checked).
+    bool open(const std::string& path, bool verifyChecksum = true);
+    void close();
+    bool isOpen() const;
+
+    std::size_t  entityCount() const;
+    BinaryEntity entity(std::size_t i) const { return BinaryEntity(this, i); }
+    std::size_t  fieldCount() const;
+    BinaryField  field(std::size_t i) const { return BinaryField(this, i); }
+
+    // Group definitions (@group[values])
+    std::size_t      groupCount() const;
+    std::string_view groupName(std::size_t i) const;
+    std::vector<std::string_view> groupValues(std::size_t i) const;
+
+    // Same queries as AdslDatabase, answered from the file's indexes
+    std::vector<BinaryEntity> findEntitiesByType (std::string_view type)  const;
+    std::vector<BinaryEntity> findEntitiesByGroup(std::string_view group) const;
+    std::vector<BinaryField>  findFieldsByGroup  (std::string_view group) const;
+
+    // Rebuild a regular database (exact round trip of what saveBinary wrote)
+    void toDatabase(AdslDatabase& db) const;
+
+    struct Impl;
+private:
+    friend class BinaryEntity;
+    friend class BinaryField;
+    std::unique_ptr<Impl> m_impl;
+};
+
+// Convenience : open + toDatabase
+bool loadBinary(const std::string& path, AdslDatabase& db);
+
+} // namespace adsl
+#endif // ADSL_BINARY_HPP
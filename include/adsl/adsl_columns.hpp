@@ -0,0 +1,152 @@
+#ifndef ADSL_COLUMNS_HPP
+#define ADSL_COLUMNS_HPP
+
+#include "adsl.hpp"
+
+namespace adsl {
+
+/* ******************************************************************** */
+/*  ---------------------- Columnar projections ----------------------- */
+/* ******************************************************************** */
+/*
+ * A Projection copies the scalar fields of every entity of one #type into
+ * contiguous columns (one row per entity, in database order) :
+ *   Int    int32 values        Float  float values        Bool  uint8 0/1
+ *   Int64  int64 values        Double double values
+ *   String offsets into one character blob
+ * Every column has a validity bitmap (bit set = the entity had the field with
+ * that type). A column's type is the type of the first scalar value found,
+ * widened to Int64 / Double if a later row needs it; rows holding another
+ * type, a list, or no such field are null (value 0).
+ *
+ * Data and bitmaps are padded to whole 64-row blocks, so the kernels below
+ * run fixed-size inner loops the compiler vectorizes.
+ *
+ * The projection is a snapshot : it stays valid() until the database's
+ * version() changes (parse, clear, API edits, reindex, touch).
+ */
+
+enum class CmpOp { Eq, Ne, Lt, Le, Gt, Ge };
+
+// --- Set of rows (bit per row), result of Column::filter --- //
+class RowMask
+{
+public:
+    RowMask() = default;
+    RowMask(std::size_t rows, bool value);
+
+    std::size_t rows()  const { return m_rows; }
+    std::size_t count() const;                          // rows set
+    bool        test(std::size_t row) const { return (m_bits[row >> 6] >> (row & 63)) & 1; }
+    void        set (std::size_t row, bool value);
+
+    RowMask& operator&=(const RowMask& other);
+    RowMask& operator|=(const RowMask& other);
+    RowMask  operator~() const;
+    friend RowMask operator&(RowMask a, const RowMask& b) { return a &= b; }
+    friend RowMask operator|(RowMask a, const RowMask& b) { return a |= b; }
+
+    const std::uint64_t* words() const { return m_bits.data(); }   // rows / 64 rounded up
+
+private:
+    friend class Column;
+    std::vector<std::uint64_t> m_bits;
+    std::size_t                m_rows = 0;
+};
+
+// --- Result of Column::aggregate --- //
+struct Aggregate {
+    std::size_t count = 0;          // non-null rows taken into account
+    double      sum   = 0;
+    double      min   = 0;          // 0 when count == 0
+    double      max   = 0;
+};
+
+// --- One field of the projected type --- //
+class Column
+{
+public:
+    AdslSymbol    name() const { return m_name; }
+    AdslValueType type() const { return m_type; }       // Int, Int64, Float, Double, Bool or String
+    std::size_t   size() const { return m_rows; }
+    std::size_t   nullCount() const { return m_rows - m_valid.count(); }
+
+    bool isNull(std::size_t row) const { return !m_valid.test(row); }
+    const RowMask& validity() const { return m_valid; }
+
+    // Raw columns (nullptr unless type() matches; null rows hold 0)
+    const std::int32_t* ints()   const { return m_type == AdslValueType::Int   ? m_ints.data()   : nullptr; }
+    const float*        floats() const { return m_type == AdslValueType::Float ? m_floats.data() : nullptr; }
+    const std::uint8_t* bools()  const { return m_type == AdslValueType::Bool  ? m_bools.data()  : nullptr; }
+    const std::int64_t* int64s()  const { return m_type == AdslValueType::Int64  ? m_int64s.data()  : nullptr; }
+    const double*       doubles() const { return m_type == AdslValueType::Double ? m_doubles.data() : nullptr; }
+
+    // Strings : row i is blob()[offsets()[i] .. offsets()[i+1])
+    std::string_view   stringAt(std::size_t row) const;
+    const std::size_t* offsets() const { return m_offsets.data(); }
+    std::string_view   blob()    const { return m_blob; }
+
+    double valueAt(std::size_t row) const;              // numeric columns (bool = 0/1)
+
+    // --- Kernels (numeric and bool columns; null rows never match nor count) --- //
+    // 'where' restricts the rows considered (must come from the same projection).
+    Aggregate   aggregate(const RowMask* where = nullptr) const;
+    double      sum(const RowMask* where = nullptr) const { return aggregate(where).sum; }
+    std::optional<double> min(const RowMask* where = nullptr) const;
+    std::optional<double> max(const RowMask* where = nullptr) const;
+
+    RowMask     filter    (CmpOp op, double value) const;
+    std::size_t countWhere(CmpOp op, double value) const;
+
+    // String columns : rows equal (Eq) or not equal (Ne) to 'value'
+    RowMask     filter    (CmpOp op, std::string_view value) const;
+    std::size_t countWhere(CmpOp op, std::string_view value) const { return filter(op, value).count(); }
+
+private:
+    friend class Projection;
+
+    AdslSymbol    m_name;
+    AdslValueType m_type = AdslValueType::Unknown;
+    std::size_t   m_rows = 0;
+    RowMask       m_valid;
+
+    std::vector<std::int32_t> m_ints;
+    std::vector<float>        m_floats;
+    std::vector<std::uint8_t> m_bools;
+    std::vector<std::int64_t> m_int64s;
+    std::vector<double>       m_doubles;
+    std::vector<std::size_t>  m_offsets;
+    std::string               m_blob;
+};
+
+// --- Columns of one entity type --- //
+class Projection
+{
+public:
+    // 'fields' empty = every field name found on entities of 'type'
+    static Projection build(const AdslDatabase& db, std::string_view type,
+                            const std::vector<std::string>& fields = {});
+
+    AdslSymbol  type() const { return m_type; }
+    std::size_t rows() const { return m_rows.size(); }
+
+    std::size_t   columnCount() const { return m_columns.size(); }
+    const Column& column(std::size_t i) const { return m_columns[i]; }
+    const Column* column(std::string_view name) const;   // nullptr if not projected
+
+    // Row -> position in AdslDatabase::entities
+    std::size_t entityIndex(std::size_t row) const { return m_rows[row]; }
+
+    // True while the database has not changed since build()
+    bool valid() const { return m_db && m_db->version() == m_version; }
+
+private:
+    const AdslDatabase*      m_db = nullptr;
+    std::uint64_t            m_version = 0;
+    AdslSymbol               m_type;
+    std::vector<std::size_t> m_rows;
+    std::vector<Column>      m_columns;
+};
+
+} // namespace adsl
+#endif // ADSL_COLUMNS_HPP
@@ -0,0 +1,75 @@
+#ifndef ADSL_GROUPS_HPP
+#define ADSL_GROUPS_HPP
+
+#include "adsl.hpp"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace adsl {
+
+namespace detail { struct GroupNode; }
+
+/* ******************************************************************** */
+/*  ------------------------ Group set algebra ------------------------ */
+/* ******************************************************************** */
+/*
+ *   using adsl::inGroup;
+ *   auto sel = inGroup("vehicles") & inGroup("year2021") & ~inGroup("archived");
+ *   std::size_t n = sel.count(db);                 // no pointer vector built
+ *   sel.forEach(db, [](const AdslEntity& e){ ... });
+ *   std::vector<const AdslEntity*> v = sel.entities(db);
+ *
+ * Leaves read the database's group bitmaps (AdslDatabase::groupSet and
+ * fieldGroupSet). An expression is evaluated one chunk of 65536 entities at
+ * a time. Each node of the chunk is one of the following:
+ *   - a 1024-word bitmap, borrowed from the set when it is stored that way;
+ *   - known empty;
+ *   - known full.
+ * AND / OR / AND-NOT run as word loops, and counts are popcounts (AVX2 when
+ * the CPU has it). An AND with an empty side, or a group absent from a
+ * chunk, costs nothing. Memory stays at one chunk per level of the
+ * expression, whatever the database size.
+ *
+ * NOT is taken against every entity of the database. Removed entities never
+ * match. Without indexes (!db.isIndexed()), or while removed fields are
+ * pending and a fieldGroup leaf is involved, each entity is tested instead.
+ * An expression holds names only : it works with any database.
+ */
+
+class GroupExpr
+{
+public:
+    GroupExpr operator~() const;
+    friend GroupExpr operator&(const GroupExpr& a, const GroupExpr& b);
+    friend GroupExpr operator|(const GroupExpr& a, const GroupExpr& b);
+    friend GroupExpr operator-(const GroupExpr& a, const GroupExpr& b);     // a & ~b
+
+    std::size_t                    count  (const AdslDatabase& db) const;
+    std::vector<std::size_t>       indices(const AdslDatabase& db) const;   // positions, ascending
+    std::vector<const AdslEntity*> entities(const AdslDatabase& db) const;
+    std::vector<AdslEntity*>       entities(AdslDatabase& db) const;
+    AdslIdSet                      toSet  (const AdslDatabase& db) const;   // keep a result, as a bitmap
+    void forEach(const AdslDatabase& db, const std::function<void(const AdslEntity&)>& fn) const;
+
+    bool matches(const AdslEntity& e) const;           // one entity, by its group lists
+
+private:
+    friend GroupExpr inGroup(AdslSymbol group);
+    friend GroupExpr inFieldGroup(AdslSymbol group);
+    explicit GroupExpr(std::shared_ptr<const detail::GroupNode> node) : m_node(std::move(node)) {}
+
+    std::shared_ptr<const detail::GroupNode> m_node;
+};
+
+GroupExpr inGroup(AdslSymbol group);        // '@group' attached to the entity
+GroupExpr inFieldGroup(AdslSymbol group);   // at least one of its fields in '@group'
+
+GroupExpr operator&(const GroupExpr& a, const GroupExpr& b);
+GroupExpr operator|(const GroupExpr& a, const GroupExpr& b);
+GroupExpr operator-(const GroupExpr& a, const GroupExpr& b);
+
+} // namespace adsl
+
+#endif // ADSL_GROUPS_HPP
@@ -0,0 +1,91 @@
+#ifndef ADSL_INCREMENTAL_HPP
+#define ADSL_INCREMENTAL_HPP
+
+#include "adsl.hpp"
+
+namespace adsl {
+
+/* ******************************************************************** */
+/*  ----------------------- Incremental reparse ----------------------- */
+/* ******************************************************************** */
+/*
+ *   AdslDatabase db;
+ *   adsl::Document doc(db);
+ *   doc.loadFile("world.adsl");              // full parse, once
+ *   ...
+ *   doc.edit(offset, 3, "42");               // byte-range edit
+ *   doc.update(newText);                     // or the whole new text (diffed)
+ *
+ * The document keeps the text it parsed and where every entity block starts.
+ * A block is an '#entity' header line plus every line up to the next header
+ * (fields, comments, '@group' definitions); lines before the first header form
+ * a preamble block. An edit re-parses only the blocks it touches and splices
+ * the result into the database with AdslDatabase::replaceEntities :
+ *   - entities before the edited blocks are not touched;
+ *   - entities after them are not re-parsed either, but shift by
+ *     Update::inserted - Update::removed positions;
+ *   - when the count does not change (the usual value edit), the re-parsed
+ *     entities are assigned in place, so every AdslEntity* stays valid.
+ * db.groups is rebuilt from the recorded definitions only when an edited block
+ * held or now holds '@group' lines.
+ *
+ * Errors carry the line number in the whole document. A failed edit throws
+ * std::runtime_error and leaves the text and the database as they were.
+ * The database must not be edited by other means meanwhile (load again if it
+ * was); edits check that the entity count still matches. '#include' lines
+ * are rejected.
+ */
+
+class Document
+{
+public:
+    // What an edit changed
+    struct Update {
+        std::size_t firstEntity   = 0;      // first position in db.entities re-parsed
+        std::size_t removed       = 0;      // entities replaced ...
+        std::size_t inserted      = 0;      // ... by this many
+        bool        groupsChanged = false;  // db.groups was rebuilt
+        std::size_t reparsedBytes = 0;      // size of the re-parsed blocks
+    };
+
+    explicit Document(AdslDatabase& db) : m_db(db) {}
+
+    // Full parse (clears the database first). Same results as parseAdslFile / parseAdslString.
+    bool loadFile  (const std::string& filepath);
+    bool loadString(std::string text);
+
+    // Replace text[offset, offset+length) with 'replacement'
+    Update edit(std::size_t offset, std::size_t length, std::string_view replacement);
+
+    // Replace the whole text : only the span between the common prefix and suffix is re-parsed
+    Update update(std::string_view newText);
+
+    const std::string& text() const { return m_text; }
+    AdslDatabase&      db()   const { return m_db; }
+
+    // Bytes [first, second) of the text that produced db.entities[entity]
+    std::pair<std::size_t, std::size_t> entitySpan(std::size_t entity) const;
+
+private:
+    struct Block {
+        std::size_t            offset = 0;  // in m_text
+        std::size_t            line   = 0;  // lines before it
+        std::vector<AdslGroup> groups;      // '@group' definitions inside it, in order
+    };
+
+    // Parse 'text' (starting on a block boundary, preceded by 'linesBefore' lines) into
+    // entities and blocks; block offsets are relative to 'text'
+    static void parseBlocks(std::string_view text, std::size_t linesBefore, bool preamble,
+                            AdslStableVector<AdslEntity>& entities, std::vector<Block>& blocks);
+
+    std::size_t blockAt(std::size_t offset) const;      // last block starting at or before offset
+    std::size_t blockEnd(std::size_t block) const;
+    void        rebuildGroups();
+
+    AdslDatabase&      m_db;
+    std::string        m_text;
+    std::vector<Block> m_blocks { Block() };            // [0] = preamble, [i] = db.entities[i - 1]
+};
+
+} // namespace adsl
+#endif // ADSL_INCREMENTAL_HPP
@@ -0,0 +1,104 @@
+#ifndef ADSL_LIVE_HPP
+#define ADSL_LIVE_HPP
+
+#include "adsl.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace adsl {
+
+/* ******************************************************************** */
+/*  ---------------------- Hot reload / snapshots --------------------- */
+/* ******************************************************************** */
+/*
+ *   adsl::LiveDatabase live("world.adsl");
+ *   live.reload();                            // first load
+ *   live.watch();                             // reload in the background on every save
+ *
+ *   // any reader thread :
+ *   adsl::Snapshot db = live.snapshot();      // immutable, never half-built
+ *   for (const AdslEntity* e : db->findEntitiesByType("car")) ...
+ *
+ * Each load parses into a fresh AdslDatabase and publishes it with one atomic
+ * pointer swap. Readers never block : snapshot() is a few atomic increments,
+ * whatever a reload is doing. A Snapshot keeps its database alive, so pointers
+ * taken from it stay valid until the Snapshot (and every copy) is released;
+ * the last release frees it. A failed load publishes nothing : readers keep
+ * the previous version and lastError() says why.
+ *
+ * watch() uses inotify on Linux (on the file's directory, so editors that
+ * save by renaming are seen) and checks the modification time periodically
+ * elsewhere.
+ */
+
+using Snapshot = std::shared_ptr<const AdslDatabase>;
+
+class LiveDatabase
+{
+public:
+    struct Options {
+        AdslAllocation            allocation = AdslAllocation::Heap;
+        unsigned                  threads    = 1;     // > 1 : parseAdslFileParallel (0 = every core)
+        std::chrono::milliseconds settle{ 50 };       // quiet time after a change before reloading
+    };
+
+    explicit LiveDatabase(std::string path) : LiveDatabase(std::move(path), Options()) {}
+    LiveDatabase(std::string path, Options options);
+    ~LiveDatabase();                                    // stops the watcher; live snapshots stay valid
+
+    LiveDatabase(const LiveDatabase&) = delete;
+    LiveDatabase& operator=(const LiveDatabase&) = delete;
+
+    // --- Readers (any thread, wait-free) --- //
+    Snapshot      snapshot() const;                     // empty database until the first load
+    std::uint64_t generation() const { return m_generation.load(std::memory_order_acquire); }  // loads published
+
+    // --- Writers --- //
+    bool reload();                                      // parse now; false (and lastError()) on failure
+    bool watch();                                       // start the background watcher (false if it cannot)
+    void stop();
+
+    const std::string& path() const { return m_path; }
+    std::string        lastError() const;
+
+    // Called on the reloading thread after each publication
+    void onReload(std::function<void(const Snapshot&)> callback);
+
+private:
+    struct Version {
+        Snapshot db;
+    };
+
+    void publish(Snapshot db);
+    void waitForReaders();
+    void watchLoop();
+
+    const std::string m_path;
+    const Options     m_options;
+
+    /* Readers announce themselves on m_readers[epoch] while they copy the
+     * current Snapshot; a writer retires a Version only after flipping the
+     * epoch twice and seeing both counters drain (see publish()). */
+    std::atomic<Version*>         m_current;
+    std::atomic<unsigned>         m_epoch{ 0 };
+    mutable std::atomic<std::size_t> m_readers[2] = {};
+    std::atomic<std::uint64_t>    m_generation{ 0 };
+
+    mutable std::mutex                      m_writeMutex;   // writers only : reload(), errors, callback
+    std::string                             m_error;
+    std::function<void(const Snapshot&)>    m_callback;
+
+    std::thread             m_watcher;
+    std::atomic<bool>       m_stop{ false };
+    std::mutex              m_stopMutex;
+    std::condition_variable m_stopCv;                   // wakes the polling watcher on stop()
+    int                     m_wakeFd = -1;              // same for the inotify one (eventfd)
+};
+
+} // namespace adsl
+#endif // ADSL_LIVE_HPP
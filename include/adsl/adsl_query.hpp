@@ -0,0 +1,121 @@
+#ifndef ADSL_QUERY_HPP
+#define ADSL_QUERY_HPP
+
+#include "adsl_columns.hpp"     // CmpOp
+
+namespace adsl {
+
+/* ******************************************************************** */
+/*  --------------------------- Query engine -------------------------- */
+/* ******************************************************************** */
+/*
+ *   QueryPlan plan = Query().type("person").inGroup("employee")
+ *                           .where("age", CmpOp::Gt, 25)
+ *                           .where("isActive", CmpOp::Eq, true)
+ *                           .contains("skills", "C++")
+ *                           .compile();
+ *   for (const AdslEntity* e : plan.entities(db)) ...
+ *
+ * Every condition must hold (AND). A field predicate is false when the entity
+ * has no such field or the field holds a value of another kind. Numbers compare
+ * across int/float (float fields in float precision), strings lexicographically,
+ * bools as 0/1.
+ *
+ * compile() resolves names once and orders predicates cheapest first. A plan
+ * holds no reference to a database : it can run on any number of them, from
+ * several threads. Running it starts from the smallest index list among the
+ * type/group conditions (a full scan when the database is not indexed) and
+ * filters candidates in batches, one predicate at a time over the batch.
+ */
+
+class QueryPlan;
+
+class Query
+{
+public:
+    Query& type   (std::string_view type);
+    Query& inGroup(std::string_view group);            // entity-level @group
+
+    Query& has  (std::string_view field);
+    Query& where(std::string_view field, CmpOp op, int value) { return where(field, op, std::int64_t(value)); }
+    Query& where(std::string_view field, CmpOp op, std::int64_t value);
+    Query& where(std::string_view field, CmpOp op, double value);
+    Query& where(std::string_view field, CmpOp op, bool value);
+    Query& where(std::string_view field, CmpOp op, std::string_view value);
+    Query& where(std::string_view field, CmpOp op, const char* value) { return where(field, op, std::string_view(value)); }
+
+    // List fields holding 'value'
+    Query& contains(std::string_view field, int value) { return contains(field, std::int64_t(value)); }
+    Query& contains(std::string_view field, std::int64_t value);
+    Query& contains(std::string_view field, double value);
+    Query& contains(std::string_view field, bool value);
+    Query& contains(std::string_view field, std::string_view value);
+    Query& contains(std::string_view field, const char* value) { return contains(field, std::string_view(value)); }
+
+    QueryPlan compile() const;
+
+private:
+    friend class QueryPlan;
+
+    enum class Kind { Has, Bool, Number, String, ContainsBool, ContainsNumber, ContainsString };
+
+    struct Predicate {
+        AdslSymbol  field;
+        Kind        kind = Kind::Has;
+        CmpOp       op   = CmpOp::Eq;
+        double      number = 0;
+        std::int64_t integer = 0;                       // exact value when 'integral'
+        bool        integral = false;
+        bool        flag   = false;
+        std::string text;
+    };
+
+    Query& add(std::string_view field, Kind kind, CmpOp op);
+
+    std::optional<AdslSymbol> m_type;
+    std::vector<AdslSymbol>   m_groups;
+    std::vector<Predicate>    m_predicates;
+};
+
+class QueryPlan
+{
+public:
+    static constexpr std::size_t kBatch = 256;
+
+    // Matching entities, in database order
+    std::vector<std::size_t>        indices (const AdslDatabase& db) const;
+    std::vector<const AdslEntity*>  entities(const AdslDatabase& db) const;
+    std::vector<AdslEntity*>        entities(AdslDatabase& db) const;
+    std::size_t                     count   (const AdslDatabase& db) const;
+
+    // Calls fn(entity) for every match (no std::function : fn is inlined per batch)
+    template<typename Fn>
+    void forEach(const AdslDatabase& db, Fn&& fn) const
+    {
+        Cursor cursor;
+        std::size_t batch[kBatch];
+        for (std::size_t n; (n = next(db, cursor, batch)) != 0; )
+            for (std::size_t i = 0; i < n; ++i) fn(db.entities[batch[i]]);
+    }
+
+    // --- Batch interface --- //
+    struct Cursor {
+        std::size_t                     position = 0;  // in the driving list / entities
+        const std::vector<std::size_t>* driver   = nullptr;
+        bool                            started  = false;
+        std::vector<std::size_t>        hints;         // last slot of each predicate's field
+    };
+    // Writes up to kBatch matching entity positions to 'out', 0 when done.
+    // The database must not change while a cursor is in use.
+    std::size_t next(const AdslDatabase& db, Cursor& cursor, std::size_t* out) const;
+
+private:
+    friend class Query;
+
+    std::optional<AdslSymbol>     m_type;
+    std::vector<AdslSymbol>       m_groups;
+    std::vector<Query::Predicate> m_predicates;        // cheapest first
+};
+
+} // namespace adsl
+#endif // ADSL_QUERY_HPP
@@ -0,0 +1,70 @@
+#ifndef ADSL_STREAM_HPP
+#define ADSL_STREAM_HPP
+
+#include "adsl.hpp"
+
+#include <functional>
+#include <memory>
+
+namespace adsl {
+
+namespace detail { struct StreamTarget; }
+
+/* ******************************************************************** */
+/*  ------------------------- Push parsing ---------------------------- */
+/* ******************************************************************** */
+/*
+ *   AdslDatabase db;
+ *   adsl::StreamParser parser(db);
+ *   while (recv(sock, buf, n))                // pipes, message queues, ...
+ *       parser.feed(buf, n);                  // any size, cut anywhere
+ *   parser.finish();
+ *
+ * Chunks are parsed as they arrive : every complete line is handled by the
+ * time feed() returns, and only the unfinished last line is copied and kept
+ * (values never span lines, so a string or list cut by a chunk boundary simply
+ * waits there). Memory stays bounded by the longest line, whatever the total.
+ *
+ * An entity is complete when the next '#' header arrives, or at finish().
+ *   - With a handler, events arrive as for parseAdslStream (onEntityEnd marks
+ *     completion). stop() makes later feeds no-ops.
+ *   - With a database (cleared first), each complete entity is appended to
+ *     db.entities and indexed at once, so find* queries see it, and 'onEntity'
+ *     (if set) is called with its position. '#include' files are loaded at
+ *     finish() (relative to the current directory) and merged in then.
+ *
+ * Syntax errors throw std::runtime_error with the line, from the feed() that
+ * completes the line (or finish()); the parser cannot be fed after that.
+ * Not thread-safe : feed from one thread at a time.
+ */
+
+class StreamParser
+{
+public:
+    explicit StreamParser(AdslHandler& handler);
+    explicit StreamParser(AdslDatabase& db, std::function<void(std::size_t entity)> onEntity = {});
+    ~StreamParser();
+
+    StreamParser(const StreamParser&) = delete;
+    StreamParser& operator=(const StreamParser&) = delete;
+
+    void feed(const char* data, std::size_t size);
+    void feed(std::string_view data) { feed(data.data(), data.size()); }
+
+    // End of input : parses the last line, closes the last entity. Returns true.
+    bool finish();
+
+    std::size_t lines()    const;                   // lines parsed so far
+    std::size_t buffered() const { return m_tail.size(); }   // bytes of the unfinished line
+
+private:
+    void parse(std::string_view lines);
+
+    std::unique_ptr<detail::StreamTarget> m_target; // the line parser and its sink
+    std::string                           m_tail;   // unfinished last line
+    bool                                  m_done = false;   // finished, or failed
+};
+
+} // namespace adsl
+
+#endif // ADSL_STREAM_HPP
@@ -0,0 +1,118 @@
+#ifndef ADSL_WRITER_HPP
+#define ADSL_WRITER_HPP
+
+#include "adsl.hpp"
+#include <cstdio>
+#include <iosfwd>
+
+namespace adsl {
+
+/* ******************************************************************** */
+/*  ------------------------- Streaming writer ------------------------- */
+/* ******************************************************************** */
+/*
+ * Writer formats text ADSL into a fixed buffer and hands full blocks to a
+ * Sink, so saving a database never holds more than one block of output.
+ * Numbers go through std::to_chars; floats are written in the shortest form
+ * that reads back to the same value and always carry a '.', so they reparse
+ * as floats (1.0f -> "1.0", not "1").
+ */
+
+// --- Output target. write() returns false on I/O failure --- //
+class Sink
+{
+public:
+    virtual ~Sink() = default;
+    virtual bool write(const char* data, std::size_t size) = 0;
+};
+
+// Appends to a caller-owned string
+class StringSink : public Sink
+{
+public:
+    explicit StringSink(std::string& out) : m_out(out) {}
+    bool write(const char* data, std::size_t size) override;
+private:
+    std::string& m_out;
+};
+
+class OStreamSink : public Sink
+{
+public:
+    explicit OStreamSink(std::ostream& out) : m_out(out) {}
+    bool write(const char* data, std::size_t size) override;
+private:
+    std::ostream& m_out;
+};
+
+// Does not take ownership of the FILE*
+class FileSink : public Sink
+{
+public:
+    explicit FileSink(std::FILE* file) : m_file(file) {}
+    bool write(const char* data, std::size_t size) override;
+private:
+    std::FILE* m_file;
+};
+
+// Raw file descriptor (POSIX write / Windows _write); not closed by the sink
+class FdSink : public Sink
+{
+public:
+    explicit FdSink(int fd) : m_fd(fd) {}
+    bool write(const char* data, std::size_t size) override;
+private:
+    int m_fd;
+};
+
+// --- Buffered ADSL text writer --- //
+class Writer
+{
+public:
+    static constexpr std::size_t kDefaultBufferSize = 64 * 1024;
+
+    explicit Writer(Sink& sink, std::size_t bufferSize = kDefaultBufferSize);
+    ~Writer();                                      // flushes, errors are ignored
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    void write(const AdslDatabase& db);             // groups, blank line, entities
+    void writeGroup (const AdslGroup& g);           // "@name[v1,v2]\n"
+    void writeEntity(const AdslEntity& e);          // header, fields, blank line
+    void writeField (const AdslField& f);           // "    - name=value @g1 @g2\n"
+    void writeValue (const AdslValue& v);           // value only
+
+    // Pushes buffered output to the sink. False once any sink write failed.
+    bool flush();
+    bool good() const { return m_good; }
+
+    std::size_t bytesWritten() const { return m_written + m_used; }
+
+private:
+    void put(char c)           { if (m_used == m_buffer.size()) drain(); m_buffer[m_used++] = c; }
+    void put(std::string_view s);
+    char* reserve(std::size_t n);                   // room for n contiguous chars
+    void drain();
+
+    void putInt   (std::int64_t i);
+    void putFloat (float f);
+    void putDouble(double d);
+    void putBool (bool b) { put(b ? std::string_view("true") : std::string_view("false")); }
+    void putQuoted(std::string_view s) { put('"'); put(s); put('"'); }
+
+    Sink&             m_sink;
+    std::vector<char> m_buffer;
+    std::size_t       m_used    = 0;
+    std::size_t       m_written = 0;
+    bool              m_good    = true;
+};
+
+// Write 'db' to 'sink'. Returns false if the sink reported a failure.
+bool serialize(const AdslDatabase& db, Sink& sink);
+
+// Stream 'db' to a file without building the text in memory
+bool saveFile(const AdslDatabase& db, const std::string& path);
+
+} // namespace adsl
+#endif // ADSL_WRITER_HPP
@@ -1,374 +1,1242 @@
 #include "../include/adsl/adsl.hpp"
+#include "adsl_arena.hpp"
+#include "adsl_include.hpp"
+#include "adsl_mmap.hpp"
+#include "adsl_parser.hpp"
+#include "adsl_stats.hpp"
+#include "adsl_value.hpp"
 
 #include <fstream>
-#include <sstream>
+#include <istream>
 #include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <charconv>
+#include <cmath>
+#include <exception>
+#include <iterator>
+#include <limits>
+#include <new>
 #include <stdexcept>
-#include <iomanip>
+#include <string_view>
+#include <thread>
+#include <utility>
 
 using namespace std;
 
 /* UTILITIES */
 
+using namespace adsl::detail;
+
 namespace {
 
-    /* trim helpers */
-    inline void ltrim(string &s) { s.erase(s.begin(), std::find_if(s.begin(), s.end(),
-                                       [](unsigned char c){ return !std::isspace(c); })); }
-    inline void rtrim(string &s) { s.erase(std::find_if(s.rbegin(), s.rend(),
-                                       [](unsigned char c){ return !std::isspace(c); }).base(), s.end()); }
-    inline string trimmed(string s){ ltrim(s); rtrim(s); return s; }
+    /* All lexing works on string_views into the source buffer (string or mapped
+     * file); std::string is only built for names/values stored in the database. */
 
-    inline bool startsWith(const string& s, const string& prefix)
-    {
-        return s.size() >= prefix.size() &&
-               equal(prefix.begin(), prefix.end(), s.begin());
-    }
+    inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
 
-    /* Remove a // comment outside of quotes */
-    string stripComment(string line)
-    {
-        bool inString = false;
-        for (size_t i = 0; i + 1 < line.size(); ++i)
-        {
-            if (line[i] == '"' && (i == 0 || line[i-1] != '\\'))
-                inString = !inString;
+    /* from_chars does not accept a leading '+', the grammar does */
+    inline string_view dropPlus(string_view s) { return (!s.empty() && s[0]=='+') ? s.substr(1) : s; }
 
-            if (!inString && line[i] == '/' && line[i+1] == '/')
-            {
-                return line.substr(0, i);
+    /* Numbers are stored in the narrowest type that holds what was written :
+     *   [+-]digits                                 int, else int64_t
+     *   [+-]digits[.digits][(e|E)[+-]digits]       float, else double
+     *   (with a '.' or an exponent)
+     * An integer needs nothing but from_chars, which checks and converts it at
+     * once. Anything else gets one pass that checks the real shape and counts
+     * significant digits, then a single from_chars (a second one only for reals
+     * with more digits than a float always keeps). */
+    struct NumberShape {
+        bool     valid    = false;
+        bool     integral = false;
+        unsigned digits   = 0;          // significant mantissa digits (leading zeros excluded)
+    };
+
+    NumberShape shapeOf(string_view s)
+    {
+        NumberShape n;
+        size_t i = (!s.empty() && (s[0]=='+' || s[0]=='-')) ? 1 : 0;
+        size_t mantissa = 0;
+        bool dot = false, exponent = false;
+        for (; i < s.size(); ++i) {
+            char c = s[i];
+            if (isDigit(c)) {
+                ++mantissa;
+                if (n.digits || c != '0') ++n.digits;
             }
+            else if (c == '.' && !dot) dot = true;
+            else if ((c == 'e' || c == 'E') && mantissa) { exponent = true; ++i; break; }
+            else return n;
+        }
+        if (exponent) {
+            if (i < s.size() && (s[i]=='+' || s[i]=='-')) ++i;
+            if (i == s.size()) return n;
+            for (; i < s.size(); ++i)
+                if (!isDigit(s[i])) return n;
         }
-        return line;
+        n.valid    = mantissa > 0;
+        n.integral = !dot && !exponent;
+        return n;
     }
 
-    bool isInteger(const string& s)
+    /* Integer token : false if s is not one, throws if beyond int64_t */
+    bool toInteger(string_view s, int64_t& v)
     {
-        if (s.empty()) return false;
-        size_t i = (s[0]=='+' || s[0]=='-') ? 1 : 0;
-        return i < s.size() && all_of(s.begin()+i, s.end(), ::isdigit);
+        string_view t = dropPlus(s);
+        if (t.empty() || (t.size() != s.size() && t[0] == '-')) return false;     // "+", "+-1"
+        auto r = from_chars(t.data(), t.data()+t.size(), v);
+        if (r.ptr != t.data()+t.size()) return false;
+        if (r.ec != errc()) throw runtime_error("integer out of range: "+toString(s));
+        return true;
     }
 
-    bool isFloat(const string& s)
+    inline bool fitsInt(int64_t v) { return v >= numeric_limits<int>::min() && v <= numeric_limits<int>::max(); }
+
+    /* Real shape : true (and 'f') when float keeps the written value, false
+     * (and 'd') when it takes a double. Float keeps it if it holds the value
+     * exactly, or if the float reads back as the same number, which is always
+     * so up to 6 significant digits and never beyond 9. */
+    bool readReal(string_view s, unsigned digits, float& f, double& d)
     {
-        bool dot=false; bool digit=false;
-        size_t i = (s[0]=='+'||s[0]=='-')?1:0;
-        for(; i<s.size(); ++i){
-            if (isdigit(s[i])) digit=true;
-            else if (s[i]=='.' && !dot) dot=true;
-            else return false;
-        }
-        return digit && dot;
+        s = dropPlus(s);
+        const char* b = s.data();
+        const char* e = b + s.size();
+        auto normal = [](float x){ return x == 0.f || std::fabs(x) >= numeric_limits<float>::min(); };
+
+        bool inFloat = from_chars(b, e, f).ec == errc() && normal(f);
+        if (inFloat && digits <= unsigned(numeric_limits<float>::digits10)) return true;
+
+        if (from_chars(b, e, d).ec != errc())
+            throw runtime_error("float out of range: "+toString(s));
+        if (!inFloat) return false;
+        if (double(f) == d) return true;
+        if (digits > unsigned(numeric_limits<float>::max_digits10)) return false;
+
+        char buf[32];
+        double back = 0;
+        auto r = to_chars(buf, buf + sizeof(buf), f);
+        from_chars(buf, r.ptr, back);
+        return back == d;
     }
 
-    /* Forward */
-    AdslValue parseValue(const string& raw);
+    /* Items of a list body, split on commas outside strings and trimmed */
+    struct ListItems {
+        string_view inner;
+        size_t      pos = 0;
+        bool        done = false;
+
+        bool next(string_view& item)
+        {
+            if (done) return false;
+            bool inString = false;
+            for (size_t i = pos; i <= inner.size(); ++i) {
+                char c = (i == inner.size()) ? ',' : inner[i];
+                if (c=='"' && (i==0 || inner[i-1]!='\\')) inString = !inString;
+                if (c==',' && !inString) {
+                    item = trimmed(inner.substr(pos, i-pos));
+                    pos  = i+1;
+                    done = i == inner.size();
+                    return true;
+                }
+            }
+            return false;
+        }
+        void rewind() { pos = 0; done = false; }
+
+        /* item count, exact unless strings hold commas */
+        size_t bound() const { return size_t(count(inner.begin(), inner.end(), ',')) + 1; }
+    };
 
-    /* Parse list: assume raw begins with '[' and ends with ']' (already trimmed) */
-    AdslValue parseList(const string& raw)
+    /* Numeric lists start as int (or float) and widen to int64_t (or double)
+     * when an item needs it. Items go straight into the value's block; ints
+     * convert exactly, floats were rounded from text, so a double list is
+     * decoded again from the items. */
+    AdslValue parseIntList(ListItems& items, Arena* arena)
     {
-        string inner = trimmed(raw.substr(1, raw.size()-2));   // drop [ ]
-        vector<string> items;
-        string tmp;
-        bool inString=false;
-        for(size_t i=0;i<=inner.size();++i){
-            char c = (i==inner.size())? ',' : inner[i];
-            if (c=='"' && (i==0 || inner[i-1]!='\\')) inString = !inString;
-            if (c==',' && !inString){
-                items.push_back(trimmed(tmp));
-                tmp.clear();
-            }else if(i<inner.size()){
-                tmp.push_back(c);
+        const size_t bound = items.bound();
+        AdslValue v;
+        int* out = ValueAccess::makeList<int>(v, AdslValueType::IntList, bound, arena);
+        int64_t* wide = nullptr;
+        size_t n = 0;
+        string_view it;
+        int64_t x = 0;
+        while (items.next(it)) {
+            if (!toInteger(it, x)) throw runtime_error("Mixed int list");
+            if (!wide && !fitsInt(x)) {
+                AdslValue w;
+                wide = ValueAccess::makeList<int64_t>(w, AdslValueType::Int64List, bound, arena);
+                std::copy(out, out + n, wide);
+                v = std::move(w);
             }
+            if (wide) wide[n++] = x;
+            else      out[n++] = int(x);
         }
-        if(items.empty()) throw runtime_error("Empty list not supported");
+        ValueAccess::setCount(v, n);
+        return v;
+    }
+
+    AdslValue parseFloatList(ListItems& items, Arena* arena)
+    {
+        const size_t bound = items.bound();
+        AdslValue v;
+        float* out = ValueAccess::makeList<float>(v, AdslValueType::FloatList, bound, arena);
+        size_t n = 0;
+        string_view it;
+        float f = 0.f;
+        double d = 0;
+        while (items.next(it)) {
+            NumberShape s = shapeOf(it);
+            if (!s.valid || s.integral) throw runtime_error("Mixed float list");
+            if (readReal(it, s.digits, f, d)) { out[n++] = f; continue; }
+
+            double* wide = ValueAccess::makeList<double>(v, AdslValueType::DoubleList, bound, arena);
+            n = 0;
+            for (items.rewind(); items.next(it); ) {
+                NumberShape m = shapeOf(it);
+                if (!m.valid || m.integral) throw runtime_error("Mixed float list");
+                it = dropPlus(it);
+                if (from_chars(it.data(), it.data()+it.size(), d).ec != errc())
+                    throw runtime_error("float out of range: "+toString(it));
+                wide[n++] = d;
+            }
+            break;
+        }
+        ValueAccess::setCount(v, n);
+        return v;
+    }
+
+    /* Parse list: assume raw begins with '[' and ends with ']' (already trimmed).
+     * The first item decides the type; items are decoded straight into it. */
+    AdslValue parseList(string_view raw, Arena* arena)
+    {
+        ListItems items{ trimmed(raw.substr(1, raw.size()-2)) };    // drop [ ]
+        if (items.inner.empty()) throw runtime_error("Empty list not supported");
+
+        string_view first;
+        items.next(first);
+        items.rewind();
 
-        /* Decide type from first item */
-        const string& first = items.front();
         if (first.size()>0 && first.front()=='"')
         {
-            vector<string> out;
-            for(auto& it:items){
+            /* views into the text, copied into the value's block at once */
+            thread_local vector<string_view> out;
+            out.clear();
+            for (string_view it; items.next(it); ) {
                 if(it.size()<2 || it.front()!='"' || it.back()!='"')
                     throw runtime_error("Mixed or invalid string list");
                 out.push_back(it.substr(1,it.size()-2));
             }
-            return out;
+            return ValueAccess::makeStrings(AdslSpan<string_view>(out.data(), out.size()), arena);
         }
-        else if (first=="true" || first=="false")
+        if (first=="true" || first=="false")
         {
-            vector<bool> out;
-            for(auto& it:items){
-                if(it=="true") out.push_back(true);
-                else if(it=="false") out.push_back(false);
+            AdslValue v;
+            bool* out = ValueAccess::makeList<bool>(v, AdslValueType::BoolList, items.bound(), arena);
+            size_t n = 0;
+            for (string_view it; items.next(it); ) {
+                if(it=="true") out[n++] = true;
+                else if(it=="false") out[n++] = false;
                 else throw runtime_error("Mixed bool list");
             }
-            return out;
-        }
-        else if(isInteger(first))
-        {
-            vector<int> out;
-            for(auto& it:items){
-                if(!isInteger(it)) throw runtime_error("Mixed int list");
-                out.push_back(stoi(it));
-            }
-            return out;
-        }
-        else if(isFloat(first))
-        {
-            vector<float> out;
-            for(auto& it:items){
-                if(!isFloat(it)) throw runtime_error("Mixed float list");
-                out.push_back(stof(it));
-            }
-            return out;
+            ValueAccess::setCount(v, n);
+            return v;
         }
+
+        int64_t v = 0;
+        if (toInteger(first, v)) return parseIntList(items, arena);
+        if (shapeOf(first).valid) return parseFloatList(items, arena);
         throw runtime_error("Unknown list item type");
     }
 
-    AdslValue parseValue(const string& raw)
+} // namespace utils
+
+AdslValue adsl::detail::parseValue(string_view raw, Arena* arena)
+{
+    string_view s = trimmed(raw);
+    if(s.empty()) throw runtime_error("missing value");
+
+    if(s.front()=='[' && s.back()==']')            /* list */
+        return parseList(s, arena);
+
+    if(s.front()=='"' && s.back()=='"')            /* string */
+        return ValueAccess::makeString(s.substr(1,s.size()-2), arena);
+
+    if(s=="true") return true;
+    if(s=="false") return false;
+
+    int64_t i = 0;
+    if(toInteger(s, i)) {
+        if(fitsInt(i)) return int(i);
+        return i;
+    }
+    NumberShape n = shapeOf(s);
+    if(n.valid) {
+        float f = 0.f;
+        double d = 0;
+        if(readReal(s, n.digits, f, d)) return f;
+        return d;
+    }
+
+    throw runtime_error("Unrecognised value: "+toString(s));
+}
+
+/*  AdslDatabase impl   */
+
+namespace {
+    /* process-wide, so a version never repeats even across databases */
+    std::uint64_t nextVersion()
     {
-        string s = trimmed(raw);
-        if(s.empty()) throw runtime_error("missing value");
+        static std::atomic<std::uint64_t> counter{0};
+        return ++counter;
+    }
+}
+
+AdslDatabase::AdslDatabase()
+    : m_version(nextVersion())
+{
+}
+
+AdslDatabase::AdslDatabase(AdslAllocation allocation)
+    : m_arena(allocation == AdslAllocation::Arena ? std::make_unique<Arena>() : nullptr)
+    , entities(m_arena ? m_arena.get() : std::pmr::get_default_resource())
+    , m_version(nextVersion())
+{
+}
+
+AdslDatabase::AdslDatabase(std::pmr::memory_resource* resource)
+    : entities(resource)
+    , m_version(nextVersion())
+{
+}
+
+AdslDatabase::AdslDatabase(const AdslDatabase& other)
+    : entities(other.entities, std::pmr::get_default_resource())
+    , groups(other.groups)
+    , m_entitiesByType(other.m_entitiesByType)
+    , m_entitiesByGroup(other.m_entitiesByGroup)
+    , m_fieldsByGroup(other.m_fieldsByGroup)
+    , m_groupSets(other.m_groupSets)
+    , m_fieldGroupSets(other.m_fieldGroupSets)
+    , m_indexedEntities(other.m_indexedEntities)
+    , m_removedEntities(other.m_removedEntities)
+    , m_removedFields(other.m_removedFields)
+    , m_compaction(other.m_compaction)
+    , m_version(nextVersion())
+    , m_source(other.m_source)
+{
+}
+
+AdslDatabase::AdslDatabase(AdslDatabase&& other) noexcept
+    : m_arena(std::move(other.m_arena))
+    , entities(std::move(other.entities))
+    , groups(std::move(other.groups))
+    , m_entitiesByType(std::move(other.m_entitiesByType))
+    , m_entitiesByGroup(std::move(other.m_entitiesByGroup))
+    , m_fieldsByGroup(std::move(other.m_fieldsByGroup))
+    , m_groupSets(std::move(other.m_groupSets))
+    , m_fieldGroupSets(std::move(other.m_fieldGroupSets))
+    , m_indexedEntities(std::exchange(other.m_indexedEntities, 0))
+    , m_removedEntities(std::exchange(other.m_removedEntities, 0))
+    , m_removedFields(std::exchange(other.m_removedFields, 0))
+    , m_compaction(other.m_compaction)
+    , m_version(nextVersion())
+    , m_source(std::move(other.m_source))
+{
+    /* the moved-from vector still points at the arena that now belongs to us */
+    if (m_arena) other.resetEntities(std::pmr::get_default_resource());
+    other.touch();
+}
+
+AdslDatabase& AdslDatabase::operator=(const AdslDatabase& other)
+{
+    if (this != &other) {
+        clear();                                    // copies into our own resource
+        entities = other.entities;
+        groups = other.groups;
+        m_entitiesByType = other.m_entitiesByType;
+        m_entitiesByGroup = other.m_entitiesByGroup;
+        m_fieldsByGroup = other.m_fieldsByGroup;
+        m_groupSets = other.m_groupSets;
+        m_fieldGroupSets = other.m_fieldGroupSets;
+        m_indexedEntities = other.m_indexedEntities;
+        m_removedEntities = other.m_removedEntities;
+        m_removedFields = other.m_removedFields;
+        m_compaction = other.m_compaction;
+        m_source = other.m_source;
+        touch();
+    }
+    return *this;
+}
+
+AdslDatabase& AdslDatabase::operator=(AdslDatabase&& other) noexcept
+{
+    if (this != &other) {
+        /* containers never change resource : rebuild 'entities' on other's one */
+        resetEntities(other.resource());
+        m_arena = std::move(other.m_arena);
+        entities = std::move(other.entities);       // equal resources : steals the buffer
+        groups = std::move(other.groups);
+        m_entitiesByType = std::move(other.m_entitiesByType);
+        m_entitiesByGroup = std::move(other.m_entitiesByGroup);
+        m_fieldsByGroup = std::move(other.m_fieldsByGroup);
+        m_groupSets = std::move(other.m_groupSets);
+        m_fieldGroupSets = std::move(other.m_fieldGroupSets);
+        m_indexedEntities = std::exchange(other.m_indexedEntities, 0);
+        m_removedEntities = std::exchange(other.m_removedEntities, 0);
+        m_removedFields = std::exchange(other.m_removedFields, 0);
+        m_compaction = other.m_compaction;
+        m_source = std::move(other.m_source);
+        if (m_arena) other.resetEntities(std::pmr::get_default_resource());
+        touch();
+        other.touch();
+    }
+    return *this;
+}
+
+AdslDatabase::~AdslDatabase() = default;
+
+void AdslDatabase::touch()
+{
+    m_version = nextVersion();
+}
 
-        if(s.front()=='[' && s.back()==']')            /* list */
-            return parseList(s);
+void AdslDatabase::decodeAll()
+{
+    if (!m_source) return;
+    for (AdslEntity& e : entities)
+        for (AdslField& f : e.fields) f.get();
+}
 
-        if(s.front()=='"' && s.back()=='"')            /* string */
-            return s.substr(1,s.size()-2);
+/* Decodes in place : 'value' of a const field is still a mutable object
+ * (fields are never created const), only its reader is. */
+void AdslField::decode() const
+{
+    AdslValue v;
+    try {
+        v = parseValue(rawValue());
+    } catch (const std::exception& ex) {
+        throw lineError(m_line, ex.what());
+    }
+    const_cast<AdslValue&>(value) = std::move(v);
+    m_raw = nullptr;
+}
 
-        if(s=="true") return true;
-        if(s=="false") return false;
+/* Destroy 'entities' and recreate it empty on 'resource' */
+void AdslDatabase::resetEntities(std::pmr::memory_resource* resource)
+{
+    entities.~AdslStableVector();
+    new (&entities) AdslStableVector<AdslEntity>(resource);
+}
 
-        if(isInteger(s))   return stoi(s);
-        if(isFloat(s))     return stof(s);
+size_t AdslDatabase::arenaBytes() const
+{
+    return m_arena ? m_arena->bytesReserved() : 0;
+}
 
-        throw runtime_error("Unrecognised value: "+s);
+void HeapUse::addValue(const AdslValue& v)
+{
+    add(ValueAccess::blockBytes(v));
+}
+
+/* Database internals for the stats and lazy parse paths below */
+struct adsl::detail::DatabaseAccess
+{
+    static void setSource(AdslDatabase& db, std::shared_ptr<const void> source)
+    {
+        db.m_source = std::move(source);
     }
 
-    /* Split a line of @groups, collects tokens into vector */
-    void extractGroups(const string& part, vector<string>& outGroups)
+    /* Index and group map blocks (libstdc++ layout : bucket array, one node per key) */
+    template<typename Map>
+    static void addMap(const Map& m, HeapUse& heap)
     {
-        string s = part;
-        ltrim(s);
-        string token;
-        for(size_t i=0;i<=s.size();++i){
-            char c = (i==s.size())? ' ' : s[i];
-            if(isspace(c) || c==','){
-                if(!token.empty()){
-                    if(token[0]=='@') outGroups.push_back(token.substr(1));
-                    token.clear();
-                }
-            }else{
-                token.push_back(c);
-            }
-        }
+        heap.add(m.bucket_count() * sizeof(void*));
+        for (size_t i = 0; i < m.size(); ++i) heap.add(sizeof(typename Map::value_type) + sizeof(void*));
     }
 
-} // namespace utils
+    static void addIndexes(const AdslDatabase& db, HeapUse& heap)
+    {
+        addMap(db.m_entitiesByType, heap);
+        addMap(db.m_entitiesByGroup, heap);
+        addMap(db.m_fieldsByGroup, heap);
+        for (const auto& [type, list] : db.m_entitiesByType)  heap.addVector(list);
+        for (const auto& [group, list] : db.m_entitiesByGroup) heap.addVector(list);
+        for (const auto& [group, list] : db.m_fieldsByGroup)  heap.addVector(list);
+        addMap(db.m_groupSets, heap);
+        addMap(db.m_fieldGroupSets, heap);
+        for (const auto& [group, set] : db.m_groupSets)      heap.add(set.memoryBytes());
+        for (const auto& [group, set] : db.m_fieldGroupSets) heap.add(set.memoryBytes());
+    }
+};
 
-/*  AdslDatabase impl   */
+size_t AdslDatabase::memoryFootprint() const
+{
+    HeapUse heap;
+    /* pmr containers : in the arena unless too large for it */
+    auto container = [&](size_t bytes) {
+        if (!m_arena || bytes > Arena::kLargeAllocation) heap.add(bytes);
+    };
+    for (size_t k = 0; k < entities.segments(); ++k)
+        container(entities.segmentCapacity(k) * sizeof(AdslEntity));
+    for (const AdslEntity& e : entities)
+    {
+        container(e.fields.capacity() * sizeof(AdslField));
+        container(e.groups.capacity() * sizeof(AdslSymbol));
+        for (const AdslField& f : e.fields)
+        {
+            container(f.groups.capacity() * sizeof(AdslSymbol));
+            heap.add(ValueAccess::ownedBytes(f.value));     // borrowed blocks : in arenaBytes()
+        }
+    }
+    DatabaseAccess::addMap(groups, heap);
+    for (const auto& [name, g] : groups) { heap.addString(name); heap.addGroup(g); }
+    DatabaseAccess::addIndexes(*this, heap);
+    return sizeof(*this) + arenaBytes() + heap.bytes;
+}
 
 vector<const AdslEntity*> AdslDatabase::findEntitiesByType(const string& type) const
 {
     vector<const AdslEntity*> res;
-    for (auto& e : entities)
-        if (e.type == type) res.push_back(&e);
+    if (!isIndexed()) {
+        for (auto& e : entities)
+            if (e.type == type && !e.removed()) res.push_back(&e);
+        return res;
+    }
+    auto sym = AdslSymbol::find(type);
+    if (!sym) return res;
+    auto it = m_entitiesByType.find(*sym);
+    if (it == m_entitiesByType.end()) return res;
+    res.reserve(it->second.size());
+    for (size_t i : it->second)
+        if (!m_removedEntities || !entities[i].removed()) res.push_back(&entities[i]);
     return res;
 }
 
 vector<const AdslField*> AdslDatabase::findFieldsByGroup(const string& group) const
 {
     vector<const AdslField*> res;
-    for (auto& e : entities)
-        for (auto& f : e.fields)
-            if (std::find(f.groups.begin(), f.groups.end(), group) != f.groups.end())
-                res.push_back(&f);
+    if (!isIndexed()) {
+        for (auto& e : entities) {
+            if (e.removed()) continue;
+            for (auto& f : e.fields)
+                if (!f.removed() && std::find(f.groups.begin(), f.groups.end(), group) != f.groups.end())
+                    res.push_back(&f);
+        }
+        return res;
+    }
+    auto sym = AdslSymbol::find(group);
+    if (!sym) return res;
+    auto it = m_fieldsByGroup.find(*sym);
+    if (it == m_fieldsByGroup.end()) return res;
+    res.reserve(it->second.size());
+    const bool removals = m_removedEntities || m_removedFields;
+    for (const AdslFieldRef& r : it->second) {
+        const AdslEntity& e = entities[r.entity];
+        if (removals && (e.removed() || e.fields[r.field].removed())) continue;
+        res.push_back(&e.fields[r.field]);
+    }
     return res;
 }
 
 vector<const AdslEntity*> AdslDatabase::findEntitiesByGroup(const string& group) const
 {
     vector<const AdslEntity*> res;
-    for (auto& e : entities)
-        if (std::find(e.groups.begin(), e.groups.end(), group) != e.groups.end())
-            res.push_back(&e);
+    if (!isIndexed()) {
+        for (auto& e : entities)
+            if (!e.removed() && std::find(e.groups.begin(), e.groups.end(), group) != e.groups.end())
+                res.push_back(&e);
+        return res;
+    }
+    auto sym = AdslSymbol::find(group);
+    if (!sym) return res;
+    auto it = m_entitiesByGroup.find(*sym);
+    if (it == m_entitiesByGroup.end()) return res;
+    res.reserve(it->second.size());
+    for (size_t i : it->second)
+        if (!m_removedEntities || !entities[i].removed()) res.push_back(&entities[i]);
     return res;
 }
 
+namespace {
+    const vector<size_t>* indexList(const unordered_map<AdslSymbol, vector<size_t>>& index, AdslSymbol key)
+    {
+        static const vector<size_t> none;
+        auto it = index.find(key);
+        return it == index.end() ? &none : &it->second;
+    }
+}
+
+const vector<size_t>* AdslDatabase::indexedByType(AdslSymbol type) const
+{
+    return isIndexed() ? indexList(m_entitiesByType, type) : nullptr;
+}
+
+const vector<size_t>* AdslDatabase::indexedByGroup(AdslSymbol group) const
+{
+    return isIndexed() ? indexList(m_entitiesByGroup, group) : nullptr;
+}
+
+namespace {
+    const AdslIdSet* groupSetOf(const unordered_map<AdslSymbol, AdslIdSet>& sets, AdslSymbol key)
+    {
+        static const AdslIdSet none;
+        auto it = sets.find(key);
+        return it == sets.end() ? &none : &it->second;
+    }
+}
+
+const AdslIdSet* AdslDatabase::groupSet(AdslSymbol group) const
+{
+    return isIndexed() ? groupSetOf(m_groupSets, group) : nullptr;
+}
+
+const AdslIdSet* AdslDatabase::fieldGroupSet(AdslSymbol group) const
+{
+    return isIndexed() ? groupSetOf(m_fieldGroupSets, group) : nullptr;
+}
+
 void AdslDatabase::clear()
 {
-    entities.clear();
+    /* drop the segments too : they may live in the arena released below */
+    AdslStableVector<AdslEntity>(entities.get_allocator()).swap(entities);
+    if (m_arena) m_arena->release();
     groups.clear();
+    dropIndexes();
+    m_removedEntities = 0;
+    m_removedFields = 0;
+    m_source.reset();
+    touch();
+}
+
+void AdslDatabase::reindex()
+{
+    dropIndexes();
+    for (size_t i = 0; i < entities.size(); ++i)
+        addToIndexes(i);
+    touch();
+}
+
+/* Stale lists must not survive : once 'entities' shrinks back to the old indexed
+ * count, isIndexed() alone could not tell them from current ones */
+void AdslDatabase::dropIndexes()
+{
+    m_entitiesByType.clear();
+    m_entitiesByGroup.clear();
+    m_fieldsByGroup.clear();
+    m_groupSets.clear();
+    m_fieldGroupSets.clear();
+    m_indexedEntities = 0;
+}
+
+namespace {
+    inline bool before(size_t a, size_t b) { return a < b; }
+    inline bool before(const AdslFieldRef& a, const AdslFieldRef& b)
+    {
+        return a.entity != b.entity ? a.entity < b.entity : a.field < b.field;
+    }
+
+    /* Lists stay sorted (document order) and free of duplicates : a group listed
+     * twice on the same entity/field must still be reported once. */
+    template<typename T>
+    void insertSorted(vector<T>& list, const T& v)
+    {
+        if (list.empty() || before(list.back(), v)) { list.push_back(v); return; }
+        auto it = lower_bound(list.begin(), list.end(), v, [](const T& a, const T& b){ return before(a, b); });
+        if (it == list.end() || before(v, *it)) list.insert(it, v);
+    }
+}
+
+void AdslDatabase::indexEntity(size_t entity)
+{
+    addToIndexes(entity);
+    touch();
+}
+
+void AdslDatabase::indexField(size_t entity, size_t field)
+{
+    addFieldToIndexes(entity, field);
+    touch();
+}
+
+void AdslDatabase::addToIndexes(size_t entity)
+{
+    const AdslEntity& e = entities[entity];
+    insertSorted(m_entitiesByType[e.type], entity);
+    for (auto& g : e.groups) {
+        insertSorted(m_entitiesByGroup[g], entity);
+        m_groupSets[g].insert(entity);
+    }
+    for (size_t f = 0; f < e.fields.size(); ++f)
+        addFieldToIndexes(entity, f);
+    if (entity == m_indexedEntities) ++m_indexedEntities;
+}
+
+void AdslDatabase::addFieldToIndexes(size_t entity, size_t field)
+{
+    for (auto& g : entities[entity].fields[field].groups) {
+        insertSorted(m_fieldsByGroup[g], AdslFieldRef{ entity, field });
+        m_fieldGroupSets[g].insert(entity);
+    }
+}
+
+/* Index entries of one entity (its type, its groups, its fields' groups) */
+void AdslDatabase::removeFromIndexes(size_t entity)
+{
+    auto eraseFrom = [entity](unordered_map<AdslSymbol, vector<size_t>>& index, AdslSymbol key) {
+        auto it = index.find(key);
+        if (it == index.end()) return;
+        auto pos = lower_bound(it->second.begin(), it->second.end(), entity);
+        if (pos != it->second.end() && *pos == entity) it->second.erase(pos);
+        if (it->second.empty()) index.erase(it);
+    };
+    auto eraseFromSet = [entity](unordered_map<AdslSymbol, AdslIdSet>& sets, AdslSymbol key) {
+        auto it = sets.find(key);
+        if (it == sets.end()) return;
+        it->second.erase(entity);
+        if (it->second.empty()) sets.erase(it);
+    };
+
+    const AdslEntity& e = entities[entity];
+    eraseFrom(m_entitiesByType, e.type);
+    for (auto& g : e.groups) {
+        eraseFrom(m_entitiesByGroup, g);
+        eraseFromSet(m_groupSets, g);
+    }
+    for (auto& f : e.fields)
+        for (auto& g : f.groups) {
+            eraseFromSet(m_fieldGroupSets, g);
+            auto it = m_fieldsByGroup.find(g);
+            if (it == m_fieldsByGroup.end()) continue;
+            auto range = equal_range(it->second.begin(), it->second.end(), AdslFieldRef{ entity, 0 },
+                                     [](const AdslFieldRef& a, const AdslFieldRef& b){ return a.entity < b.entity; });
+            it->second.erase(range.first, range.second);
+            if (it->second.empty()) m_fieldsByGroup.erase(it);
+        }
+}
+
+/* Every indexed position >= from moves by delta (entities inserted or erased before it) */
+void AdslDatabase::shiftIndexes(size_t from, ptrdiff_t delta)
+{
+    for (auto* index : { &m_entitiesByType, &m_entitiesByGroup })
+        for (auto& [key, list] : *index)
+            for (auto it = lower_bound(list.begin(), list.end(), from); it != list.end(); ++it)
+                *it += delta;
+
+    for (auto& [key, list] : m_fieldsByGroup) {
+        auto it = lower_bound(list.begin(), list.end(), AdslFieldRef{ from, 0 },
+                              [](const AdslFieldRef& a, const AdslFieldRef& b){ return a.entity < b.entity; });
+        for (; it != list.end(); ++it) it->entity += delta;
+    }
+    rebuildGroupSets();
+}
+
+/* Bitmaps from the (current) position lists */
+void AdslDatabase::rebuildGroupSets()
+{
+    m_groupSets.clear();
+    m_fieldGroupSets.clear();
+    for (const auto& [group, list] : m_entitiesByGroup) {
+        AdslIdSet& set = m_groupSets[group];
+        for (size_t i : list) set.insert(i);
+    }
+    for (const auto& [group, list] : m_fieldsByGroup) {
+        AdslIdSet& set = m_fieldGroupSets[group];
+        for (const AdslFieldRef& r : list) set.insert(r.entity);
+    }
+}
+
+void AdslDatabase::replaceEntities(size_t first, size_t count, AdslStableVector<AdslEntity>&& with)
+{
+    if (first > entities.size() || count > entities.size() - first)
+        throw std::out_of_range("AdslDatabase::replaceEntities: range outside entities");
+
+    const bool      indexed = isIndexed();
+    const size_t    end     = first + count;
+    const size_t    common  = min(count, with.size());
+    const ptrdiff_t delta   = ptrdiff_t(with.size()) - ptrdiff_t(count);
+
+    if (indexed) {
+        for (size_t i = first; i < end; ++i) removeFromIndexes(i);
+        if (delta != 0) shiftIndexes(end, delta);
+    }
+    for (size_t i = first; i < end; ++i) countRemoved(entities[i], true);
+    for (const AdslEntity& e : with)     countRemoved(e, false);
+
+    for (size_t k = 0; k < common; ++k)
+        entities[first + k] = std::move(with[k]);
+    if (with.size() > count)
+        entities.insert(entities.begin() + end,
+                        make_move_iterator(with.begin() + common), make_move_iterator(with.end()));
+    else if (common < count)
+        entities.erase(entities.begin() + first + common, entities.begin() + end);
+
+    if (indexed) {
+        m_indexedEntities = entities.size();
+        for (size_t i = first; i < first + with.size(); ++i) addToIndexes(i);
+    }
+    else if (delta != 0) dropIndexes();
+    touch();
+}
+
+/* Tombstones of one entity entering or leaving the counts */
+void AdslDatabase::countRemoved(const AdslEntity& e, bool leaving)
+{
+    size_t fields = 0;
+    for (const AdslField& f : e.fields) fields += f.m_removed;
+    if (leaving) { m_removedEntities -= e.m_removed; m_removedFields -= fields; }
+    else         { m_removedEntities += e.m_removed; m_removedFields += fields; }
+}
+
+bool AdslDatabase::removeEntity(size_t entity)
+{
+    if (entity >= entities.size())
+        throw std::out_of_range("AdslDatabase::removeEntity: no such entity");
+    AdslEntity& e = entities[entity];
+    if (e.m_removed) return false;
+    e.m_removed = true;
+    ++m_removedEntities;
+    touch();
+    compactIfDue();
+    return true;
+}
+
+bool AdslDatabase::removeField(const AdslFieldRef& ref)
+{
+    if (ref.entity >= entities.size() || ref.field >= entities[ref.entity].fields.size())
+        throw std::out_of_range("AdslDatabase::removeField: no such field");
+    AdslEntity& e = entities[ref.entity];
+    AdslField&  f = e.fields[ref.field];
+    if (e.m_removed || f.m_removed) return false;
+    f.m_removed = true;
+    ++m_removedFields;
+    touch();
+    compactIfDue();
+    return true;
+}
+
+size_t AdslDatabase::removeIf(const std::function<bool(const AdslEntity&)>& pred)
+{
+    size_t n = 0;
+    for (AdslEntity& e : entities)
+        if (!e.m_removed && pred(e)) { e.m_removed = true; ++n; }
+    m_removedEntities += n;
+    if (n) {
+        touch();
+        compactIfDue();
+    }
+    return n;
+}
+
+/* Entities slide down over the removed ones (moves only : same resource), each
+ * keeping its fields minus the removed ones. Positions change, so the indexes
+ * are rebuilt rather than patched. */
+size_t AdslDatabase::compact()
+{
+    const size_t dropped = m_removedEntities + m_removedFields;
+    if (dropped == 0) return 0;
+
+    const bool indexed = isIndexed();
+    auto out = entities.begin();
+    for (auto it = entities.begin(); it != entities.end(); ++it)
+    {
+        if (it->m_removed) continue;
+        if (m_removedFields)
+            it->fields.erase(std::remove_if(it->fields.begin(), it->fields.end(),
+                                            [](const AdslField& f){ return f.m_removed; }),
+                             it->fields.end());
+        if (out != it) *out = std::move(*it);
+        ++out;
+    }
+    entities.resize(size_t(out - entities.begin()));
+    entities.shrink_to_fit();
+    m_removedEntities = 0;
+    m_removedFields   = 0;
+
+    if (indexed) reindex();
+    else         { dropIndexes(); touch(); }
+    return dropped;
+}
+
+void AdslDatabase::compactIfDue()
+{
+    const size_t removed = m_removedEntities + m_removedFields;
+    if (m_compaction.minRemoved && removed >= m_compaction.minRemoved
+        && double(removed) >= m_compaction.minRatio * double(entities.size()))
+        compact();
 }
 
 /* Helpers */
 
 AdslValueType getAdslValueType(const AdslValue& v)
 {
-    switch(v.index())
+    return v.type();
+}
+
+const char* adslValueTypeName(AdslValueType t)
+{
+    switch(t)
     {
-        case 0:  return AdslValueType::String;
-        case 1:  return AdslValueType::Int;
-        case 2:  return AdslValueType::Float;
-        case 3:  return AdslValueType::Bool;
-        case 4:  return AdslValueType::StringList;
-        case 5:  return AdslValueType::IntList;
-        case 6:  return AdslValueType::FloatList;
-        case 7:  return AdslValueType::BoolList;
-        default: return AdslValueType::Unknown; // should never happen
-    }
-}
-
-string adslValueToString(const AdslValue& v)
-{
-    struct {
-        string operator()(const string& s)      const { return "\""+s+"\""; }
-        string operator()(int i)                const { return to_string(i); }
-        string operator()(float f)              const { ostringstream oss; oss<<f; return oss.str();}
-        string operator()(bool b)               const { return b?"true":"false"; }
-        string operator()(const vector<string>& vs) const{
-            string out="[";
-            for(size_t i=0;i<vs.size();++i){ out+="\""+vs[i]+"\""; if(i+1<vs.size())out+=",";}
-            return out+"]";
-        }
-        string operator()(const vector<int>& v) const{
-            string out="[";
-            for(size_t i=0;i<v.size();++i){ out+=to_string(v[i]); if(i+1<v.size())out+=",";}
-            return out+"]";
-        }
-        string operator()(const vector<float>& v) const{
-            string out="[";
-            for(size_t i=0;i<v.size();++i){ ostringstream oss; oss<<v[i]; out+=oss.str();
-                if(i+1<v.size())out+=",";}
-            return out+"]";
-        }
-        string operator()(const vector<bool>& v) const{
-            string out="[";
-            for(size_t i=0;i<v.size();++i){ out+=(v[i]?"true":"false"); if(i+1<v.size())out+=",";}
-            return out+"]";
-        }
-    } visitor;
-    return std::visit(visitor, v);
+        case AdslValueType::String:     return "string";
+        case AdslValueType::Int:        return "int";
+        case AdslValueType::Float:      return "float";
+        case AdslValueType::Bool:       return "bool";
+        case AdslValueType::StringList: return "string list";
+        case AdslValueType::IntList:    return "int list";
+        case AdslValueType::FloatList:  return "float list";
+        case AdslValueType::BoolList:   return "bool list";
+        case AdslValueType::Int64:      return "int64";
+        case AdslValueType::Double:     return "double";
+        case AdslValueType::Int64List:  return "int64 list";
+        case AdslValueType::DoubleList: return "double list";
+        default:                        return "unknown";
+    }
 }
 
+/* adslValueToString lives with the writer (adsl_writer.cpp) */
+
 /*   PARSER    */
 
-static bool parseInternal(istream& in, AdslDatabase& db)
+namespace {
+
+/* Values parsed into an arena database keep their blocks in it too */
+Arena* arenaOf(pmr::memory_resource* resource)
+{
+    return dynamic_cast<Arena*>(resource);
+}
+
+/* DOM sink writing group definitions straight into db.groups (last one wins) */
+auto databaseBuilder(AdslDatabase& db)
+{
+    return makeDomBuilder(db.entities, [&db](AdslGroup&& g){
+        string name = g.name;
+        db.groups[name] = std::move(g);
+    });
+}
+
+/* 'path' : the file 'data' comes from, for its includes (empty for text) */
+bool parseBuffer(string_view data, AdslDatabase& db, const string& path = string())
+{
+    db.clear();
+    auto builder = databaseBuilder(db);
+    LineParser<decltype(builder)> parser(builder, 0, PlainDecoder{ arenaOf(db.resource()) });
+    parser.parse(data);
+    parser.finish();
+    resolveIncludes(db, builder.includes(), path);
+    db.reindex();
+    return true;
+}
+
+/* parseBuffer, leaving values as text in 'source' (kept alive by db).
+ * Included files are decoded : only the root text is kept. */
+bool parseBufferLazy(shared_ptr<const void> source, string_view data, AdslDatabase& db, const string& path = string())
+{
+    db.clear();
+    auto builder = databaseBuilder(db);
+    LineParser<decltype(builder), RawDecoder> parser(builder);
+    parser.parse(data);
+    parser.finish();
+    resolveIncludes(db, builder.includes(), path);
+    db.reindex();
+    DatabaseAccess::setSource(db, std::move(source));
+    return true;
+}
+
+/* parseBuffer, counting and timing each phase into 'stats' (adsl_stats.hpp).
+ * Decode and build are timed where they happen; lex is what the parser loop
+ * spent outside of them. Included files count in build (and are not counted). */
+bool parseBufferInstrumented(string_view data, AdslDatabase& db, AdslParseStats& stats, const string& path = string())
 {
+    const auto start = chrono::steady_clock::now();
+    const uint64_t startTicks = ticks();
+
     db.clear();
-    string line;
-    size_t lineno=0;
-    AdslEntity* current = nullptr;
+    auto builder = databaseBuilder(db);
+    StatsSink<decltype(builder)> sink(builder, db, stats);
+    uint64_t decodeTicks = 0;
+    LineParser<decltype(sink), TimedDecoder> parser(sink, 0, TimedDecoder{ &decodeTicks, arenaOf(db.resource()) });
+
+    const uint64_t loopTicks = ticks();
+    parser.parse(data);
+    parser.finish();
+    const uint64_t indexTicks = ticks();
+    resolveIncludes(db, builder.includes(), path);
+    db.reindex();
+    const uint64_t endTicks = ticks();
+    const auto total = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start);
+
+    const double nsPerTick = endTicks > startTicks ? double(total.count()) / double(endTicks - startTicks) : 0.0;
+    auto toNs = [&](uint64_t t) { return chrono::nanoseconds(int64_t(double(t) * nsPerTick)); };
+    const uint64_t loop  = indexTicks - loopTicks;
+    const uint64_t build = sink.buildTicks() + (loopTicks - startTicks) + (endTicks - indexTicks);
+    const uint64_t inner = decodeTicks + sink.buildTicks();
 
-    while (std::getline(in, line))
+    stats.bytes      = data.size();
+    stats.lines      = parser.line();
+    stats.decodeTime = toNs(decodeTicks);
+    stats.buildTime  = toNs(build);
+    stats.lexTime    = toNs(loop > inner ? loop - inner : 0);
+    stats.totalTime += total;
+
+    HeapUse heap = sink.heap();
+    DatabaseAccess::addIndexes(db, heap);
+    stats.allocations     = heap.blocks;
+    stats.allocatedBytes  = heap.bytes;
+    stats.memoryFootprint = db.memoryFootprint();
+    return true;
+}
+
+/* Read 'in' block by block : only the unfinished last line is carried over,
+ * so memory stays bounded by the block size (or the longest line). */
+template<typename Sink>
+void parseStreamBlocks(istream& in, Sink& sink)
+{
+    const size_t kBlock = 1 << 20;
+    LineParser<Sink> parser(sink);
+    string buf(kBlock, '\0');
+    size_t have = 0;
+    while (!parser.stopped())
     {
-        ++lineno;
-        line = stripComment(line);
-        line = trimmed(line);
-        if(line.empty()) continue;
+        if (have == buf.size()) buf.resize(buf.size() * 2);     // line longer than the buffer
+        in.read(&buf[have], streamsize(buf.size() - have));
+        size_t got = size_t(in.gcount());
+        if (got == 0) break;
+        have += got;
 
-        /* Group definition */
-        if(startsWith(line,"@"))
-        {
-            size_t brk = line.find_first_of("[ \t");
-            string gName = line.substr(1, brk==string::npos? string::npos : brk-1);
-            AdslGroup g;
-            g.name = gName;
+        size_t lastNl = string_view(buf.data(), have).rfind('\n');
+        if (lastNl == string_view::npos) continue;
+        parser.parse(string_view(buf.data(), lastNl + 1));
+        have -= lastNl + 1;
+        buf.replace(0, have, buf, lastNl + 1, have);
+    }
+    if (have && !parser.stopped()) parser.parse(string_view(buf.data(), have));
+    parser.finish();
+}
+
+bool parseBuffer(string_view data, AdslHandler& handler)
+{
+    HandlerAccess sink{ handler };
+    LineParser<HandlerAccess> parser(sink);
+    parser.parse(data);
+    parser.finish();
+    return true;
+}
+
+/* --- parallel parsing --- */
+
+/* Result of one chunk, merged in chunk order once every worker is done */
+struct ParseChunk {
+    ParseChunk(string_view text, pmr::memory_resource* resource) : text(text), entities(resource) {}
+
+    string_view                  text;
+    size_t                       firstLine = 0;     // number of '\n' before the chunk
+    AdslStableVector<AdslEntity> entities;
+    vector<AdslGroup>            groups;            // in definition order (last one wins)
+    vector<IncludeRef>           includes;          // entitiesBefore : within the chunk
+    exception_ptr                error;
+};
 
-            size_t open = line.find('[');
-            if(open!=string::npos)
+/* Resource one worker may allocate a chunk from without locking. An arena
+ * forks a child (equal to it, so the merge below moves without copying);
+ * anything else falls back to the heap and the merge copies into db. */
+pmr::memory_resource* chunkResource(AdslDatabase& db)
+{
+    if (auto* arena = arenaOf(db.resource())) return &arena->fork();
+    return pmr::new_delete_resource();
+}
+
+/* Cut 'data' into roughly 'count' pieces, each one starting on an entity
+ * header (except the first). Since the grammar is line based and an entity
+ * owns every field line until the next header, chunks parse independently. */
+vector<string_view> splitAtEntities(string_view data, size_t count)
+{
+    vector<string_view> chunks;
+    size_t target = max<size_t>(data.size() / max<size_t>(count, 1), 1);
+    size_t begin = 0;
+    while (begin < data.size())
+    {
+        size_t cut = begin + target;
+        if (cut < data.size())
+        {
+            size_t nl = data.find('\n', cut - 1);       // end of the line holding cut-1
+            for (;;)
             {
-                size_t close = line.find_last_of(']');
-                if(close==string::npos || close<open)
-                    throw runtime_error("Line "+to_string(lineno)+": missing ] in group definition");
-                string inside = trimmed(line.substr(open+1, close-open-1));
-                string token;
-                stringstream ss(inside);
-                while(std::getline(ss, token, ','))
-                    g.values.push_back(trimmed(token));
+                if (nl == string_view::npos) { cut = data.size(); break; }
+                cut = nl + 1;
+                if (cut >= data.size() || isEntityLine(data, cut)) break;
+                nl = data.find('\n', cut);
             }
-            db.groups[gName] = std::move(g);
-            continue;
         }
+        cut = min(cut, data.size());
+        chunks.push_back(data.substr(begin, cut - begin));
+        begin = cut;
+    }
+    return chunks;
+}
 
-        /* Entity header */
-        if(startsWith(line, "#"))
-        {
-            string tmp = line.substr(1);
-            vector<string> groupsLocal;
-            extractGroups(tmp, groupsLocal);
-
-            /* remove groups part to leave pure type */
-            size_t atPos = tmp.find('@');
-            string type = trimmed(atPos==string::npos ? tmp : tmp.substr(0, atPos));
-
-            if(type.empty())
-                throw runtime_error("Line "+to_string(lineno)+": empty entity type");
-
-            db.entities.emplace_back();
-            current = &db.entities.back();
-            current->type = type;
-            current->groups = std::move(groupsLocal);
-            continue;
-        }
+bool parseBufferParallel(string_view data, AdslDatabase& db, unsigned threads, const string& path = string())
+{
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+    if (threads == 1) return parseBuffer(data, db, path);
 
-        /* Field */
-        if(startsWith(line,"-"))
-        {
-            if(!current)
-                throw runtime_error("Line "+to_string(lineno)+": field found outside entity");
-
-            string fld = trimmed(line.substr(1)); // drop '-'
-            /* find '=' */
-            size_t eq = fld.find('=');
-            if(eq==string::npos)
-                throw runtime_error("Line "+to_string(lineno)+": '=' expected in field");
-
-            string key = trimmed(fld.substr(0, eq));
-            string rest = trimmed(fld.substr(eq+1));
-
-            /* value stops at first @ or end of string */
-            size_t at = rest.find('@');
-            string valPart = trimmed(at==string::npos ? rest : rest.substr(0, at));
-
-            /* remove trailing ',' from value part */
-            if(!valPart.empty() && valPart.back()==',')
-                valPart.pop_back();
-
-            AdslField f;
-            f.name = key;
-            try{
-                f.value = parseValue(valPart);
-            }catch(const std::exception& ex){
-                throw runtime_error("Line "+to_string(lineno)+": "+ex.what());
-            }
+    db.clear();
 
-            /* groups after value */
-            if(at!=string::npos){
-                string groupPart = rest.substr(at);
-                extractGroups(groupPart, f.groups);
-            }
+    /* a few chunks per thread keeps workers busy when entity sizes vary */
+    vector<ParseChunk> chunks;
+    for (string_view text : splitAtEntities(data, size_t(threads) * 4))
+        chunks.emplace_back(text, chunkResource(db));
 
-            current->fields.push_back(std::move(f));
-            continue;
+    /* line numbers : count newlines per chunk, then prefix-sum */
+    parallelFor(chunks.size(), threads, [&](size_t i){
+        chunks[i].firstLine = size_t(count(chunks[i].text.begin(), chunks[i].text.end(), '\n'));
+    });
+    size_t lines = 0;
+    for (auto& c : chunks) { size_t n = c.firstLine; c.firstLine = lines; lines += n; }
+
+    parallelFor(chunks.size(), threads, [&](size_t i){
+        ParseChunk& c = chunks[i];
+        try {
+            auto builder = makeDomBuilder(c.entities, [&c](AdslGroup&& g){
+                c.groups.push_back(std::move(g));
+            });
+            PlainDecoder decoder{ arenaOf(c.entities.get_allocator().resource()) };
+            LineParser<decltype(builder)> parser(builder, c.firstLine, decoder);
+            parser.parse(c.text);
+            parser.finish();
+            c.includes = builder.includes();
+        } catch (...) {
+            c.error = current_exception();
         }
+    });
+
+    /* the first failing chunk holds the error a sequential parse would report */
+    for (auto& c : chunks)
+        if (c.error) rethrow_exception(c.error);
 
-        throw runtime_error("Line "+to_string(lineno)+": Unrecognised syntax -> "+line);
+    size_t total = 0;
+    for (auto& c : chunks) total += c.entities.size();
+    db.entities.reserve(total);
+    vector<IncludeRef> includes;
+    for (auto& c : chunks)
+    {
+        for (auto& g : c.groups) {
+            string name = g.name;
+            db.groups[name] = std::move(g);
+        }
+        for (auto& inc : c.includes) {
+            inc.entitiesBefore += db.entities.size();
+            includes.push_back(std::move(inc));
+        }
+        move(c.entities.begin(), c.entities.end(), back_inserter(db.entities));
     }
+    resolveIncludes(db, includes, path);
+    db.reindex();
     return true;
 }
 
+} // namespace
+
 bool parseAdslFile(const string& filepath, AdslDatabase& db)
 {
-    ifstream file(filepath);
-    if(!file) return false;
-    return parseInternal(file, db);
+    adsl::detail::MappedFile file;
+    if(!file.open(filepath)) return false;
+    return parseBuffer(file.view(), db, filepath);
 }
 
 bool parseAdslString(const string& data, AdslDatabase& db)
 {
-    istringstream ss(data);
-    return parseInternal(ss, db);
+    return parseBuffer(data, db);
+}
+
+bool parseAdslBuffer(const char* data, size_t size, AdslDatabase& db)
+{
+    return parseBuffer(string_view(data, size), db);
+}
+
+bool parseAdslFile(const string& filepath, AdslDatabase& db, AdslValues values)
+{
+    if (values == AdslValues::Eager) return parseAdslFile(filepath, db);
+    auto file = make_shared<adsl::detail::MappedFile>();
+    if(!file->open(filepath)) return false;
+    string_view data = file->view();
+    return parseBufferLazy(std::move(file), data, db, filepath);
+}
+
+bool parseAdslString(const string& data, AdslDatabase& db, AdslValues values)
+{
+    return parseAdslBuffer(data.data(), data.size(), db, values);
+}
+
+bool parseAdslBuffer(const char* data, size_t size, AdslDatabase& db, AdslValues values)
+{
+    if (values == AdslValues::Eager) return parseBuffer(string_view(data, size), db);
+    auto copy = make_shared<string>(data, size);
+    string_view text = *copy;
+    return parseBufferLazy(std::move(copy), text, db);
+}
+
+bool parseAdslFile(const string& filepath, AdslDatabase& db, AdslParseStats* stats)
+{
+    if (!stats) return parseAdslFile(filepath, db);
+    *stats = AdslParseStats();
+    const auto start = chrono::steady_clock::now();
+    adsl::detail::MappedFile file;
+    bool opened = file.open(filepath);
+    stats->readTime  = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start);
+    stats->totalTime = stats->readTime;
+    if(!opened) return false;
+    return parseBufferInstrumented(file.view(), db, *stats, filepath);
+}
+
+bool parseAdslString(const string& data, AdslDatabase& db, AdslParseStats* stats)
+{
+    if (!stats) return parseBuffer(data, db);
+    *stats = AdslParseStats();
+    return parseBufferInstrumented(data, db, *stats);
+}
+
+bool parseAdslBuffer(const char* data, size_t size, AdslDatabase& db, AdslParseStats* stats)
+{
+    if (!stats) return parseBuffer(string_view(data, size), db);
+    *stats = AdslParseStats();
+    return parseBufferInstrumented(string_view(data, size), db, *stats);
+}
+
+bool parseAdslFileParallel(const string& filepath, AdslDatabase& db, unsigned threads)
+{
+    adsl::detail::MappedFile file;
+    if(!file.open(filepath)) return false;
+    return parseBufferParallel(file.view(), db, threads, filepath);
+}
+
+bool parseAdslBufferParallel(const char* data, size_t size, AdslDatabase& db, unsigned threads)
+{
+    return parseBufferParallel(string_view(data, size), db, threads);
+}
+
+/* --- streaming (handler) entry points --- */
+
+bool parseAdslFile(const string& filepath, AdslHandler& handler)
+{
+    ifstream file(filepath, ios::binary);
+    if(!file) return false;
+    HandlerAccess sink{ handler };
+    parseStreamBlocks(file, sink);
+    return true;
+}
+
+bool parseAdslStream(istream& in, AdslHandler& handler)
+{
+    HandlerAccess sink{ handler };
+    parseStreamBlocks(in, sink);
+    return true;
+}
+
+bool parseAdslString(const string& data, AdslHandler& handler)
+{
+    return parseBuffer(data, handler);
+}
+
+bool parseAdslBuffer(const char* data, size_t size, AdslHandler& handler)
+{
+    return parseBuffer(string_view(data, size), handler);
 }
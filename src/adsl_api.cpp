@@ -1,31 +1,52 @@
 #include "../include/adsl/adsl_api.hpp"
-#include <sstream>
-#include <fstream>
-#include <iomanip>
-#include <algorithm>   // std::find
+#include "../include/adsl/adsl_writer.hpp"
+
+#include <charconv>
+#include <stdexcept>
 
 using namespace adsl;
 
+/* shortest digits that read back as f, read as a double */
+double adsl::widenFloat(float f)
+{
+    char buf[32];
+    double d = f;
+    auto r = std::to_chars(buf, buf + sizeof(buf), f);
+    if (r.ec == std::errc()) std::from_chars(buf, r.ptr, d);
+    return d;
+}
+
+void adsl::bind::mismatch(std::size_t line, std::string_view type, std::string_view field, AdslValueType got)
+{
+    std::string what = "#" + std::string(type) + "." + std::string(field) + " : "
+                     + adslValueTypeName(got) + " does not fit the bound member";
+    if (line) what = "Line " + std::to_string(line) + ": " + what;
+    throw std::runtime_error(what);
+}
+
 /* ******************************************************************** */
 /*  --------------------------- API  impl ----------------------------- */
 /* ******************************************************************** */
 
-bool API::loadFile(const std::string& path)
+bool API::loadFile(const std::string& path, AdslValues values)
 {
-    return parseAdslFile(path, m_db);
+    m_shapes.clear();
+    bool ok = parseAdslFile(path, m_db, values);
+    learnShapes();
+    return ok;
 }
 
-bool API::loadString(const std::string& data)
+bool API::loadString(const std::string& data, AdslValues values)
 {
-    return parseAdslString(data, m_db);
+    m_shapes.clear();
+    bool ok = parseAdslString(data, m_db, values);
+    learnShapes();
+    return ok;
 }
 
 bool API::saveFile(const std::string& path) const
 {
-    std::ofstream out(path);
-    if (!out) return false;
-    out << serialize(m_db);
-    return true;
+    return adsl::saveFile(m_db, path);     // streamed, see adsl_writer.cpp
 }
 
 std::string API::toString() const
@@ -35,15 +56,22 @@ std::string API::toString() const
 
 /* ----------  Queries (non-const versions reconstruits)  ------------- */
 
-std::vector<AdslEntity*> API::entitiesByType(const std::string& type)
+/* The database answers from its indexes; m_db is owned (non-const) by the API,
+ * so handing out mutable pointers to the same objects is fine. */
+template<typename T>
+static std::vector<T*> asMutable(const std::vector<const T*>& v)
 {
-    std::vector<AdslEntity*> res;
-    for (auto& e : m_db.entities)
-        if (e.type == type)
-            res.push_back(&e);
+    std::vector<T*> res;
+    res.reserve(v.size());
+    for (const T* p : v) res.push_back(const_cast<T*>(p));
     return res;
 }
 
+std::vector<AdslEntity*> API::entitiesByType(const std::string& type)
+{
+    return asMutable(m_db.findEntitiesByType(type));
+}
+
 std::vector<const AdslEntity*> API::entitiesByType(const std::string& type) const
 {
     return m_db.findEntitiesByType(type);
@@ -51,11 +79,7 @@ std::vector<const AdslEntity*> API::entitiesByType(const std::string& type) cons
 
 std::vector<AdslEntity*> API::entitiesByGroup(const std::string& grp)
 {
-    std::vector<AdslEntity*> res;
-    for (auto& e : m_db.entities)
-        if (std::find(e.groups.begin(), e.groups.end(), grp) != e.groups.end())
-            res.push_back(&e);
-    return res;
+    return asMutable(m_db.findEntitiesByGroup(grp));
 }
 
 std::vector<const AdslEntity*> API::entitiesByGroup(const std::string& grp) const
@@ -65,12 +89,7 @@ std::vector<const AdslEntity*> API::entitiesByGroup(const std::string& grp) cons
 
 std::vector<AdslField*> API::fieldsByGroup(const std::string& grp)
 {
-    std::vector<AdslField*> res;
-    for (auto& e : m_db.entities)
-        for (auto& f : e.fields)
-            if (std::find(f.groups.begin(), f.groups.end(), grp) != f.groups.end())
-                res.push_back(&f);
-    return res;
+    return asMutable(m_db.findFieldsByGroup(grp));
 }
 
 std::vector<const AdslField*> API::fieldsByGroup(const std::string& grp) const
@@ -91,77 +110,154 @@ AdslGroup& API::addGroup(const std::string& name,
 AdslEntity& API::addEntity(const std::string& type,
                            const std::vector<std::string>& groups)
 {
-    m_db.entities.emplace_back();
-    AdslEntity& e = m_db.entities.back();
-    e.type   = type;
-    e.groups = groups;
+    AdslEntity& e = m_db.entities.emplace_back();
+    e.type = type;
+    e.groups.assign(groups.begin(), groups.end());
+    m_db.indexEntity(m_db.entities.size() - 1);
+    m_shapes.learn(e);
+    return e;
+}
+
+AdslEntity& API::addEntity(AdslEntity&& entity)
+{
+    AdslEntity& e = m_db.entities.emplace_back(std::move(entity));
+    m_db.indexEntity(m_db.entities.size() - 1);
+    m_shapes.learn(e);
     return e;
 }
 
+void API::reserve(std::size_t entities)
+{
+    m_db.entities.reserve(entities);
+}
+
 AdslField& API::addField(AdslEntity& ent,
                          const std::string& name,
-                         const AdslValue& value,
+                         const AdslValue&   value,
                          const std::vector<std::string>& groups)
 {
-    ent.fields.push_back({ name, value, groups });
-    return ent.fields.back();
+    return addField(ent, name, AdslValue(value), groups);
+}
+
+AdslField& API::addField(AdslEntity& ent,
+                         const std::string& name,
+                         AdslValue&&        value,
+                         const std::vector<std::string>& groups)
+{
+    AdslField& f = ent.fields.emplace_back();
+    f.name  = name;
+    f.value = std::move(value);
+    f.groups.assign(groups.begin(), groups.end());
+    return fieldAdded(ent);
+}
+
+AdslField& API::addField(AdslEntity& ent, AdslField&& field)
+{
+    ent.fields.push_back(std::move(field));
+    return fieldAdded(ent);
+}
+
+/* Shape and indexes for ent's last field (only entities living in m_db are indexed) */
+AdslField& API::fieldAdded(AdslEntity& ent)
+{
+    AdslField& f = ent.fields.back();
+    m_shapes.learn(ent.type, f.name, ent.fields.size() - 1);
+    std::size_t entity = m_db.indexOf(ent);
+    if (entity != AdslStableVector<AdslEntity>::npos)
+        m_db.indexField(entity, ent.fields.size() - 1);
+    return f;
+}
+
+bool API::removeEntity(const AdslEntity& ent)
+{
+    std::size_t entity = m_db.indexOf(ent);
+    return entity != AdslStableVector<AdslEntity>::npos && m_db.removeEntity(entity);
+}
+
+bool API::removeField(const AdslEntity& ent, const AdslField& field)
+{
+    std::size_t entity = m_db.indexOf(ent);
+    if (entity == AdslStableVector<AdslEntity>::npos) return false;
+    const std::less<const AdslField*> less;
+    if (less(&field, ent.fields.data()) || !less(&field, ent.fields.data() + ent.fields.size())) return false;
+    return m_db.removeField(AdslFieldRef{ entity, std::size_t(&field - ent.fields.data()) });
+}
+
+std::size_t API::removeIf(const std::function<bool(const AdslEntity&)>& pred)
+{
+    return m_db.removeIf(pred);
 }
 
 void API::forEachEntity(const std::function<void(AdslEntity&)>& fn)
 {
     for (auto& e : m_db.entities)
-        fn(e);
+        if (!e.removed()) fn(e);
 }
 
 /* ******************************************************************** */
-/*  --------------------------- Writer  ------------------------------- */
+/*  --------------------------- Shape cache --------------------------- */
 /* ******************************************************************** */
 
-// helper: join vector<string> with separator
-static std::string join(const std::vector<std::string>& v,
-                        const std::string& sep)
+void API::learnShapes()
 {
-    std::ostringstream oss;
-    for (size_t i = 0; i < v.size(); ++i) {
-        oss << v[i];
-        if (i + 1 < v.size()) oss << sep;
-    }
-    return oss.str();
+    for (const auto& e : m_db.entities)
+        m_shapes.learn(e);
 }
 
-std::string adsl::serialize(const AdslDatabase& db)
+void ShapeCache::learn(const AdslEntity& e)
 {
-    std::ostringstream out;
-    out << std::fixed << std::setprecision(2);
+    for (std::size_t i = 0; i < e.fields.size(); ++i)
+        learn(e.type, e.fields[i].name, i);
+}
 
-    for (const auto& kv : db.groups) {
-        const AdslGroup& g = kv.second;
-        out << '@' << g.name;
-        if (!g.values.empty())
-            out << '[' << join(g.values, ",") << ']';
-        out << '\n';
-    }
-    if (!db.groups.empty()) out << '\n';
+ShapeCache::Shape& ShapeCache::shapeFor(AdslSymbol type)
+{
+    if (Shape* s = const_cast<Shape*>(shapeOf(type))) return *s;
 
-    for (const auto& e : db.entities) {
-        out << '#' << e.type;
-        for (auto& g : e.groups) out << " @" << g;
-        out << '\n';
+    if ((m_typeCount + 1) * 2 > m_types.size())
+    {
+        std::vector<Shape> old = std::move(m_types);
+        m_types.assign(old.empty() ? 8 : old.size() * 2, Shape{});
+        std::size_t mask = m_types.size() - 1;
+        for (Shape& s : old) {
+            if (s.type == 0) continue;
+            std::size_t i = (s.type - 1) & mask;
+            while (m_types[i].type != 0) i = (i + 1) & mask;
+            m_types[i] = std::move(s);
+        }
+    }
 
-        for (const auto& f : e.fields) {
-            out << "    - " << f.name << '='
-                << adslValueToString(f.value);
+    std::size_t mask = m_types.size() - 1;
+    std::size_t i = type.id() & mask;
+    while (m_types[i].type != 0) i = (i + 1) & mask;
+    m_types[i].type = type.id() + 1;
+    ++m_typeCount;
+    return m_types[i];
+}
 
-            if (!f.groups.empty()) out << ' ';
-            for (size_t i = 0; i < f.groups.size(); ++i) {
-                out << '@' << f.groups[i];
-                if (i + 1 < f.groups.size())
-                    out << ' ';
-            }
+/* First slot seen for a name wins : later entities only add names the type lacked */
+void ShapeCache::learn(AdslSymbol type, AdslSymbol name, std::size_t slot)
+{
+    if (name.empty()) return;                                   // id 0 marks empty entries
+    Shape& s = shapeFor(type);
 
-            out << '\n';
+    if ((s.count + 1) * 2 > s.table.size())
+    {
+        std::vector<Entry> old = std::move(s.table);
+        s.table.assign(old.empty() ? 16 : old.size() * 2, Entry{});
+        std::size_t mask = s.table.size() - 1;
+        for (const Entry& e : old) {
+            if (e.name == 0) continue;
+            std::size_t i = e.name & mask;
+            while (s.table[i].name != 0) i = (i + 1) & mask;
+            s.table[i] = e;
         }
-        out << '\n';
     }
-    return out.str();
-}
\ No newline at end of file
+
+    std::size_t mask = s.table.size() - 1;
+    std::size_t i = name.id() & mask;
+    for (; s.table[i].name != 0; i = (i + 1) & mask)
+        if (s.table[i].name == name.id()) return;
+    s.table[i] = Entry{ name.id(), std::uint32_t(slot) };
+    ++s.count;
+}
@@ -0,0 +1,95 @@
+#include "adsl_arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+using namespace adsl::detail;
+
+namespace {
+    /* blocks come from operator new, aligned for any fundamental type */
+    constexpr std::size_t kBlockAlign = alignof(std::max_align_t);
+
+    std::uintptr_t alignUp(std::uintptr_t p, std::size_t align)
+    {
+        return (p + align - 1) & ~std::uintptr_t(align - 1);
+    }
+}
+
+Arena::~Arena()
+{
+    release();
+}
+
+Arena& Arena::fork()
+{
+    Arena& root = *m_root;
+    std::lock_guard<std::mutex> lock(root.m_mutex);
+    root.m_children.push_back(std::make_unique<Arena>());
+    Arena& child = *root.m_children.back();
+    child.m_root = &root;
+    return child;
+}
+
+void Arena::release()
+{
+    while (m_blocks) {
+        Block* next = m_blocks->next;
+        ::operator delete(m_blocks);
+        m_blocks = next;
+    }
+    m_cur = m_end = nullptr;
+    m_nextBlock = kFirstBlock;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_children.clear();
+}
+
+std::size_t Arena::bytesReserved() const
+{
+    std::size_t total = 0;
+    for (const Block* b = m_blocks; b; b = b->next) total += b->size;
+    for (const auto& c : m_children) total += c->bytesReserved();
+    return total;
+}
+
+void Arena::newBlock(std::size_t minSize)
+{
+    std::size_t size = std::max(m_nextBlock, minSize + sizeof(Block));
+    m_nextBlock = std::min(m_nextBlock * 2, kMaxBlock);
+
+    Block* b = static_cast<Block*>(::operator new(size));
+    b->next  = m_blocks;
+    b->size  = size;
+    m_blocks = b;
+    m_cur = reinterpret_cast<char*>(b) + alignUp(sizeof(Block), kBlockAlign);
+    m_end = reinterpret_cast<char*>(b) + size;
+}
+
+void* Arena::do_allocate(std::size_t bytes, std::size_t align)
+{
+    if (bytes > kLargeAllocation)
+        return std::pmr::new_delete_resource()->allocate(bytes, align);
+
+    std::uintptr_t p = alignUp(reinterpret_cast<std::uintptr_t>(m_cur), align);
+    if (!m_cur || p + bytes > reinterpret_cast<std::uintptr_t>(m_end)) {
+        newBlock(bytes + align);
+        p = alignUp(reinterpret_cast<std::uintptr_t>(m_cur), align);
+    }
+    m_cur = reinterpret_cast<char*>(p + bytes);
+    return reinterpret_cast<void*>(p);
+}
+
+void Arena::do_deallocate(void* p, std::size_t bytes, std::size_t align)
+{
+    /* the same size comes back on deallocation, so large blocks are recognised by it */
+    if (bytes > kLargeAllocation)
+        std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+}
+
+bool Arena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    if (this == &other) return true;
+    auto* arena = dynamic_cast<const Arena*>(&other);
+    return arena && arena->m_root == m_root;
+}
@@ -0,0 +1,63 @@
+#ifndef ADSL_ARENA_HPP
+#define ADSL_ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+namespace adsl {
+namespace detail {
+
+/* Bump allocator behind AdslDatabase(AdslAllocation::Arena).
+ *
+ * Small requests are carved out of growing blocks and never freed one by one;
+ * release() drops every block at once. Requests above kLargeAllocation (big
+ * vectors that keep reallocating while they grow) go straight to the heap and
+ * are freed eagerly, so growth does not leave dead copies behind in the arena.
+ *
+ * Not thread-safe. fork() hands out a child arena for another thread : children
+ * live as long as their root and compare equal to it, so containers built on a
+ * child can be moved into the root's containers without copying. */
+class Arena : public std::pmr::memory_resource
+{
+public:
+    static constexpr std::size_t kFirstBlock      = 64 * 1024;
+    static constexpr std::size_t kMaxBlock        = 4 * 1024 * 1024;
+    static constexpr std::size_t kLargeAllocation = 16 * 1024;
+
+    Arena() = default;
+    ~Arena() override;
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    Arena& fork();                          // thread-safe
+    void   release();                       // frees everything (children included)
+
+    std::size_t bytesReserved() const;      // blocks held, children included
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t align) override;
+    void  do_deallocate(void* p, std::size_t bytes, std::size_t align) override;
+    bool  do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    void  newBlock(std::size_t minSize);
+
+    struct Block { Block* next; std::size_t size; };
+
+    Arena*      m_root      = this;
+    char*       m_cur       = nullptr;
+    char*       m_end       = nullptr;
+    Block*      m_blocks    = nullptr;
+    std::size_t m_nextBlock = kFirstBlock;
+
+    std::mutex                          m_mutex;        // root only : guards m_children
+    std::vector<std::unique_ptr<Arena>> m_children;
+};
+
+} // namespace detail
+} // namespace adsl
+
+#endif // ADSL_ARENA_HPP
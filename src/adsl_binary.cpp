@@ -0,0 +1,857 @@
+#include "../include/adsl/adsl_binary.hpp"
+#include "adsl_mmap.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace adsl;
+
+/* ******************************************************************** */
+/*  ---------------------------- Layout  ------------------------------ */
+/* ******************************************************************** */
+
+namespace {
+
+    const char     kMagic[8]  = { 'A','D','S','L','B','\r','\n','\x1a' };
+    const uint32_t kByteOrder = 0x01020304u;
+
+    struct Section {
+        uint64_t offset;                       // from start of file
+        uint64_t count;                        // elements (bytes for byte sections)
+    };
+
+    struct Header {
+        char     magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint64_t fileSize;
+        uint64_t checksum;                     // over [sizeof(Header), fileSize)
+        Section  stringOffsets;                // uint64 [strings+1]
+        Section  stringData;                   // bytes
+        Section  groups;                       // GroupRecord
+        Section  entities;                     // EntityRecord
+        Section  fields;                       // FieldRecord
+        Section  groupRefs;                    // uint32 string ids
+        Section  lists;                        // bytes
+        Section  typeIndex;                    // IndexRecord -> entity ids
+        Section  entityGroupIndex;             // IndexRecord -> entity ids
+        Section  fieldGroupIndex;              // IndexRecord -> field ids
+        Section  indexIds;                     // uint32
+    };
+
+    struct GroupRecord {
+        uint32_t name;
+        uint32_t firstValue;                   // into groupRefs
+        uint32_t valueCount;
+        uint32_t reserved;
+    };
+
+    struct EntityRecord {
+        uint32_t type;
+        uint32_t firstField;
+        uint32_t fieldCount;
+        uint32_t firstGroup;                   // into groupRefs
+        uint32_t groupCount;
+    };
+
+    struct FieldRecord {
+        uint32_t name;
+        uint32_t firstGroup;                   // into groupRefs
+        uint16_t groupCount;
+        uint8_t  valueType;                    // AdslValueType
+        uint8_t  reserved;
+        uint32_t listSize;
+        uint64_t payload;                      // scalar bits, string id or byte offset into lists
+    };
+
+    struct IndexRecord {
+        uint32_t key;                          // string id (records sorted by key)
+        uint32_t count;
+        uint64_t first;                        // into indexIds
+    };
+
+    static_assert(sizeof(Header)       == 208, "unexpected padding in Header");
+    static_assert(sizeof(GroupRecord)  == 16,  "unexpected padding in GroupRecord");
+    static_assert(sizeof(EntityRecord) == 20,  "unexpected padding in EntityRecord");
+    static_assert(sizeof(FieldRecord)  == 24,  "unexpected padding in FieldRecord");
+    static_assert(sizeof(IndexRecord)  == 16,  "unexpected padding in IndexRecord");
+
+    bool hostIsLittleEndian()
+    {
+        const uint32_t probe = 1;
+        unsigned char first;
+        std::memcpy(&first, &probe, 1);
+        return first == 1;
+    }
+
+    uint32_t checkedU32(size_t v, const char* what)
+    {
+        if (v > 0xFFFFFFFFull)
+            throw std::runtime_error(std::string("ADSL binary: too many ") + what);
+        return static_cast<uint32_t>(v);
+    }
+
+} // namespace
+
+/* ******************************************************************** */
+/*  ---------------------------- Writer  ------------------------------ */
+/* ******************************************************************** */
+
+namespace {
+
+class BinaryWriter
+{
+public:
+    explicit BinaryWriter(const AdslDatabase& db) : m_db(db) {}
+
+    std::string run()
+    {
+        collectStrings();
+
+        m_out.assign(sizeof(Header), '\0');
+        Header h{};
+        std::memcpy(h.magic, kMagic, sizeof kMagic);
+        h.version   = kBinaryVersion;
+        h.byteOrder = kByteOrder;
+
+        /* strings */
+        {
+            std::vector<uint64_t> offsets;
+            offsets.reserve(m_strings.size() + 1);
+            uint64_t off = 0;
+            for (auto s : m_strings) { offsets.push_back(off); off += s.size(); }
+            offsets.push_back(off);
+            h.stringOffsets = appendArray(offsets);
+            h.stringData    = beginSection();
+            for (auto s : m_strings) m_out.append(s.data(), s.size());
+            h.stringData.count = off;
+        }
+
+        std::vector<uint32_t> refs;                     // groupRefs
+
+        /* group definitions */
+        {
+            std::vector<GroupRecord> groups;
+            for (const auto& kv : m_db.groups) {
+                const AdslGroup& g = kv.second;
+                GroupRecord r{};
+                r.name       = strId(g.name);
+                r.firstValue = checkedU32(refs.size(), "group references");
+                r.valueCount = checkedU32(g.values.size(), "group values");
+                for (auto& v : g.values) refs.push_back(strId(v));
+                groups.push_back(r);
+            }
+            h.groups = appendArray(groups);
+        }
+
+        /* entities + fields (+ indexes, built in the same pass) */
+        std::vector<EntityRecord> entities;
+        std::vector<FieldRecord>  fields;
+        std::string               lists;
+        std::unordered_map<uint32_t, std::vector<uint32_t>> byType, byGroup, fieldsByGroup;
+        entities.reserve(m_db.entities.size());
+
+        /* removed entities and fields are left out : ids count the written ones */
+        for (const AdslEntity& e : m_db.entities)
+        {
+            if (e.removed()) continue;
+            const uint32_t eid = checkedU32(entities.size(), "entities");
+            EntityRecord er{};
+            er.type       = symId(e.type);
+            er.firstField = checkedU32(fields.size(), "fields");
+            er.firstGroup = checkedU32(refs.size(), "group references");
+            er.groupCount = checkedU32(e.groups.size(), "entity groups");
+            for (auto& g : e.groups) {
+                uint32_t gid = symId(g);
+                refs.push_back(gid);
+                addUnique(byGroup[gid], eid);
+            }
+            byType[er.type].push_back(eid);
+
+            for (const AdslField& f : e.fields)
+            {
+                if (f.removed()) continue;
+                const uint32_t fid = checkedU32(fields.size(), "fields");
+                FieldRecord fr{};
+                fr.name       = symId(f.name);
+                fr.firstGroup = checkedU32(refs.size(), "group references");
+                if (f.groups.size() > 0xFFFF)
+                    throw std::runtime_error("ADSL binary: too many groups on field " + f.name.str());
+                fr.groupCount = static_cast<uint16_t>(f.groups.size());
+                for (auto& g : f.groups) {
+                    uint32_t gid = symId(g);
+                    refs.push_back(gid);
+                    addUnique(fieldsByGroup[gid], fid);
+                }
+                encodeValue(f.get(), fr, lists);
+                fields.push_back(fr);
+            }
+            er.fieldCount = checkedU32(fields.size() - er.firstField, "fields");
+            entities.push_back(er);
+        }
+
+        h.entities  = appendArray(entities);
+        h.fields    = appendArray(fields);
+        h.groupRefs = appendArray(refs);
+        h.lists     = beginSection();
+        m_out += lists;
+        h.lists.count = lists.size();
+
+        std::vector<uint32_t> ids;
+        h.typeIndex        = appendIndex(byType, ids);
+        h.entityGroupIndex = appendIndex(byGroup, ids);
+        h.fieldGroupIndex  = appendIndex(fieldsByGroup, ids);
+        h.indexIds         = appendArray(ids);
+
+        h.fileSize = m_out.size();
+        h.checksum = detail::hashBytes(m_out.data() + sizeof(Header), m_out.size() - sizeof(Header));
+        std::memcpy(&m_out[0], &h, sizeof h);
+        return std::move(m_out);
+    }
+
+private:
+    /* every name and string value goes to one sorted table, so lookups by
+     * name on the read side are a binary search over ids */
+    void collectStrings()
+    {
+        std::vector<std::string_view> all;
+        auto add = [&all](std::string_view s){ all.push_back(s); };
+        for (const auto& kv : m_db.groups) {
+            add(kv.second.name);
+            for (auto& v : kv.second.values) add(v);
+        }
+        for (const auto& e : m_db.entities) {
+            if (e.removed()) continue;
+            add(e.type.view());
+            for (auto& g : e.groups) add(g.view());
+            for (const auto& f : e.fields) {
+                if (f.removed()) continue;
+                add(f.name.view());
+                for (auto& g : f.groups) add(g.view());
+                const AdslValue& v = f.get();
+                if (v.type() == AdslValueType::String) add(v.asString());
+                for (std::string_view s : v.strings()) add(s);
+            }
+        }
+        std::sort(all.begin(), all.end());
+        all.erase(std::unique(all.begin(), all.end()), all.end());
+        checkedU32(all.size(), "strings");
+        m_strings = std::move(all);
+        m_ids.reserve(m_strings.size());
+        for (size_t i = 0; i < m_strings.size(); ++i)
+            m_ids.emplace(m_strings[i], static_cast<uint32_t>(i));
+    }
+
+    uint32_t strId(std::string_view s) const { return m_ids.at(s); }
+    uint32_t symId(AdslSymbol s) const
+    {
+        auto it = m_symbolIds.find(s);
+        if (it != m_symbolIds.end()) return it->second;
+        uint32_t v = strId(s.view());
+        m_symbolIds.emplace(s, v);
+        return v;
+    }
+
+    static void addUnique(std::vector<uint32_t>& list, uint32_t v)
+    {
+        if (list.empty() || list.back() != v) list.push_back(v);
+    }
+
+    static void align8(std::string& s) { s.resize((s.size() + 7) & ~size_t(7), '\0'); }
+
+    Section beginSection()
+    {
+        align8(m_out);
+        return Section{ m_out.size(), 0 };
+    }
+
+    template<typename T>
+    Section appendArray(const std::vector<T>& v)
+    {
+        Section s = beginSection();
+        s.count = v.size();
+        m_out.append(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+        return s;
+    }
+
+    Section appendIndex(const std::unordered_map<uint32_t, std::vector<uint32_t>>& index,
+                        std::vector<uint32_t>& ids)
+    {
+        std::vector<IndexRecord> records;
+        records.reserve(index.size());
+        for (const auto& kv : index) {
+            IndexRecord r{};
+            r.key   = kv.first;
+            r.count = checkedU32(kv.second.size(), "index entries");
+            r.first = ids.size();
+            ids.insert(ids.end(), kv.second.begin(), kv.second.end());
+            records.push_back(r);
+        }
+        std::sort(records.begin(), records.end(),
+                  [](const IndexRecord& a, const IndexRecord& b){ return a.key < b.key; });
+        return appendArray(records);
+    }
+
+    template<typename T>
+    static uint64_t appendList(std::string& lists, const T* data, size_t n)
+    {
+        align8(lists);
+        uint64_t off = lists.size();
+        lists.append(reinterpret_cast<const char*>(data), n * sizeof(T));
+        return off;
+    }
+
+    void encodeValue(const AdslValue& v, FieldRecord& r, std::string& lists) const
+    {
+        r.valueType = static_cast<uint8_t>(getAdslValueType(v));
+        switch (getAdslValueType(v))
+        {
+            case AdslValueType::String: r.payload = strId(v.asString()); break;
+            case AdslValueType::Int:    r.payload = static_cast<uint64_t>(static_cast<int64_t>(v.asInt())); break;
+            case AdslValueType::Float: {
+                uint32_t bits;
+                float f = v.asFloat();
+                std::memcpy(&bits, &f, 4);
+                r.payload = bits;
+                break;
+            }
+            case AdslValueType::Bool:   r.payload = v.asBool() ? 1 : 0; break;
+            case AdslValueType::StringList: {
+                AdslSpan<std::string_view> l = v.strings();
+                std::vector<uint32_t> ids;
+                ids.reserve(l.size());
+                for (std::string_view s : l) ids.push_back(strId(s));
+                r.listSize = checkedU32(l.size(), "list items");
+                r.payload  = appendList(lists, ids.data(), ids.size());
+                break;
+            }
+            case AdslValueType::IntList: {
+                AdslSpan<int> l = v.ints();
+                r.listSize = checkedU32(l.size(), "list items");
+                r.payload  = appendList(lists, l.data(), l.size());
+                break;
+            }
+            case AdslValueType::FloatList: {
+                AdslSpan<float> l = v.floats();
+                r.listSize = checkedU32(l.size(), "list items");
+                r.payload  = appendList(lists, l.data(), l.size());
+                break;
+            }
+            case AdslValueType::BoolList: {
+                AdslSpan<bool> l = v.bools();
+                static_assert(sizeof(bool) == 1, "bool lists are stored as bytes");
+                r.listSize = checkedU32(l.size(), "list items");
+                r.payload  = appendList(lists, l.data(), l.size());
+                break;
+            }
+            case AdslValueType::Int64:  r.payload = static_cast<uint64_t>(v.asInt64()); break;
+            case AdslValueType::Double: {
+                double d = v.asDouble();
+                std::memcpy(&r.payload, &d, 8);
+                break;
+            }
+            case AdslValueType::Int64List: {
+                AdslSpan<std::int64_t> l = v.int64s();
+                r.listSize = checkedU32(l.size(), "list items");
+                r.payload  = appendList(lists, l.data(), l.size());
+                break;
+            }
+            case AdslValueType::DoubleList: {
+                AdslSpan<double> l = v.doubles();
+                r.listSize = checkedU32(l.size(), "list items");
+                r.payload  = appendList(lists, l.data(), l.size());
+                break;
+            }
+            default:
+                throw std::runtime_error("ADSL binary: unknown value type");
+        }
+    }
+
+    const AdslDatabase&                               m_db;
+    std::string                                       m_out;
+    std::vector<std::string_view>                     m_strings;
+    std::unordered_map<std::string_view, uint32_t>    m_ids;
+    mutable std::unordered_map<AdslSymbol, uint32_t>  m_symbolIds;
+};
+
+} // namespace
+
+std::string adsl::serializeBinary(const AdslDatabase& db)
+{
+    if (!hostIsLittleEndian())
+        throw std::runtime_error("ADSL binary: big-endian hosts are not supported");
+    return BinaryWriter(db).run();
+}
+
+bool adsl::saveBinary(const AdslDatabase& db, const std::string& path)
+{
+    std::string bytes = serializeBinary(db);
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    return bool(out);
+}
+
+/* ******************************************************************** */
+/*  ---------------------------- Reader  ------------------------------ */
+/* ******************************************************************** */
+
+struct BinaryDatabase::Impl
+{
+    detail::MappedFile  file;
+    const Header*       header  = nullptr;
+    const uint64_t*     strOffsets = nullptr;
+    const char*         strData = nullptr;
+    size_t              nStrings = 0;
+    const GroupRecord*  groups = nullptr;
+    const EntityRecord* entities = nullptr;
+    const FieldRecord*  fields = nullptr;
+    const uint32_t*     refs = nullptr;
+    const char*         lists = nullptr;
+    const IndexRecord*  typeIndex = nullptr;
+    const IndexRecord*  entityGroupIndex = nullptr;
+    const IndexRecord*  fieldGroupIndex = nullptr;
+    const uint32_t*     indexIds = nullptr;
+
+    std::string_view str(uint32_t id) const
+    {
+        return { strData + strOffsets[id], size_t(strOffsets[id + 1] - strOffsets[id]) };
+    }
+
+    /* strings are sorted : binary search by content */
+    std::optional<uint32_t> findString(std::string_view s) const
+    {
+        size_t lo = 0, hi = nStrings;
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            std::string_view m = str(static_cast<uint32_t>(mid));
+            if (m < s) lo = mid + 1; else hi = mid;
+        }
+        if (lo < nStrings && str(static_cast<uint32_t>(lo)) == s) return static_cast<uint32_t>(lo);
+        return std::nullopt;
+    }
+
+    const IndexRecord* findIndex(const IndexRecord* records, size_t n, std::string_view key) const
+    {
+        auto id = findString(key);
+        if (!id) return nullptr;
+        auto it = std::lower_bound(records, records + n, *id,
+                                   [](const IndexRecord& r, uint32_t k){ return r.key < k; });
+        return (it != records + n && it->key == *id) ? it : nullptr;
+    }
+
+    template<typename T>
+    const T* at(const Section& s) const
+    {
+        return reinterpret_cast<const T*>(file.data() + s.offset);
+    }
+
+    [[noreturn]] static void corrupt(const std::string& what)
+    {
+        throw std::runtime_error("ADSL binary: corrupt file (" + what + ")");
+    }
+
+    void checkSection(const Section& s, size_t elemSize, const char* what) const
+    {
+        if (s.offset % 8 != 0 || s.offset > file.size() ||
+            s.count > (file.size() - s.offset) / elemSize)
+            corrupt(std::string(what) + " section out of bounds");
+    }
+
+    void validate(bool verifyChecksum)
+    {
+        if (file.size() < sizeof(Header)) corrupt("truncated header");
+        header = reinterpret_cast<const Header*>(file.data());
+        if (std::memcmp(header->magic, kMagic, sizeof kMagic) != 0)
+            throw std::runtime_error("ADSL binary: not an .adslb file");
+        if (header->byteOrder != kByteOrder)
+            throw std::runtime_error("ADSL binary: byte order mismatch");
+        if (header->version == 0 || header->version > kBinaryVersion)
+            throw std::runtime_error("ADSL binary: unsupported version " + std::to_string(header->version));
+        if (header->fileSize != file.size()) corrupt("size mismatch");
+        if (verifyChecksum &&
+            detail::hashBytes(file.data() + sizeof(Header), file.size() - sizeof(Header)) != header->checksum)
+            corrupt("checksum mismatch");
+
+        const Header& h = *header;
+        checkSection(h.stringOffsets, 8, "string offsets");
+        checkSection(h.stringData, 1, "string data");
+        checkSection(h.groups, sizeof(GroupRecord), "groups");
+        checkSection(h.entities, sizeof(EntityRecord), "entities");
+        checkSection(h.fields, sizeof(FieldRecord), "fields");
+        checkSection(h.groupRefs, 4, "group references");
+        checkSection(h.lists, 1, "lists");
+        checkSection(h.typeIndex, sizeof(IndexRecord), "type index");
+        checkSection(h.entityGroupIndex, sizeof(IndexRecord), "group index");
+        checkSection(h.fieldGroupIndex, sizeof(IndexRecord), "field index");
+        checkSection(h.indexIds, 4, "index ids");
+        if (h.stringOffsets.count == 0) corrupt("string table");
+
+        strOffsets = at<uint64_t>(h.stringOffsets);
+        strData    = at<char>(h.stringData);
+        nStrings   = size_t(h.stringOffsets.count - 1);
+        groups     = at<GroupRecord>(h.groups);
+        entities   = at<EntityRecord>(h.entities);
+        fields     = at<FieldRecord>(h.fields);
+        refs       = at<uint32_t>(h.groupRefs);
+        lists      = at<char>(h.lists);
+        typeIndex        = at<IndexRecord>(h.typeIndex);
+        entityGroupIndex = at<IndexRecord>(h.entityGroupIndex);
+        fieldGroupIndex  = at<IndexRecord>(h.fieldGroupIndex);
+        indexIds         = at<uint32_t>(h.indexIds);
+
+        /* every id/range stored in a record must stay inside its table, so the
+         * accessors can index without checks */
+        for (size_t i = 0; i < nStrings; ++i)
+            if (strOffsets[i] > strOffsets[i + 1]) corrupt("string offsets");
+        if (strOffsets[nStrings] > h.stringData.count) corrupt("string offsets");
+
+        auto range = [](uint64_t first, uint64_t n, uint64_t total){ return first <= total && n <= total - first; };
+
+        for (size_t i = 0; i < h.groups.count; ++i) {
+            const GroupRecord& g = groups[i];
+            if (g.name >= nStrings || !range(g.firstValue, g.valueCount, h.groupRefs.count)) corrupt("group record");
+        }
+        for (size_t i = 0; i < h.groupRefs.count; ++i)
+            if (refs[i] >= nStrings) corrupt("group reference");
+        for (size_t i = 0; i < h.entities.count; ++i) {
+            const EntityRecord& e = entities[i];
+            if (e.type >= nStrings || !range(e.firstField, e.fieldCount, h.fields.count) ||
+                !range(e.firstGroup, e.groupCount, h.groupRefs.count))
+                corrupt("entity record " + std::to_string(i));
+        }
+        for (size_t i = 0; i < h.fields.count; ++i) {
+            const FieldRecord& f = fields[i];
+            if (f.name >= nStrings || !range(f.firstGroup, f.groupCount, h.groupRefs.count))
+                corrupt("field record " + std::to_string(i));
+            size_t elem = 0;
+            switch (static_cast<AdslValueType>(f.valueType)) {
+                case AdslValueType::String: if (f.payload >= nStrings) corrupt("string value"); continue;
+                case AdslValueType::Int: case AdslValueType::Float: case AdslValueType::Bool:
+                case AdslValueType::Int64: case AdslValueType::Double: continue;
+                case AdslValueType::StringList: elem = 4; break;
+                case AdslValueType::IntList:    elem = 4; break;
+                case AdslValueType::FloatList:  elem = 4; break;
+                case AdslValueType::BoolList:   elem = 1; break;
+                case AdslValueType::Int64List:  elem = 8; break;
+                case AdslValueType::DoubleList: elem = 8; break;
+                default: corrupt("value type");
+            }
+            if (f.payload % 8 != 0 || f.payload > h.lists.count ||
+                f.listSize > (h.lists.count - f.payload) / elem)
+                corrupt("list payload");
+            if (static_cast<AdslValueType>(f.valueType) == AdslValueType::StringList) {
+                const uint32_t* ids = reinterpret_cast<const uint32_t*>(lists + f.payload);
+                for (uint32_t k = 0; k < f.listSize; ++k)
+                    if (ids[k] >= nStrings) corrupt("string list item");
+            }
+        }
+        auto checkIndex = [&](const IndexRecord* recs, size_t n, uint64_t idLimit){
+            for (size_t i = 0; i < n; ++i) {
+                if (recs[i].key >= nStrings || !range(recs[i].first, recs[i].count, h.indexIds.count))
+                    corrupt("index record");
+                for (uint64_t k = 0; k < recs[i].count; ++k)
+                    if (indexIds[recs[i].first + k] >= idLimit) corrupt("index entry");
+            }
+        };
+        checkIndex(typeIndex, h.typeIndex.count, h.entities.count);
+        checkIndex(entityGroupIndex, h.entityGroupIndex.count, h.entities.count);
+        checkIndex(fieldGroupIndex, h.fieldGroupIndex.count, h.fields.count);
+    }
+};
+
+BinaryDatabase::BinaryDatabase() = default;
+BinaryDatabase::~BinaryDatabase() = default;
+BinaryDatabase::BinaryDatabase(BinaryDatabase&&) noexcept = default;
+BinaryDatabase& BinaryDatabase::operator=(BinaryDatabase&&) noexcept = default;
+
+bool BinaryDatabase::open(const std::string& path, bool verifyChecksum)
+{
+    close();
+    auto impl = std::make_unique<Impl>();
+    if (!impl->file.open(path)) return false;
+    impl->validate(verifyChecksum);
+    m_impl = std::move(impl);
+    return true;
+}
+
+void BinaryDatabase::close()                    { m_impl.reset(); }
+bool BinaryDatabase::isOpen() const             { return m_impl != nullptr; }
+size_t BinaryDatabase::entityCount() const      { return m_impl ? size_t(m_impl->header->entities.count) : 0; }
+size_t BinaryDatabase::fieldCount() const       { return m_impl ? size_t(m_impl->header->fields.count) : 0; }
+size_t BinaryDatabase::groupCount() const       { return m_impl ? size_t(m_impl->header->groups.count) : 0; }
+
+std::string_view BinaryDatabase::groupName(size_t i) const
+{
+    return m_impl->str(m_impl->groups[i].name);
+}
+
+std::vector<std::string_view> BinaryDatabase::groupValues(size_t i) const
+{
+    const GroupRecord& g = m_impl->groups[i];
+    std::vector<std::string_view> res;
+    res.reserve(g.valueCount);
+    for (uint32_t k = 0; k < g.valueCount; ++k)
+        res.push_back(m_impl->str(m_impl->refs[g.firstValue + k]));
+    return res;
+}
+
+std::vector<BinaryEntity> BinaryDatabase::findEntitiesByType(std::string_view type) const
+{
+    std::vector<BinaryEntity> res;
+    if (!m_impl) return res;
+    const IndexRecord* r = m_impl->findIndex(m_impl->typeIndex, size_t(m_impl->header->typeIndex.count), type);
+    if (!r) return res;
+    res.reserve(r->count);
+    for (uint32_t k = 0; k < r->count; ++k) res.push_back(entity(m_impl->indexIds[r->first + k]));
+    return res;
+}
+
+std::vector<BinaryEntity> BinaryDatabase::findEntitiesByGroup(std::string_view group) const
+{
+    std::vector<BinaryEntity> res;
+    if (!m_impl) return res;
+    const IndexRecord* r = m_impl->findIndex(m_impl->entityGroupIndex, size_t(m_impl->header->entityGroupIndex.count), group);
+    if (!r) return res;
+    res.reserve(r->count);
+    for (uint32_t k = 0; k < r->count; ++k) res.push_back(entity(m_impl->indexIds[r->first + k]));
+    return res;
+}
+
+std::vector<BinaryField> BinaryDatabase::findFieldsByGroup(std::string_view group) const
+{
+    std::vector<BinaryField> res;
+    if (!m_impl) return res;
+    const IndexRecord* r = m_impl->findIndex(m_impl->fieldGroupIndex, size_t(m_impl->header->fieldGroupIndex.count), group);
+    if (!r) return res;
+    res.reserve(r->count);
+    for (uint32_t k = 0; k < r->count; ++k) res.push_back(field(m_impl->indexIds[r->first + k]));
+    return res;
+}
+
+void BinaryDatabase::toDatabase(AdslDatabase& db) const
+{
+    db.clear();
+    if (!m_impl) return;
+    const Impl& im = *m_impl;
+
+    /* names repeat a lot : intern each string id once */
+    std::vector<AdslSymbol> symbols(im.nStrings);
+    std::vector<bool>       interned(im.nStrings, false);
+    auto sym = [&](uint32_t id) {
+        if (!interned[id]) { symbols[id] = AdslSymbol(im.str(id)); interned[id] = true; }
+        return symbols[id];
+    };
+
+    for (size_t i = 0; i < groupCount(); ++i) {
+        AdslGroup g;
+        g.name = std::string(groupName(i));
+        for (auto v : groupValues(i)) g.values.emplace_back(v);
+        std::string name = g.name;
+        db.groups[name] = std::move(g);
+    }
+
+    db.entities.resize(entityCount());
+    for (size_t i = 0; i < db.entities.size(); ++i)
+    {
+        const EntityRecord& er = im.entities[i];
+        AdslEntity& e = db.entities[i];
+        e.type = sym(er.type);
+        e.groups.reserve(er.groupCount);
+        for (uint32_t k = 0; k < er.groupCount; ++k) e.groups.push_back(sym(im.refs[er.firstGroup + k]));
+        e.fields.resize(er.fieldCount);
+        for (uint32_t k = 0; k < er.fieldCount; ++k)
+        {
+            const FieldRecord& fr = im.fields[er.firstField + k];
+            AdslField& f = e.fields[k];
+            f.name = sym(fr.name);
+            f.groups.reserve(fr.groupCount);
+            for (uint32_t g = 0; g < fr.groupCount; ++g) f.groups.push_back(sym(im.refs[fr.firstGroup + g]));
+            f.value = field(er.firstField + k).value();
+        }
+    }
+    db.reindex();
+}
+
+bool adsl::loadBinary(const std::string& path, AdslDatabase& db)
+{
+    BinaryDatabase bin;
+    if (!bin.open(path)) return false;
+    bin.toDatabase(db);
+    return true;
+}
+
+/* ----------------------------- handles ------------------------------ */
+
+std::string_view BinaryEntity::type() const
+{
+    return m_db->m_impl->str(m_db->m_impl->entities[m_index].type);
+}
+
+size_t BinaryEntity::fieldCount() const
+{
+    return m_db->m_impl->entities[m_index].fieldCount;
+}
+
+BinaryField BinaryEntity::field(size_t i) const
+{
+    return BinaryField(m_db, m_db->m_impl->entities[m_index].firstField + i);
+}
+
+std::optional<BinaryField> BinaryEntity::field(std::string_view name) const
+{
+    const auto& im = *m_db->m_impl;
+    const EntityRecord& e = im.entities[m_index];
+    auto id = im.findString(name);
+    if (!id) return std::nullopt;
+    for (uint32_t k = 0; k < e.fieldCount; ++k)
+        if (im.fields[e.firstField + k].name == *id) return BinaryField(m_db, e.firstField + k);
+    return std::nullopt;
+}
+
+size_t BinaryEntity::groupCount() const
+{
+    return m_db->m_impl->entities[m_index].groupCount;
+}
+
+std::string_view BinaryEntity::group(size_t i) const
+{
+    const auto& im = *m_db->m_impl;
+    return im.str(im.refs[im.entities[m_index].firstGroup + i]);
+}
+
+bool BinaryEntity::hasGroup(std::string_view g) const
+{
+    for (size_t i = 0; i < groupCount(); ++i)
+        if (group(i) == g) return true;
+    return false;
+}
+
+std::string_view BinaryField::name() const
+{
+    return m_db->m_impl->str(m_db->m_impl->fields[m_index].name);
+}
+
+AdslValueType BinaryField::type() const
+{
+    return static_cast<AdslValueType>(m_db->m_impl->fields[m_index].valueType);
+}
+
+size_t BinaryField::groupCount() const
+{
+    return m_db->m_impl->fields[m_index].groupCount;
+}
+
+std::string_view BinaryField::group(size_t i) const
+{
+    const auto& im = *m_db->m_impl;
+    return im.str(im.refs[im.fields[m_index].firstGroup + i]);
+}
+
+bool BinaryField::hasGroup(std::string_view g) const
+{
+    for (size_t i = 0; i < groupCount(); ++i)
+        if (group(i) == g) return true;
+    return false;
+}
+
+int BinaryField::asInt() const
+{
+    return static_cast<int>(static_cast<int64_t>(m_db->m_impl->fields[m_index].payload));
+}
+
+float BinaryField::asFloat() const
+{
+    uint32_t bits = static_cast<uint32_t>(m_db->m_impl->fields[m_index].payload);
+    float f;
+    std::memcpy(&f, &bits, 4);
+    return f;
+}
+
+bool BinaryField::asBool() const
+{
+    return m_db->m_impl->fields[m_index].payload != 0;
+}
+
+std::int64_t BinaryField::asInt64() const
+{
+    return static_cast<int64_t>(m_db->m_impl->fields[m_index].payload);
+}
+
+double BinaryField::asDouble() const
+{
+    double d;
+    std::memcpy(&d, &m_db->m_impl->fields[m_index].payload, 8);
+    return d;
+}
+
+std::string_view BinaryField::asString() const
+{
+    return m_db->m_impl->str(static_cast<uint32_t>(m_db->m_impl->fields[m_index].payload));
+}
+
+size_t BinaryField::listSize() const
+{
+    return m_db->m_impl->fields[m_index].listSize;
+}
+
+std::string_view BinaryField::stringAt(size_t i) const
+{
+    const auto& im = *m_db->m_impl;
+    const uint32_t* ids = reinterpret_cast<const uint32_t*>(im.lists + im.fields[m_index].payload);
+    return im.str(ids[i]);
+}
+
+const int32_t* BinaryField::intData() const
+{
+    return reinterpret_cast<const int32_t*>(m_db->m_impl->lists + m_db->m_impl->fields[m_index].payload);
+}
+
+const float* BinaryField::floatData() const
+{
+    return reinterpret_cast<const float*>(m_db->m_impl->lists + m_db->m_impl->fields[m_index].payload);
+}
+
+const uint8_t* BinaryField::boolData() const
+{
+    return reinterpret_cast<const uint8_t*>(m_db->m_impl->lists + m_db->m_impl->fields[m_index].payload);
+}
+
+const std::int64_t* BinaryField::int64Data() const
+{
+    return reinterpret_cast<const std::int64_t*>(m_db->m_impl->lists + m_db->m_impl->fields[m_index].payload);
+}
+
+const double* BinaryField::doubleData() const
+{
+    return reinterpret_cast<const double*>(m_db->m_impl->lists + m_db->m_impl->fields[m_index].payload);
+}
+
+AdslValue BinaryField::value() const
+{
+    switch (type())
+    {
+        case AdslValueType::String: return asString();
+        case AdslValueType::Int:    return asInt();
+        case AdslValueType::Float:  return asFloat();
+        case AdslValueType::Bool:   return asBool();
+        case AdslValueType::StringList: {
+            std::vector<std::string_view> out;
+            out.reserve(listSize());
+            for (size_t i = 0; i < listSize(); ++i) out.push_back(stringAt(i));
+            return AdslSpan<std::string_view>(out.data(), out.size());
+        }
+        case AdslValueType::IntList:   return AdslSpan<int>(intData(), listSize());
+        case AdslValueType::FloatList: return AdslSpan<float>(floatData(), listSize());
+        case AdslValueType::BoolList:  return std::vector<bool>(boolData(), boolData() + listSize());   // bytes to bool
+        case AdslValueType::Int64:     return asInt64();
+        case AdslValueType::Double:    return asDouble();
+        case AdslValueType::Int64List:  return AdslSpan<std::int64_t>(int64Data(), listSize());
+        case AdslValueType::DoubleList: return AdslSpan<double>(doubleData(), listSize());
+        default: break;
+    }
+    throw std::runtime_error("ADSL binary: unknown value type");
+}
@@ -0,0 +1,423 @@
+#include "../include/adsl/adsl_columns.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+using namespace adsl;
+
+namespace {
+
+    constexpr std::size_t kBlock = 64;                  // rows per bitmap word
+    constexpr std::size_t kLanes = 8;                   // independent accumulators per block
+
+    std::size_t wordsFor(std::size_t rows) { return (rows + kBlock - 1) / kBlock; }
+
+    std::size_t popcount(std::uint64_t x)
+    {
+#if defined(_MSC_VER)
+        return static_cast<std::size_t>(__popcnt64(x));
+#else
+        return static_cast<std::size_t>(__builtin_popcountll(x));
+#endif
+    }
+
+    std::size_t lowestBit(std::uint64_t x)
+    {
+#if defined(_MSC_VER)
+        unsigned long i;
+        _BitScanForward64(&i, x);
+        return i;
+#else
+        return static_cast<std::size_t>(__builtin_ctzll(x));
+#endif
+    }
+
+    /* 64 bytes holding 0/1 -> one bit per byte (byte j -> bit j) */
+    std::uint64_t packBytes(const std::uint8_t* hit)
+    {
+        std::uint64_t bits = 0;
+        for (std::size_t k = 0; k < kBlock / 8; ++k) {
+            std::uint64_t x;
+            std::memcpy(&x, hit + k * 8, 8);
+            bits |= ((x * 0x0102040810204080ull) >> 56) << (k * 8);
+        }
+        return bits;
+    }
+
+    /* Comparisons run in the column's own precision for floats (so 'price == 0.1'
+     * matches values parsed from "0.1"), and in double for the other types (exact
+     * for ints and bools, and for int64 up to 2^53). */
+    template<typename T>
+    using CmpType = std::conditional_t<std::is_same_v<T, float>, float, double>;
+
+    template<typename T, typename Cmp>
+    std::uint64_t matchBlock(const T* v, CmpType<T> x, Cmp cmp)
+    {
+        alignas(16) std::uint8_t hit[kBlock];
+        for (std::size_t j = 0; j < kBlock; ++j)
+            hit[j] = cmp(static_cast<CmpType<T>>(v[j]), x) ? 1 : 0;
+        return packBytes(hit);
+    }
+
+    /* Calls out(word index, matching bits) for every block */
+    template<typename T, typename Out>
+    void matchAll(const T* v, std::size_t words, const std::uint64_t* valid, CmpOp op, double value, Out out)
+    {
+        const CmpType<T> x = static_cast<CmpType<T>>(value);
+        auto run = [&](auto cmp) {
+            for (std::size_t w = 0; w < words; ++w)
+                out(w, valid[w] ? matchBlock(v + w * kBlock, x, cmp) & valid[w] : 0);
+        };
+        switch (op) {
+            case CmpOp::Eq: run([](auto a, auto b){ return a == b; }); break;
+            case CmpOp::Ne: run([](auto a, auto b){ return a != b; }); break;
+            case CmpOp::Lt: run([](auto a, auto b){ return a <  b; }); break;
+            case CmpOp::Le: run([](auto a, auto b){ return a <= b; }); break;
+            case CmpOp::Gt: run([](auto a, auto b){ return a >  b; }); break;
+            case CmpOp::Ge: run([](auto a, auto b){ return a >= b; }); break;
+        }
+    }
+
+    template<typename T>
+    Aggregate aggregateAll(const T* v, std::size_t words, const std::uint64_t* valid, const std::uint64_t* where)
+    {
+        using Acc = std::conditional_t<std::is_integral_v<T> && sizeof(T) < 8, std::int64_t, double>;
+
+        Aggregate r;
+        Acc sum = 0;
+        T lo = std::numeric_limits<T>::max();
+        T hi = std::numeric_limits<T>::lowest();
+
+        for (std::size_t w = 0; w < words; ++w)
+        {
+            std::uint64_t m = valid[w] & (where ? where[w] : ~std::uint64_t(0));
+            if (!m) continue;
+            const T* b = v + w * kBlock;
+            r.count += popcount(m);
+
+            if (m == ~std::uint64_t(0))
+            {
+                /* full block : lane-wise accumulators, no cross-lane dependency */
+                Acc s[kLanes] = {};
+                T   l[kLanes], h[kLanes];
+                for (std::size_t k = 0; k < kLanes; ++k) { l[k] = b[k]; h[k] = b[k]; }
+                for (std::size_t j = 0; j < kBlock; j += kLanes)
+                    for (std::size_t k = 0; k < kLanes; ++k) {
+                        T x = b[j + k];
+                        s[k] += x;
+                        l[k] = x < l[k] ? x : l[k];
+                        h[k] = x > h[k] ? x : h[k];
+                    }
+                for (std::size_t k = 0; k < kLanes; ++k) {
+                    sum += s[k];
+                    lo = std::min(lo, l[k]);
+                    hi = std::max(hi, h[k]);
+                }
+            }
+            else
+            {
+                for (; m; m &= m - 1) {
+                    T x = b[lowestBit(m)];
+                    sum += x;
+                    lo = std::min(lo, x);
+                    hi = std::max(hi, x);
+                }
+            }
+        }
+
+        if (r.count) {
+            r.sum = static_cast<double>(sum);
+            r.min = static_cast<double>(lo);
+            r.max = static_cast<double>(hi);
+        }
+        return r;
+    }
+
+    /* Scalar alternatives only : lists are not projected */
+    AdslValueType scalarType(const AdslValue& v)
+    {
+        switch (v.type()) {
+            case AdslValueType::String: case AdslValueType::Int:   case AdslValueType::Float:
+            case AdslValueType::Bool:   case AdslValueType::Int64: case AdslValueType::Double:
+                return v.type();
+            default:
+                return AdslValueType::Unknown;
+        }
+    }
+}
+
+/* ******************************************************************** */
+/*  ------------------------------ RowMask ---------------------------- */
+/* ******************************************************************** */
+
+RowMask::RowMask(std::size_t rows, bool value)
+    : m_bits(wordsFor(rows), value ? ~std::uint64_t(0) : 0), m_rows(rows)
+{
+    if (value && (rows % kBlock))
+        m_bits.back() = (std::uint64_t(1) << (rows % kBlock)) - 1;
+}
+
+std::size_t RowMask::count() const
+{
+    std::size_t n = 0;
+    for (std::uint64_t w : m_bits) n += popcount(w);
+    return n;
+}
+
+void RowMask::set(std::size_t row, bool value)
+{
+    std::uint64_t bit = std::uint64_t(1) << (row & 63);
+    if (value) m_bits[row >> 6] |= bit;
+    else       m_bits[row >> 6] &= ~bit;
+}
+
+RowMask& RowMask::operator&=(const RowMask& other)
+{
+    if (other.m_rows != m_rows) throw std::runtime_error("RowMask: row count mismatch");
+    for (std::size_t i = 0; i < m_bits.size(); ++i) m_bits[i] &= other.m_bits[i];
+    return *this;
+}
+
+RowMask& RowMask::operator|=(const RowMask& other)
+{
+    if (other.m_rows != m_rows) throw std::runtime_error("RowMask: row count mismatch");
+    for (std::size_t i = 0; i < m_bits.size(); ++i) m_bits[i] |= other.m_bits[i];
+    return *this;
+}
+
+RowMask RowMask::operator~() const
+{
+    RowMask r(m_rows, true);
+    for (std::size_t i = 0; i < m_bits.size(); ++i) r.m_bits[i] &= ~m_bits[i];
+    return r;
+}
+
+/* ******************************************************************** */
+/*  ------------------------------ Column ----------------------------- */
+/* ******************************************************************** */
+
+std::string_view Column::stringAt(std::size_t row) const
+{
+    if (m_type != AdslValueType::String) return {};
+    return std::string_view(m_blob).substr(m_offsets[row], m_offsets[row + 1] - m_offsets[row]);
+}
+
+double Column::valueAt(std::size_t row) const
+{
+    switch (m_type) {
+        case AdslValueType::Int:   return m_ints[row];
+        case AdslValueType::Float: return m_floats[row];
+        case AdslValueType::Bool:  return m_bools[row];
+        case AdslValueType::Int64:  return static_cast<double>(m_int64s[row]);
+        case AdslValueType::Double: return m_doubles[row];
+        default:                   return 0;
+    }
+}
+
+Aggregate Column::aggregate(const RowMask* where) const
+{
+    if (where && where->rows() != m_rows) throw std::runtime_error("Column: row mask from another projection");
+    const std::uint64_t* w = where ? where->words() : nullptr;
+    std::size_t words = wordsFor(m_rows);
+
+    switch (m_type) {
+        case AdslValueType::Int:     return aggregateAll(m_ints.data(),   words, m_valid.words(), w);
+        case AdslValueType::Float:   return aggregateAll(m_floats.data(), words, m_valid.words(), w);
+        case AdslValueType::Bool:    return aggregateAll(m_bools.data(),  words, m_valid.words(), w);
+        case AdslValueType::Int64:   return aggregateAll(m_int64s.data(), words, m_valid.words(), w);
+        case AdslValueType::Double:  return aggregateAll(m_doubles.data(), words, m_valid.words(), w);
+        case AdslValueType::String:  throw std::runtime_error("Column '" + m_name.str() + "': cannot aggregate strings");
+        default:                     return Aggregate{};
+    }
+}
+
+std::optional<double> Column::min(const RowMask* where) const
+{
+    Aggregate a = aggregate(where);
+    if (!a.count) return std::nullopt;
+    return a.min;
+}
+
+std::optional<double> Column::max(const RowMask* where) const
+{
+    Aggregate a = aggregate(where);
+    if (!a.count) return std::nullopt;
+    return a.max;
+}
+
+RowMask Column::filter(CmpOp op, double value) const
+{
+    RowMask r(m_rows, false);
+    auto out = [&r](std::size_t w, std::uint64_t bits){ r.m_bits[w] = bits; };
+    std::size_t words = wordsFor(m_rows);
+
+    switch (m_type) {
+        case AdslValueType::Int:    matchAll(m_ints.data(),   words, m_valid.words(), op, value, out); break;
+        case AdslValueType::Float:  matchAll(m_floats.data(), words, m_valid.words(), op, value, out); break;
+        case AdslValueType::Bool:   matchAll(m_bools.data(),  words, m_valid.words(), op, value, out); break;
+        case AdslValueType::Int64:  matchAll(m_int64s.data(), words, m_valid.words(), op, value, out); break;
+        case AdslValueType::Double: matchAll(m_doubles.data(), words, m_valid.words(), op, value, out); break;
+        case AdslValueType::String: throw std::runtime_error("Column '" + m_name.str() + "': numeric filter on strings");
+        default:                    break;
+    }
+    return r;
+}
+
+std::size_t Column::countWhere(CmpOp op, double value) const
+{
+    std::size_t n = 0;
+    auto out = [&n](std::size_t, std::uint64_t bits){ n += popcount(bits); };
+    std::size_t words = wordsFor(m_rows);
+
+    switch (m_type) {
+        case AdslValueType::Int:    matchAll(m_ints.data(),   words, m_valid.words(), op, value, out); break;
+        case AdslValueType::Float:  matchAll(m_floats.data(), words, m_valid.words(), op, value, out); break;
+        case AdslValueType::Bool:   matchAll(m_bools.data(),  words, m_valid.words(), op, value, out); break;
+        case AdslValueType::Int64:  matchAll(m_int64s.data(), words, m_valid.words(), op, value, out); break;
+        case AdslValueType::Double: matchAll(m_doubles.data(), words, m_valid.words(), op, value, out); break;
+        case AdslValueType::String: throw std::runtime_error("Column '" + m_name.str() + "': numeric filter on strings");
+        default:                    break;
+    }
+    return n;
+}
+
+RowMask Column::filter(CmpOp op, std::string_view value) const
+{
+    if (m_type != AdslValueType::String && m_type != AdslValueType::Unknown)
+        throw std::runtime_error("Column '" + m_name.str() + "': string filter on a non-string column");
+
+    RowMask r(m_rows, false);
+    if (m_type == AdslValueType::Unknown) return r;
+
+    for (std::size_t row = 0; row < m_rows; ++row)
+    {
+        if (isNull(row)) continue;
+        int c = stringAt(row).compare(value);
+        bool hit = false;
+        switch (op) {
+            case CmpOp::Eq: hit = c == 0; break;
+            case CmpOp::Ne: hit = c != 0; break;
+            case CmpOp::Lt: hit = c <  0; break;
+            case CmpOp::Le: hit = c <= 0; break;
+            case CmpOp::Gt: hit = c >  0; break;
+            case CmpOp::Ge: hit = c >= 0; break;
+        }
+        if (hit) r.set(row, true);
+    }
+    return r;
+}
+
+/* ******************************************************************** */
+/*  ---------------------------- Projection --------------------------- */
+/* ******************************************************************** */
+
+const Column* Projection::column(std::string_view name) const
+{
+    for (const Column& c : m_columns)
+        if (c.m_name == name) return &c;
+    return nullptr;
+}
+
+Projection Projection::build(const AdslDatabase& db, std::string_view type,
+                             const std::vector<std::string>& fields)
+{
+    Projection p;
+    p.m_db      = &db;
+    p.m_version = db.version();
+    p.m_type    = AdslSymbol(type);
+
+    for (const AdslEntity* e : db.findEntitiesByType(std::string(type)))
+        p.m_rows.push_back(db.indexOf(*e));
+    const std::size_t rows = p.m_rows.size();
+
+    /* column names : as requested, or every name in first-seen order */
+    std::vector<AdslSymbol> names(fields.begin(), fields.end());
+    std::vector<int> slotOf;                            // name id -> column, -1 if not projected
+    auto slot = [&slotOf](AdslSymbol s) -> int& {
+        if (s.id() >= slotOf.size()) slotOf.resize(s.id() + 1, -1);
+        return slotOf[s.id()];
+    };
+    if (names.empty()) {
+        for (std::size_t row : p.m_rows)
+            for (const AdslField& f : db.entities[row].fields)
+                if (!f.removed() && slot(f.name) < 0) { slot(f.name) = int(names.size()); names.push_back(f.name); }
+    } else {
+        for (std::size_t i = 0; i < names.size(); ++i)
+            if (slot(names[i]) < 0) slot(names[i]) = int(i);
+    }
+
+    p.m_columns.resize(names.size());
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        Column& c = p.m_columns[i];
+        c.m_name  = names[i];
+        c.m_rows  = rows;
+        c.m_valid = RowMask(rows, false);
+    }
+
+    const std::size_t padded = wordsFor(rows) * kBlock;
+    for (std::size_t row = 0; row < rows; ++row)
+    {
+        for (const AdslField& f : db.entities[p.m_rows[row]].fields)
+        {
+            if (f.removed() || f.name.id() >= slotOf.size() || slotOf[f.name.id()] < 0) continue;
+            Column& c = p.m_columns[slotOf[f.name.id()]];
+            if (c.m_valid.test(row)) continue;          // duplicate name : first one wins
+
+            const AdslValue& v = f.get();
+            AdslValueType t = scalarType(v);
+            if (t == AdslValueType::Unknown) continue;
+            if (c.m_type == AdslValueType::Unknown)
+            {
+                c.m_type = t;
+                switch (t) {
+                    case AdslValueType::Int:    c.m_ints.assign(padded, 0);    break;
+                    case AdslValueType::Float:  c.m_floats.assign(padded, 0);  break;
+                    case AdslValueType::Bool:   c.m_bools.assign(padded, 0);   break;
+                    case AdslValueType::Int64:  c.m_int64s.assign(padded, 0);  break;
+                    case AdslValueType::Double: c.m_doubles.assign(padded, 0); break;
+                    default:                    c.m_offsets.assign(rows + 1, 0); break;
+                }
+            }
+            /* the parser keeps numbers in their narrowest type : widen, exactly */
+            if (c.m_type == AdslValueType::Int && t == AdslValueType::Int64) {
+                c.m_int64s.assign(c.m_ints.begin(), c.m_ints.end());
+                c.m_ints = {};
+                c.m_type = t;
+            }
+            if (c.m_type == AdslValueType::Float && t == AdslValueType::Double) {
+                c.m_doubles.assign(c.m_floats.begin(), c.m_floats.end());
+                c.m_floats = {};
+                c.m_type = t;
+            }
+
+            switch (c.m_type) {
+                case AdslValueType::Int:    if (t != c.m_type) continue; c.m_ints[row]   = v.asInt();   break;
+                case AdslValueType::Float:  if (t != c.m_type) continue; c.m_floats[row] = v.asFloat(); break;
+                case AdslValueType::Bool:   if (t != c.m_type) continue; c.m_bools[row]  = v.asBool();  break;
+                case AdslValueType::Int64:
+                    if      (t == AdslValueType::Int64) c.m_int64s[row] = v.asInt64();
+                    else if (t == AdslValueType::Int)   c.m_int64s[row] = v.asInt();
+                    else continue;
+                    break;
+                case AdslValueType::Double:
+                    if      (t == AdslValueType::Double) c.m_doubles[row] = v.asDouble();
+                    else if (t == AdslValueType::Float)  c.m_doubles[row] = v.asFloat();
+                    else continue;
+                    break;
+                default:                    if (t != c.m_type) continue; c.m_blob += v.asString(); break;
+            }
+            c.m_valid.set(row, true);
+        }
+
+        for (Column& c : p.m_columns)
+            if (c.m_type == AdslValueType::String) c.m_offsets[row + 1] = c.m_blob.size();
+    }
+    return p;
+}
@@ -0,0 +1,577 @@
+#include "../include/adsl/adsl_groups.hpp"
+#include "adsl_scan.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #include <immintrin.h>
+    #define ADSL_GROUPS_X86 1
+    #if defined(__GNUC__) || defined(__clang__)
+        #define ADSL_TARGET_AVX2 __attribute__((target("avx2")))
+    #else
+        #define ADSL_TARGET_AVX2
+    #endif
+#endif
+
+using namespace adsl;
+using namespace adsl::detail;
+
+struct adsl::detail::IdSetAccess
+{
+    using Chunks = std::vector<AdslIdSet::Chunk>;
+    static const Chunks& chunks(const AdslIdSet& s) { return s.m_chunks; }
+};
+
+namespace {
+
+    constexpr std::size_t kWords = AdslIdSet::kChunkWords;
+    constexpr std::size_t kChunk = std::size_t(1) << AdslIdSet::kChunkBits;
+
+    std::size_t popcount(std::uint64_t x)
+    {
+#if defined(_MSC_VER)
+        return static_cast<std::size_t>(__popcnt64(x));
+#else
+        return static_cast<std::size_t>(__builtin_popcountll(x));
+#endif
+    }
+
+    /* calls fn(offset) for every bit set in words[0..n) */
+    template<typename Fn>
+    void forEachBit(const std::uint64_t* words, std::size_t n, Fn fn)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+            for (std::uint64_t w = words[i]; w; w &= w - 1)
+                fn(i * 64 + lowestBit(w));
+    }
+}
+
+/* ******************************************************************** */
+/*  ---------------------------- AdslIdSet ---------------------------- */
+/* ******************************************************************** */
+
+AdslIdSet::Chunk* AdslIdSet::find(std::uint32_t key)
+{
+    auto it = std::lower_bound(m_chunks.begin(), m_chunks.end(), key,
+                               [](const Chunk& c, std::uint32_t k){ return c.key < k; });
+    return it != m_chunks.end() && it->key == key ? &*it : nullptr;
+}
+
+const AdslIdSet::Chunk* AdslIdSet::find(std::uint32_t key) const
+{
+    return const_cast<AdslIdSet*>(this)->find(key);
+}
+
+std::size_t AdslIdSet::count() const
+{
+    std::size_t n = 0;
+    for (const Chunk& c : m_chunks) n += c.count;
+    return n;
+}
+
+bool AdslIdSet::contains(std::size_t id) const
+{
+    const Chunk* c = find(std::uint32_t(id >> kChunkBits));
+    if (!c) return false;
+    const auto low = std::uint16_t(id);
+    if (!c->bits.empty()) return (c->bits[low >> 6] >> (low & 63)) & 1;
+    return std::binary_search(c->array.begin(), c->array.end(), low);
+}
+
+void AdslIdSet::insert(std::size_t id)
+{
+    const auto key = std::uint32_t(id >> kChunkBits);
+    const auto low = std::uint16_t(id);
+
+    /* ascending inserts : the last chunk, or a new one after it */
+    if (m_chunks.empty() || m_chunks.back().key < key) {
+        m_chunks.emplace_back();
+        m_chunks.back().key = key;
+    }
+    Chunk* c = m_chunks.back().key == key ? &m_chunks.back() : find(key);
+    if (!c) {
+        auto it = std::lower_bound(m_chunks.begin(), m_chunks.end(), key,
+                                   [](const Chunk& x, std::uint32_t k){ return x.key < k; });
+        c = &*m_chunks.emplace(it);
+        c->key = key;
+    }
+
+    if (!c->bits.empty()) {
+        std::uint64_t& w = c->bits[low >> 6];
+        const std::uint64_t bit = std::uint64_t(1) << (low & 63);
+        if (!(w & bit)) { w |= bit; ++c->count; }
+        return;
+    }
+
+    std::vector<std::uint16_t>& a = c->array;
+    if (a.empty() || a.back() < low) a.push_back(low);
+    else {
+        auto it = std::lower_bound(a.begin(), a.end(), low);
+        if (*it == low) return;
+        a.insert(it, low);
+    }
+    if (++c->count > kArrayMax) {
+        c->bits.assign(kWords, 0);
+        for (std::uint16_t x : a) c->bits[x >> 6] |= std::uint64_t(1) << (x & 63);
+        std::vector<std::uint16_t>().swap(a);
+    }
+}
+
+void AdslIdSet::erase(std::size_t id)
+{
+    Chunk* c = find(std::uint32_t(id >> kChunkBits));
+    if (!c) return;
+    const auto low = std::uint16_t(id);
+
+    if (!c->bits.empty()) {
+        std::uint64_t& w = c->bits[low >> 6];
+        const std::uint64_t bit = std::uint64_t(1) << (low & 63);
+        if (!(w & bit)) return;
+        w &= ~bit;
+        /* back to an array well below kArrayMax, so a count hovering there does not flip-flop */
+        if (--c->count < kArrayMax / 2) {
+            c->array.reserve(c->count);
+            forEachBit(c->bits.data(), kWords, [c](std::size_t x){ c->array.push_back(std::uint16_t(x)); });
+            std::vector<std::uint64_t>().swap(c->bits);
+        }
+    } else {
+        auto it = std::lower_bound(c->array.begin(), c->array.end(), low);
+        if (it == c->array.end() || *it != low) return;
+        c->array.erase(it);
+        --c->count;
+    }
+    if (c->count == 0) m_chunks.erase(m_chunks.begin() + (c - m_chunks.data()));
+}
+
+std::vector<std::size_t> AdslIdSet::ids() const
+{
+    std::vector<std::size_t> res;
+    res.reserve(count());
+    for (const Chunk& c : m_chunks) {
+        const std::size_t base = std::size_t(c.key) << kChunkBits;
+        if (c.bits.empty())
+            for (std::uint16_t x : c.array) res.push_back(base + x);
+        else
+            forEachBit(c.bits.data(), kWords, [&](std::size_t x){ res.push_back(base + x); });
+    }
+    return res;
+}
+
+std::size_t AdslIdSet::memoryBytes() const
+{
+    std::size_t n = m_chunks.capacity() * sizeof(Chunk);
+    for (const Chunk& c : m_chunks)
+        n += c.array.capacity() * sizeof(std::uint16_t) + c.bits.capacity() * sizeof(std::uint64_t);
+    return n;
+}
+
+/* ******************************************************************** */
+/*  --------------------------- Word kernels -------------------------- */
+/* ******************************************************************** */
+
+namespace {
+
+    /* One chunk (kWords words) at a time; 'out' may be one of the inputs */
+    struct Kernels
+    {
+        void        (*andWords)   (std::uint64_t* out, const std::uint64_t* a, const std::uint64_t* b);
+        void        (*orWords)    (std::uint64_t* out, const std::uint64_t* a, const std::uint64_t* b);
+        void        (*andNotWords)(std::uint64_t* out, const std::uint64_t* a, const std::uint64_t* b);  // a & ~b
+        void        (*notWords)   (std::uint64_t* out, const std::uint64_t* a);
+        std::size_t (*countWords) (const std::uint64_t* a);
+    };
+
+    void andScalar(std::uint64_t* out, const std::uint64_t* a, const std::uint64_t* b)
+    {
+        for (std::size_t i = 0; i < kWords; ++i) out[i] = a[i] & b[i];
+    }
+    void orScalar(std::uint64_t* out, const std::uint64_t* a, const std::uint64_t* b)
+    {
+        for (std::size_t i = 0; i < kWords; ++i) out[i] = a[i] | b[i];
+    }
+    void andNotScalar(std::uint64_t* out, const std::uint64_t* a, const std::uint64_t* b)
+    {
+        for (std::size_t i = 0; i < kWords; ++i) out[i] = a[i] & ~b[i];
+    }
+    void notScalar(std::uint64_t* out, const std::uint64_t* a)
+    {
+        for (std::size_t i = 0; i < kWords; ++i) out[i] = ~a[i];
+    }
+    std::size_t countScalar(const std::uint64_t* a)
+    {
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < kWords; ++i) n += popcount(a[i]);
+        return n;
+    }
+
+    const Kernels kScalar{ andScalar, orScalar, andNotScalar, notScalar, countScalar };
+
+#ifdef ADSL_GROUPS_X86
+
+    ADSL_TARGET_AVX2 inline __m256i load(const std::uint64_t* p)  { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+
+    ADSL_TARGET_AVX2 void andAVX2(std::uint64_t* out, const std::uint64_t* a, const std::uint64_t* b)
+    {
+        for (std::size_t i = 0; i < kWords; i += 4)
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_and_si256(load(a + i), load(b + i)));
+    }
+    ADSL_TARGET_AVX2 void orAVX2(std::uint64_t* out, const std::uint64_t* a, const std::uint64_t* b)
+    {
+        for (std::size_t i = 0; i < kWords; i += 4)
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_or_si256(load(a + i), load(b + i)));
+    }
+    ADSL_TARGET_AVX2 void andNotAVX2(std::uint64_t* out, const std::uint64_t* a, const std::uint64_t* b)
+    {
+        for (std::size_t i = 0; i < kWords; i += 4)
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_andnot_si256(load(b + i), load(a + i)));
+    }
+    ADSL_TARGET_AVX2 void notAVX2(std::uint64_t* out, const std::uint64_t* a)
+    {
+        const __m256i ones = _mm256_set1_epi32(-1);
+        for (std::size_t i = 0; i < kWords; i += 4)
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_xor_si256(load(a + i), ones));
+    }
+
+    /* Bits per nibble through a 16-entry table (pshufb), summed per 64-bit lane by psadbw */
+    ADSL_TARGET_AVX2 std::size_t countAVX2(const std::uint64_t* a)
+    {
+        const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                               0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m256i nibble = _mm256_set1_epi8(0x0f);
+        __m256i sum = _mm256_setzero_si256();
+        for (std::size_t i = 0; i < kWords; i += 4) {
+            const __m256i v  = load(a + i);
+            const __m256i lo = _mm256_shuffle_epi8(table, _mm256_and_si256(v, nibble));
+            const __m256i hi = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+            sum = _mm256_add_epi64(sum, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+        }
+        alignas(32) std::uint64_t lanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), sum);
+        return std::size_t(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+    }
+
+    const Kernels kAVX2{ andAVX2, orAVX2, andNotAVX2, notAVX2, countAVX2 };
+
+#endif // ADSL_GROUPS_X86
+
+    /* the parser's level : what the CPU supports unless lowered by setScanLevel */
+    const Kernels& kernels()
+    {
+#ifdef ADSL_GROUPS_X86
+        if (scanLevel() == ScanLevel::AVX2) return kAVX2;
+#endif
+        return kScalar;
+    }
+}
+
+/* ******************************************************************** */
+/*  --------------------------- Expressions --------------------------- */
+/* ******************************************************************** */
+
+struct adsl::detail::GroupNode
+{
+    enum class Kind { Group, FieldGroup, Not, And, Or, AndNot };
+
+    Kind                             kind;
+    AdslSymbol                       group;         // Group, FieldGroup
+    std::shared_ptr<const GroupNode> a, b;          // operands
+};
+
+namespace {
+
+    using Kind = GroupNode::Kind;
+
+    std::shared_ptr<const GroupNode> node(Kind kind, std::shared_ptr<const GroupNode> a,
+                                          std::shared_ptr<const GroupNode> b = nullptr)
+    {
+        return std::make_shared<const GroupNode>(GroupNode{ kind, AdslSymbol(), std::move(a), std::move(b) });
+    }
+
+    bool hasGroup(const std::pmr::vector<AdslSymbol>& groups, AdslSymbol g)
+    {
+        return std::find(groups.begin(), groups.end(), g) != groups.end();
+    }
+
+    bool matchNode(const GroupNode& n, const AdslEntity& e)
+    {
+        switch (n.kind) {
+            case Kind::Group:      return hasGroup(e.groups, n.group);
+            case Kind::FieldGroup:
+                return std::any_of(e.fields.begin(), e.fields.end(), [&n](const AdslField& f){
+                    return !f.removed() && hasGroup(f.groups, n.group);
+                });
+            case Kind::Not:    return !matchNode(*n.a, e);
+            case Kind::And:    return matchNode(*n.a, e) && matchNode(*n.b, e);
+            case Kind::Or:     return matchNode(*n.a, e) || matchNode(*n.b, e);
+            case Kind::AndNot: return matchNode(*n.a, e) && !matchNode(*n.b, e);
+        }
+        return false;
+    }
+
+    bool usesFieldGroups(const GroupNode& n)
+    {
+        if (n.kind == Kind::FieldGroup) return true;
+        return (n.a && usesFieldGroups(*n.a)) || (n.b && usesFieldGroups(*n.b));
+    }
+
+    /* Stack machine over the expression in postfix order, run once per chunk.
+     * Each stack slot owns a chunk buffer, but may point into a set's bitmap
+     * instead (read-only) or be known empty / full without touching memory. */
+    class Evaluator
+    {
+    public:
+        Evaluator(const GroupNode& root, const AdslDatabase& db)
+            : m_kernels(kernels()), m_size(db.entities.size())
+        {
+            compile(root, db, 0);
+            m_buffers.resize(m_slots.size() * kWords);
+            for (std::size_t i = 0; i < m_slots.size(); ++i) m_slots[i].own = m_buffers.data() + i * kWords;
+        }
+
+        /* out(base, words, valid) for every chunk : 'words' (kWords, bits past 'valid'
+         * cleared) or nullptr when every id in [base, base + valid) matches.
+         * Chunks without a match are skipped. */
+        template<typename Out>
+        void run(Out out)
+        {
+            for (std::size_t base = 0; base < m_size; base += kChunk)
+            {
+                const std::size_t valid = std::min(kChunk, m_size - base);
+                Slot& r = evaluate(std::uint32_t(base >> AdslIdSet::kChunkBits));
+                if (r.state == State::Empty) continue;
+                if (r.state == State::Full) { out(base, nullptr, valid); continue; }
+                if (valid < kChunk) {
+                    if (r.words != r.own) std::memcpy(r.own, r.words, kWords * sizeof(std::uint64_t));
+                    std::fill(r.own + (valid + 63) / 64, r.own + kWords, 0);
+                    if (valid % 64) r.own[valid / 64] &= (std::uint64_t(1) << (valid % 64)) - 1;
+                    r.words = r.own;
+                }
+                out(base, r.words, valid);
+            }
+        }
+
+        std::size_t countWords(const std::uint64_t* words) const { return m_kernels.countWords(words); }
+
+    private:
+        enum class State { Empty, Full, Words };
+
+        struct Slot
+        {
+            State                state = State::Empty;
+            const std::uint64_t* words = nullptr;       // own, or a set's bitmap
+            std::uint64_t*       own   = nullptr;
+        };
+
+        struct Op
+        {
+            Kind                                 kind;
+            const IdSetAccess::Chunks*           chunks = nullptr;     // leaves
+            std::size_t                          next   = 0;           // first chunk not passed yet
+        };
+
+        /* postfix order; one slot per stack level reached */
+        void compile(const GroupNode& n, const AdslDatabase& db, std::size_t depth)
+        {
+            if (m_slots.size() <= depth) m_slots.resize(depth + 1);
+            if (n.kind == Kind::Group || n.kind == Kind::FieldGroup) {
+                const AdslIdSet* set = n.kind == Kind::Group ? db.groupSet(n.group) : db.fieldGroupSet(n.group);
+                m_ops.push_back(Op{ n.kind, &IdSetAccess::chunks(*set) });
+                return;
+            }
+            compile(*n.a, db, depth);
+            if (n.b) compile(*n.b, db, depth + 1);
+            m_ops.push_back(Op{ n.kind });
+        }
+
+        Slot& evaluate(std::uint32_t key)
+        {
+            std::size_t top = 0;                        // slots in use
+            for (Op& op : m_ops)
+            {
+                if (op.chunks) { push(m_slots[top++], op, key); continue; }
+                if (op.kind == Kind::Not) { invert(m_slots[top - 1]); continue; }
+                combine(op.kind, m_slots[top - 2], m_slots[top - 1]);
+                --top;
+            }
+            return m_slots[0];
+        }
+
+        void push(Slot& s, Op& op, std::uint32_t key)
+        {
+            const auto& chunks = *op.chunks;
+            while (op.next < chunks.size() && chunks[op.next].key < key) ++op.next;
+            if (op.next == chunks.size() || chunks[op.next].key != key) { s.state = State::Empty; return; }
+
+            const auto& c = chunks[op.next];
+            s.state = State::Words;
+            if (!c.bits.empty()) { s.words = c.bits.data(); return; }
+            std::fill(s.own, s.own + kWords, 0);
+            for (std::uint16_t x : c.array) s.own[x >> 6] |= std::uint64_t(1) << (x & 63);
+            s.words = s.own;
+        }
+
+        void invert(Slot& s)
+        {
+            if (s.state == State::Empty)     s.state = State::Full;
+            else if (s.state == State::Full) s.state = State::Empty;
+            else { m_kernels.notWords(s.own, s.words); s.words = s.own; }
+        }
+
+        /* x = x op y */
+        void combine(Kind kind, Slot& x, Slot& y)
+        {
+            auto take = [&x, &y]() {
+                if (y.words == y.own) std::swap(x.own, y.own);      // y's buffer is reused next
+                x.state = y.state;
+                x.words = y.words;
+            };
+            auto words = [&x](void (*fn)(std::uint64_t*, const std::uint64_t*, const std::uint64_t*),
+                              const std::uint64_t* b) {
+                fn(x.own, x.words, b);
+                x.words = x.own;
+            };
+
+            switch (kind)
+            {
+            case Kind::And:
+                if (x.state == State::Empty || y.state == State::Full) return;
+                if (y.state == State::Empty || x.state == State::Full) { take(); return; }
+                words(m_kernels.andWords, y.words);
+                return;
+
+            case Kind::Or:
+                if (x.state == State::Full || y.state == State::Empty) return;
+                if (y.state == State::Full || x.state == State::Empty) { take(); return; }
+                words(m_kernels.orWords, y.words);
+                return;
+
+            case Kind::AndNot:
+                if (x.state == State::Empty || y.state == State::Empty) return;
+                if (y.state == State::Full) { x.state = State::Empty; return; }
+                if (x.state == State::Full) { invert(y); take(); return; }
+                words(m_kernels.andNotWords, y.words);
+                return;
+
+            default:
+                return;
+            }
+        }
+
+        const Kernels&             m_kernels;
+        const std::size_t          m_size;                  // ids are positions < m_size
+        std::vector<Op>            m_ops;
+        std::vector<Slot>          m_slots;
+        std::vector<std::uint64_t> m_buffers;               // kWords per slot
+    };
+
+    /* Bitmaps can answer unless the indexes are stale, or removed fields still sit in
+     * the field group sets (removed entities are skipped while visiting instead) */
+    bool useBitmaps(const GroupNode& root, const AdslDatabase& db)
+    {
+        return db.isIndexed() && !(db.removedFields() && usesFieldGroups(root));
+    }
+
+    /* fn(position) for every match, ascending */
+    template<typename Fn>
+    void visit(const GroupNode& root, const AdslDatabase& db, Fn fn)
+    {
+        if (!useBitmaps(root, db)) {
+            for (std::size_t i = 0; i < db.entities.size(); ++i)
+                if (!db.entities[i].removed() && matchNode(root, db.entities[i])) fn(i);
+            return;
+        }
+        const bool removals = db.removedEntities() != 0;
+        auto emit = [&](std::size_t id) { if (!removals || !db.entities[id].removed()) fn(id); };
+        Evaluator(root, db).run([&](std::size_t base, const std::uint64_t* words, std::size_t valid) {
+            if (!words) { for (std::size_t i = 0; i < valid; ++i) emit(base + i); return; }
+            forEachBit(words, (valid + 63) / 64, [&](std::size_t x){ emit(base + x); });
+        });
+    }
+}
+
+GroupExpr adsl::inGroup(AdslSymbol group)
+{
+    return GroupExpr(std::make_shared<const GroupNode>(GroupNode{ Kind::Group, group, nullptr, nullptr }));
+}
+
+GroupExpr adsl::inFieldGroup(AdslSymbol group)
+{
+    return GroupExpr(std::make_shared<const GroupNode>(GroupNode{ Kind::FieldGroup, group, nullptr, nullptr }));
+}
+
+GroupExpr GroupExpr::operator~() const
+{
+    if (m_node->kind == Kind::Not) return GroupExpr(m_node->a);
+    return GroupExpr(node(Kind::Not, m_node));
+}
+
+/* x & ~y is one AND-NOT pass instead of a NOT then an AND */
+GroupExpr adsl::operator&(const GroupExpr& a, const GroupExpr& b)
+{
+    if (b.m_node->kind == Kind::Not) return GroupExpr(node(Kind::AndNot, a.m_node, b.m_node->a));
+    if (a.m_node->kind == Kind::Not) return GroupExpr(node(Kind::AndNot, b.m_node, a.m_node->a));
+    return GroupExpr(node(Kind::And, a.m_node, b.m_node));
+}
+
+GroupExpr adsl::operator|(const GroupExpr& a, const GroupExpr& b)
+{
+    return GroupExpr(node(Kind::Or, a.m_node, b.m_node));
+}
+
+GroupExpr adsl::operator-(const GroupExpr& a, const GroupExpr& b)
+{
+    return GroupExpr(node(Kind::AndNot, a.m_node, b.m_node));
+}
+
+bool GroupExpr::matches(const AdslEntity& e) const
+{
+    return !e.removed() && matchNode(*m_node, e);
+}
+
+std::size_t GroupExpr::count(const AdslDatabase& db) const
+{
+    std::size_t n = 0;
+    if (!useBitmaps(*m_node, db) || db.removedEntities()) {
+        visit(*m_node, db, [&n](std::size_t){ ++n; });
+        return n;
+    }
+    Evaluator eval(*m_node, db);
+    eval.run([&](std::size_t, const std::uint64_t* words, std::size_t valid) {
+        n += words ? eval.countWords(words) : valid;
+    });
+    return n;
+}
+
+std::vector<std::size_t> GroupExpr::indices(const AdslDatabase& db) const
+{
+    std::vector<std::size_t> res;
+    visit(*m_node, db, [&res](std::size_t i){ res.push_back(i); });
+    return res;
+}
+
+std::vector<const AdslEntity*> GroupExpr::entities(const AdslDatabase& db) const
+{
+    std::vector<const AdslEntity*> res;
+    visit(*m_node, db, [&](std::size_t i){ res.push_back(&db.entities[i]); });
+    return res;
+}
+
+std::vector<AdslEntity*> GroupExpr::entities(AdslDatabase& db) const
+{
+    std::vector<AdslEntity*> res;
+    visit(*m_node, db, [&](std::size_t i){ res.push_back(&db.entities[i]); });
+    return res;
+}
+
+AdslIdSet GroupExpr::toSet(const AdslDatabase& db) const
+{
+    AdslIdSet set;
+    visit(*m_node, db, [&set](std::size_t i){ set.insert(i); });
+    return set;
+}
+
+void GroupExpr::forEach(const AdslDatabase& db, const std::function<void(const AdslEntity&)>& fn) const
+{
+    visit(*m_node, db, [&](std::size_t i){ fn(db.entities[i]); });
+}
@@ -0,0 +1,240 @@
+#include "adsl_include.hpp"
+#include "adsl_mmap.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace adsl::detail;
+namespace fs = std::filesystem;
+
+namespace {
+
+    /* One included file as parsed : its includes are resolved to canonical paths */
+    struct Fragment
+    {
+        AdslStableVector<AdslEntity> entities;
+        std::vector<AdslGroup>       groups;            // in definition order
+        std::vector<IncludeRef>      includes;
+    };
+
+    using FragmentPtr = std::shared_ptr<const Fragment>;
+
+    /* 'path' as written, from the directory of 'from' (a file, or empty) */
+    std::string resolvePath(const std::string& path, const std::string& from)
+    {
+        fs::path p(path);
+        if (p.is_relative()) p = (from.empty() ? fs::current_path() : fs::path(from).parent_path()) / p;
+        std::error_code ec;
+        fs::path canonical = fs::weakly_canonical(p, ec);
+        return (ec ? p.lexically_normal() : canonical).string();
+    }
+
+    /* "file: Line 3: ..." (or "Line 3: ..." for the text parsed first) */
+    std::runtime_error includeError(const std::string& from, std::size_t line, const std::string& what)
+    {
+        std::runtime_error e = lineError(line, what);
+        return from.empty() ? e : std::runtime_error(from + ": " + e.what());
+    }
+
+    FragmentPtr parseFragment(const std::string& path, std::string_view text)
+    {
+        auto f = std::make_shared<Fragment>();
+        auto builder = makeDomBuilder(f->entities, [&f](AdslGroup&& g){
+            f->groups.push_back(std::move(g));
+        });
+        try {
+            LineParser<decltype(builder)> parser(builder);
+            parser.parse(text);
+            parser.finish();
+        } catch (const std::exception& ex) {
+            throw std::runtime_error(path + ": " + ex.what());
+        }
+        f->includes = builder.includes();
+        for (IncludeRef& inc : f->includes) inc.path = resolvePath(inc.path, path);
+        return f;
+    }
+
+    /* --- process-wide cache --- */
+
+    struct CacheEntry
+    {
+        fs::file_time_type mtime;
+        std::uintmax_t     size = 0;
+        std::uint64_t      hash = 0;
+        FragmentPtr        fragment;
+    };
+
+    std::mutex                                  g_cacheMutex;
+    std::unordered_map<std::string, CacheEntry> g_cache;
+
+    /* The parsed file, from the cache when its stamp or else its content is
+     * unchanged. Two threads missing on the same path both parse it; the
+     * loader never asks twice for one path, so that only happens across parses. */
+    FragmentPtr loadFragment(const std::string& path)
+    {
+        std::error_code ec;
+        fs::file_time_type mtime = fs::last_write_time(path, ec);
+        std::uintmax_t     size  = ec ? 0 : fs::file_size(path, ec);
+        if (!ec) {
+            std::lock_guard<std::mutex> lock(g_cacheMutex);
+            auto it = g_cache.find(path);
+            if (it != g_cache.end() && it->second.mtime == mtime && it->second.size == size)
+                return it->second.fragment;
+        }
+
+        MappedFile file;
+        if (!file.open(path)) return nullptr;
+        const std::uint64_t hash = hashBytes(file.data(), file.size());
+        {
+            std::lock_guard<std::mutex> lock(g_cacheMutex);
+            auto it = g_cache.find(path);
+            if (it != g_cache.end() && it->second.hash == hash && it->second.size == file.size()) {
+                it->second.mtime = mtime;                       // touched, not changed
+                return it->second.fragment;
+            }
+        }
+
+        FragmentPtr fragment = parseFragment(path, file.view());
+        std::lock_guard<std::mutex> lock(g_cacheMutex);
+        g_cache[path] = CacheEntry{ mtime, file.size(), hash, fragment };
+        return fragment;
+    }
+
+    /* --- loading : one wave per include depth, each wave in parallel --- */
+
+    struct Origin { std::string from; std::size_t line; };       // first directive naming a file ("" : the root)
+
+    using Loaded = std::unordered_map<std::string, FragmentPtr>;
+
+    Loaded loadAll(const std::vector<IncludeRef>& roots)
+    {
+        Loaded loaded;
+        std::vector<std::string> wave;
+        std::vector<Origin>      origins;
+        auto request = [&](const IncludeRef& inc, const std::string& from) {
+            if (loaded.emplace(inc.path, nullptr).second) {
+                wave.push_back(inc.path);
+                origins.push_back(Origin{ from, inc.line });
+            }
+        };
+        for (const IncludeRef& inc : roots) request(inc, std::string());
+
+        while (!wave.empty())
+        {
+            std::vector<std::string> paths   = std::move(wave);
+            std::vector<Origin>      from    = std::move(origins);
+            std::vector<FragmentPtr> results(paths.size());
+            std::vector<std::exception_ptr> errors(paths.size());
+            wave.clear();
+            origins.clear();
+
+            unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+            parallelFor(paths.size(), threads, [&](std::size_t i){
+                try {
+                    results[i] = loadFragment(paths[i]);
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            });
+
+            for (std::size_t i = 0; i < paths.size(); ++i)
+            {
+                if (errors[i]) std::rethrow_exception(errors[i]);
+                if (!results[i])
+                    throw includeError(from[i].from, from[i].line, "cannot open include \"" + paths[i] + "\"");
+                loaded[paths[i]] = results[i];
+                for (const IncludeRef& inc : results[i]->includes) request(inc, paths[i]);
+            }
+        }
+        return loaded;
+    }
+
+    /* --- merge : depth first, in document order --- */
+
+    class Merger
+    {
+    public:
+        Merger(AdslDatabase& db, const Loaded& loaded, AdslStableVector<AdslEntity>& out)
+            : m_db(db), m_loaded(loaded), m_out(out) {}
+
+        void enterRoot(const std::string& path)
+        {
+            if (path.empty()) return;
+            m_stack.push_back(path);
+            m_merged.insert(path);
+        }
+
+        /* 'from' names the including file in errors ("" : the root, like its own errors) */
+        void include(const IncludeRef& inc, const std::string& from)
+        {
+            auto cycle = std::find(m_stack.begin(), m_stack.end(), inc.path);
+            if (cycle != m_stack.end()) {
+                std::string chain;
+                for (auto it = cycle; it != m_stack.end(); ++it) chain += *it + " -> ";
+                throw includeError(from, inc.line, "include cycle: " + chain + inc.path);
+            }
+            if (!m_merged.insert(inc.path).second) return;
+
+            const Fragment& f = *m_loaded.at(inc.path);
+            /* before its own includes : a file's definitions win over theirs */
+            for (auto g = f.groups.rbegin(); g != f.groups.rend(); ++g)
+                m_db.groups.emplace(g->name, *g);
+
+            m_stack.push_back(inc.path);
+            std::size_t done = 0;
+            for (const IncludeRef& next : f.includes) {
+                for (; done < next.entitiesBefore; ++done) m_out.push_back(f.entities[done]);
+                include(next, inc.path);
+            }
+            for (; done < f.entities.size(); ++done) m_out.push_back(f.entities[done]);
+            m_stack.pop_back();
+        }
+
+    private:
+        AdslDatabase&                   m_db;
+        const Loaded&                   m_loaded;
+        AdslStableVector<AdslEntity>&   m_out;
+        std::vector<std::string>        m_stack;        // files being merged, outermost first
+        std::unordered_set<std::string> m_merged;
+    };
+
+} // namespace
+
+void adsl::detail::resolveIncludes(AdslDatabase& db, const std::vector<IncludeRef>& includes, const std::string& path)
+{
+    if (includes.empty()) return;
+
+    const std::string root = path.empty() ? std::string() : resolvePath(path, std::string());
+    std::vector<IncludeRef> refs = includes;
+    for (IncludeRef& inc : refs) inc.path = resolvePath(inc.path, root);
+
+    Loaded loaded = loadAll(refs);
+
+    /* the root's entities move over (same resource), included ones are copied in */
+    AdslStableVector<AdslEntity> out(db.resource());
+    std::size_t total = db.entities.size();
+    for (const auto& [file, fragment] : loaded) total += fragment->entities.size();
+    out.reserve(total);
+
+    Merger merger(db, loaded, out);
+    merger.enterRoot(root);
+    std::size_t done = 0;
+    for (const IncludeRef& inc : refs) {
+        for (; done < inc.entitiesBefore; ++done) out.push_back(std::move(db.entities[done]));
+        merger.include(inc, std::string());
+    }
+    for (; done < db.entities.size(); ++done) out.push_back(std::move(db.entities[done]));
+    db.entities = std::move(out);
+}
+
+void clearAdslIncludeCache()
+{
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    g_cache.clear();
+}
@@ -0,0 +1,40 @@
+#ifndef ADSL_INCLUDE_HPP
+#define ADSL_INCLUDE_HPP
+
+/* Internal : '#include "path"' resolution for the DOM parse paths.
+ *
+ * The parser only records where each directive stood (DomBuilder::includes).
+ * Once the including text is parsed, resolveIncludes loads every file it
+ * reaches, wave by wave and in parallel, then splices their entities in at
+ * the directives. Each file is parsed once per process : the cache keys it
+ * by canonical path and checks it by modification time and size, then by
+ * content hash, before reusing it.
+ *
+ * Rules :
+ *   - a relative path is taken from the including file's directory (the
+ *     current directory for text parsed from memory);
+ *   - a file reached twice is merged once, where it is first included;
+ *   - a file including itself, directly or not, is an error;
+ *   - a group defined in several files keeps the including file's
+ *     definition, or else the first included one's.
+ */
+
+#include "../include/adsl/adsl.hpp"
+#include "adsl_parser.hpp"
+
+#include <string>
+#include <vector>
+
+namespace adsl {
+namespace detail {
+
+    /* Splice the files named by 'includes' (recorded while parsing db.entities)
+     * into db. 'path' is the file db was parsed from, empty for text. Throws
+     * std::runtime_error on a missing file, a cycle or a syntax error in an
+     * included file (prefixed with that file's path). */
+    void resolveIncludes(AdslDatabase& db, const std::vector<IncludeRef>& includes, const std::string& path);
+
+} // namespace detail
+} // namespace adsl
+
+#endif // ADSL_INCLUDE_HPP
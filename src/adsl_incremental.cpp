@@ -0,0 +1,171 @@
+#include "../include/adsl/adsl_incremental.hpp"
+#include "adsl_mmap.hpp"
+#include "adsl_parser.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace adsl;
+using namespace adsl::detail;
+
+/* ******************************************************************** */
+/*  ----------------------------- Parsing ----------------------------- */
+/* ******************************************************************** */
+
+void Document::parseBlocks(std::string_view text, std::size_t linesBefore, bool preamble,
+                           AdslStableVector<AdslEntity>& entities, std::vector<Block>& blocks)
+{
+    /* block boundaries : the same header test the parser applies line by line */
+    if (preamble) blocks.push_back(Block{ 0, linesBefore, {} });
+    std::size_t line = linesBefore;
+    for (std::size_t pos = 0; pos < text.size(); ++line)
+    {
+        if (isEntityLine(text, pos)) blocks.push_back(Block{ pos, line, {} });
+        std::size_t nl = text.find('\n', pos);
+        if (nl == std::string_view::npos) break;
+        pos = nl + 1;
+    }
+
+    /* a definition belongs to the block of the last entity begun (the preamble before any) */
+    const std::size_t first = entities.size();
+    auto builder = makeDomBuilder(entities, [&](AdslGroup&& g){
+        std::size_t begun = entities.size() - first;
+        std::size_t block = preamble ? begun : std::max<std::size_t>(begun, 1) - 1;
+        blocks[block].groups.push_back(std::move(g));
+    });
+    LineParser<decltype(builder)> parser(builder, linesBefore);
+    parser.parse(text);
+    parser.finish();
+
+    /* a block per header : an included file would have to be one too */
+    if (!builder.includes().empty())
+        throw lineError(builder.includes().front().line, "#include is not supported in a Document");
+}
+
+/* ******************************************************************** */
+/*  ---------------------------- Document ----------------------------- */
+/* ******************************************************************** */
+
+bool Document::loadFile(const std::string& filepath)
+{
+    MappedFile file;
+    if (!file.open(filepath)) return false;
+    return loadString(std::string(file.view()));
+}
+
+bool Document::loadString(std::string text)
+{
+    /* like parseBuffer : the database is emptied first, and stays so on error */
+    m_text.clear();
+    m_blocks.assign(1, Block());
+    m_db.clear();
+
+    std::vector<Block> blocks;
+    parseBlocks(text, 0, true, m_db.entities, blocks);
+
+    m_text   = std::move(text);
+    m_blocks = std::move(blocks);
+    rebuildGroups();
+    m_db.reindex();
+    return true;
+}
+
+Document::Update Document::edit(std::size_t offset, std::size_t length, std::string_view replacement)
+{
+    if (offset > m_text.size() || length > m_text.size() - offset)
+        throw std::out_of_range("Document::edit: range outside the text");
+    if (m_db.entities.size() + 1 != m_blocks.size())
+        throw std::runtime_error("Document::edit: the database was changed outside the document");
+
+    Update res;
+    if (length == 0 && replacement.empty()) return res;
+
+    /* The edited blocks, with the edit applied. The region ends right before an
+     * untouched header, so it still ends where a block ends; it must also start
+     * where one starts : when the edit removed the leading header, the remaining
+     * lines belong to the previous block. */
+    std::size_t b0 = blockAt(offset);
+    std::size_t b1 = blockAt(offset + length);
+    std::size_t start = 0, end = 0;
+    std::string region;
+    for (;;)
+    {
+        start = m_blocks[b0].offset;
+        end   = blockEnd(b1);
+        region.assign(m_text, start, offset - start);
+        region.append(replacement);
+        region.append(m_text, offset + length, end - offset - length);
+        if (b0 == 0 || region.empty() || isEntityLine(region, 0)) break;
+        --b0;
+    }
+
+    AdslStableVector<AdslEntity> entities(m_db.entities.get_allocator());
+    std::vector<Block> blocks;
+    parseBlocks(region, m_blocks[b0].line, b0 == 0, entities, blocks);      // throws before any change
+
+    /* --- commit --- */
+    const std::ptrdiff_t byteDelta = std::ptrdiff_t(replacement.size()) - std::ptrdiff_t(length);
+    const std::ptrdiff_t lineDelta =
+          std::ptrdiff_t(std::count(replacement.begin(), replacement.end(), '\n'))
+        - std::ptrdiff_t(std::count(m_text.begin() + offset, m_text.begin() + offset + length, '\n'));
+
+    auto hasGroups = [](const Block& b){ return !b.groups.empty(); };
+    res.groupsChanged = std::any_of(m_blocks.begin() + b0, m_blocks.begin() + b1 + 1, hasGroups)
+                     || std::any_of(blocks.begin(), blocks.end(), hasGroups);
+
+    for (Block& b : blocks) b.offset += start;
+    m_blocks.erase(m_blocks.begin() + b0, m_blocks.begin() + b1 + 1);
+    m_blocks.insert(m_blocks.begin() + b0, std::make_move_iterator(blocks.begin()), std::make_move_iterator(blocks.end()));
+    for (std::size_t i = b0 + blocks.size(); i < m_blocks.size(); ++i) {
+        m_blocks[i].offset += byteDelta;
+        m_blocks[i].line   += lineDelta;
+    }
+    m_text.replace(offset, length, replacement);
+
+    /* block i >= 1 is entity i - 1 */
+    res.firstEntity   = std::max<std::size_t>(b0, 1) - 1;
+    res.removed       = b1 + 1 - std::max<std::size_t>(b0, 1);
+    res.inserted      = entities.size();
+    res.reparsedBytes = region.size();
+    m_db.replaceEntities(res.firstEntity, res.removed, std::move(entities));
+    if (res.groupsChanged) rebuildGroups();
+    return res;
+}
+
+Document::Update Document::update(std::string_view newText)
+{
+    std::string_view old = m_text;
+    std::size_t common = std::min(old.size(), newText.size());
+
+    std::size_t prefix = std::mismatch(old.begin(), old.begin() + common, newText.begin()).first - old.begin();
+    std::size_t suffix = std::mismatch(old.rbegin(), old.rbegin() + (common - prefix), newText.rbegin()).first - old.rbegin();
+
+    return edit(prefix, old.size() - prefix - suffix,
+                newText.substr(prefix, newText.size() - prefix - suffix));
+}
+
+std::pair<std::size_t, std::size_t> Document::entitySpan(std::size_t entity) const
+{
+    return { m_blocks.at(entity + 1).offset, blockEnd(entity + 1) };
+}
+
+std::size_t Document::blockAt(std::size_t offset) const
+{
+    auto it = std::upper_bound(m_blocks.begin(), m_blocks.end(), offset,
+                               [](std::size_t off, const Block& b){ return off < b.offset; });
+    return std::size_t(it - m_blocks.begin()) - 1;         // m_blocks[0].offset == 0
+}
+
+std::size_t Document::blockEnd(std::size_t block) const
+{
+    return block + 1 < m_blocks.size() ? m_blocks[block + 1].offset : m_text.size();
+}
+
+/* Same outcome as a full parse : definitions in document order, last one wins */
+void Document::rebuildGroups()
+{
+    m_db.groups.clear();
+    for (const Block& b : m_blocks)
+        for (const AdslGroup& g : b.groups)
+            m_db.groups[g.name] = g;
+}
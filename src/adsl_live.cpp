@@ -0,0 +1,205 @@
+#include "../include/adsl/adsl_live.hpp"
+
+#include <exception>
+#include <filesystem>
+
+#if defined(__linux__)
+    #include <poll.h>
+    #include <sys/eventfd.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+    #define ADSL_HAS_INOTIFY 1
+#endif
+
+using namespace adsl;
+namespace fs = std::filesystem;
+
+LiveDatabase::LiveDatabase(std::string path, Options options)
+    : m_path(std::move(path))
+    , m_options(options)
+    , m_current(new Version{ std::make_shared<const AdslDatabase>() })
+{
+}
+
+LiveDatabase::~LiveDatabase()
+{
+    stop();
+    delete m_current.load();            // readers still holding a Snapshot keep their database
+}
+
+/* ******************************************************************** */
+/*  -------------------------- Publication ---------------------------- */
+/* ******************************************************************** */
+
+/* The only shared state a reader touches is m_current and one counter : it
+ * registers on the current epoch, copies the Snapshot out of the Version
+ * (the Version cannot be deleted meanwhile, see waitForReaders), and leaves.
+ * Nothing here waits, so readers are never held up by a reload. */
+Snapshot LiveDatabase::snapshot() const
+{
+    unsigned epoch = m_epoch.load() & 1;
+    m_readers[epoch].fetch_add(1);
+    Snapshot db = m_current.load()->db;
+    m_readers[epoch].fetch_sub(1);
+    return db;
+}
+
+/* After the swap, a reader may still be copying from the old Version. Such a
+ * reader registered before loading m_current, on whichever epoch it read
+ * first (possibly a stale one) : flipping twice and waiting for each side to
+ * drain covers both counters, while readers arriving later register on the
+ * new side, load the new Version and cannot delay us forever. */
+void LiveDatabase::waitForReaders()
+{
+    for (int phase = 0; phase < 2; ++phase)
+    {
+        unsigned old = m_epoch.fetch_add(1) & 1;
+        while (m_readers[old].load() != 0)
+            std::this_thread::yield();
+    }
+}
+
+void LiveDatabase::publish(Snapshot db)
+{
+    Version* old = m_current.exchange(new Version{ std::move(db) });
+    waitForReaders();
+    delete old;                         // drops the published reference; readers keep theirs
+    m_generation.fetch_add(1, std::memory_order_release);
+}
+
+bool LiveDatabase::reload()
+{
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+
+    auto db = std::make_shared<AdslDatabase>(m_options.allocation);
+    try {
+        bool ok = m_options.threads == 1 ? parseAdslFile(m_path, *db)
+                                         : parseAdslFileParallel(m_path, *db, m_options.threads);
+        if (!ok) {
+            m_error = "cannot open " + m_path;
+            return false;
+        }
+    } catch (const std::exception& ex) {
+        m_error = ex.what();
+        return false;
+    }
+
+    m_error.clear();
+    Snapshot published = std::move(db);
+    publish(published);
+    if (m_callback) m_callback(published);
+    return true;
+}
+
+std::string LiveDatabase::lastError() const
+{
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    return m_error;
+}
+
+void LiveDatabase::onReload(std::function<void(const Snapshot&)> callback)
+{
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    m_callback = std::move(callback);
+}
+
+/* ******************************************************************** */
+/*  ----------------------------- Watcher ----------------------------- */
+/* ******************************************************************** */
+
+bool LiveDatabase::watch()
+{
+    if (m_watcher.joinable()) return true;
+    m_stop = false;
+#ifdef ADSL_HAS_INOTIFY
+    m_wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (m_wakeFd < 0) return false;
+#endif
+    m_watcher = std::thread([this]{ watchLoop(); });
+    return true;
+}
+
+void LiveDatabase::stop()
+{
+    if (!m_watcher.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_stopMutex);
+        m_stop = true;
+    }
+    m_stopCv.notify_all();
+#ifdef ADSL_HAS_INOTIFY
+    std::uint64_t one = 1;
+    (void)!::write(m_wakeFd, &one, sizeof(one));
+#endif
+    m_watcher.join();
+#ifdef ADSL_HAS_INOTIFY
+    ::close(m_wakeFd);
+    m_wakeFd = -1;
+#endif
+}
+
+#ifdef ADSL_HAS_INOTIFY
+
+/* Watches the directory rather than the file : editors and deploy tools often
+ * write a temporary file and rename it over the original, which replaces the
+ * inode a file watch would be attached to. A change starts the settle timer;
+ * the reload runs once no event came for Options::settle. */
+void LiveDatabase::watchLoop()
+{
+    fs::path file(m_path);
+    std::string dir  = file.has_parent_path() ? file.parent_path().string() : ".";
+    std::string name = file.filename().string();
+
+    int fd = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+    if (fd < 0) return;
+    if (inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+        ::close(fd);
+        return;
+    }
+
+    alignas(inotify_event) char buf[4096];
+    bool pending = false;
+    while (!m_stop)
+    {
+        pollfd fds[2] = { { fd, POLLIN, 0 }, { m_wakeFd, POLLIN, 0 } };
+        int timeout = pending ? int(m_options.settle.count()) : -1;
+        int n = ::poll(fds, 2, timeout);
+        if (n < 0) continue;                                // EINTR
+        if (n == 0) { pending = false; reload(); continue; }
+        if (fds[1].revents) break;
+
+        ssize_t len;
+        while ((len = ::read(fd, buf, sizeof(buf))) > 0)
+            for (char* p = buf; p < buf + len; ) {
+                auto* ev = reinterpret_cast<inotify_event*>(p);
+                if (ev->len && name == ev->name) pending = true;
+                p += sizeof(inotify_event) + ev->len;
+            }
+    }
+    ::close(fd);
+}
+
+#else
+
+/* No change notification : check the modification time every settle period,
+ * and reload once it stayed the same for a whole period after changing */
+void LiveDatabase::watchLoop()
+{
+    std::error_code ec;
+    auto last = fs::last_write_time(m_path, ec);
+    bool pending = false;
+    std::unique_lock<std::mutex> lock(m_stopMutex);
+    while (!m_stopCv.wait_for(lock, m_options.settle, [this]{ return m_stop.load(); }))
+    {
+        auto now = fs::last_write_time(m_path, ec);
+        if (ec) continue;
+        if (now != last) { last = now; pending = true; continue; }
+        if (!pending) continue;
+        pending = false;
+        lock.unlock();
+        reload();
+        lock.lock();
+    }
+}
+
+#endif
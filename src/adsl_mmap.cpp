@@ -0,0 +1,147 @@
+#include "adsl_mmap.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #define ADSL_HAS_MMAP 1
+#endif
+
+using namespace adsl::detail;
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this == &other) return *this;
+    close();
+    m_open   = std::exchange(other.m_open, false);
+    m_mapped = std::exchange(other.m_mapped, false);
+    m_size   = std::exchange(other.m_size, 0);
+    m_buffer = std::move(other.m_buffer);
+    m_data   = m_mapped ? other.m_data : (m_open ? m_buffer.data() : nullptr);
+    other.m_data = nullptr;
+#ifdef _WIN32
+    m_mapping = std::exchange(other.m_mapping, nullptr);
+#endif
+    return *this;
+}
+
+void MappedFile::close()
+{
+    if (m_mapped && m_data)
+    {
+#if defined(_WIN32)
+        UnmapViewOfFile(m_data);
+        CloseHandle(static_cast<HANDLE>(m_mapping));
+        m_mapping = nullptr;
+#elif defined(ADSL_HAS_MMAP)
+        munmap(const_cast<char*>(m_data), m_size);
+#endif
+    }
+    m_buffer.clear();
+    m_buffer.shrink_to_fit();
+    m_data   = nullptr;
+    m_size   = 0;
+    m_open   = false;
+    m_mapped = false;
+}
+
+bool MappedFile::open(const std::string& path)
+{
+    close();
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER len;
+    if (GetFileSizeEx(file, &len) && len.QuadPart > 0)
+    {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping)
+        {
+            void* p = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if (p)
+            {
+                CloseHandle(file);
+                m_mapping = mapping;
+                m_data    = static_cast<const char*>(p);
+                m_size    = static_cast<std::size_t>(len.QuadPart);
+                m_mapped  = true;
+                m_open    = true;
+                return true;
+            }
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+#elif defined(ADSL_HAS_MMAP)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+        void* p = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED)
+        {
+            ::close(fd);
+    #ifdef MADV_SEQUENTIAL
+            madvise(p, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);
+    #endif
+            m_data   = static_cast<const char*>(p);
+            m_size   = static_cast<std::size_t>(st.st_size);
+            m_mapped = true;
+            m_open   = true;
+            return true;
+        }
+    }
+    ::close(fd);
+#endif
+
+    /* fallback : empty files, pipes, platforms without mapping */
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    m_buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+    m_open = true;
+    return true;
+}
+
+/* One multiply per 8 bytes : catches truncation and bit rot without
+ * making open() hash-bound. */
+std::uint64_t adsl::detail::hashBytes(const char* p, std::size_t n)
+{
+    std::uint64_t h = 0x9E3779B97F4A7C15ull ^ n;
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        std::uint64_t w;
+        std::memcpy(&w, p + i, 8);
+        h = (h ^ w) * 0xFF51AFD7ED558CCDull;
+        h ^= h >> 29;
+    }
+    for (; i < n; ++i)
+        h = (h ^ static_cast<unsigned char>(p[i])) * 0xC4CEB9FE1A85EC53ull;
+    return h ^ (h >> 32);
+}
@@ -0,0 +1,52 @@
+#ifndef ADSL_MMAP_HPP
+#define ADSL_MMAP_HPP
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+namespace adsl {
+namespace detail {
+
+/* Read-only view of a whole file.
+ * Uses mmap / MapViewOfFile when available, and falls back to reading the
+ * file into an owned buffer otherwise. Move-only. */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map 'path'; returns false if the file cannot be opened.
+    bool open(const std::string& path);
+    void close();
+
+    bool             isOpen() const { return m_open; }
+    const char*      data()   const { return m_data; }
+    std::size_t      size()   const { return m_size; }
+    std::string_view view()   const { return { m_data, m_size }; }
+
+private:
+    const char* m_data   = nullptr;
+    std::size_t m_size   = 0;
+    bool        m_open   = false;
+    bool        m_mapped = false;     // false -> m_data points into m_buffer
+    std::string m_buffer;             // fallback storage
+#ifdef _WIN32
+    void*       m_mapping = nullptr;
+#endif
+};
+
+/* Non-cryptographic 64-bit hash of file contents (.adslb checksum, include cache) */
+std::uint64_t hashBytes(const char* p, std::size_t n);
+
+} // namespace detail
+} // namespace adsl
+
+#endif // ADSL_MMAP_HPP
@@ -0,0 +1,493 @@
+#ifndef ADSL_PARSER_HPP
+#define ADSL_PARSER_HPP
+
+/* Internal : line grammar shared by every parse entry point.
+ *
+ * LineParser<Sink> lexes text line by line and reports what it finds to a
+ * Sink through plain (inlinable) member calls :
+ *
+ *     void group      (size_t line, string_view name, const vector<string_view>& values);
+ *     void entityBegin(size_t line, string_view type, const vector<string_view>& groups);
+ *     void field      (size_t line, string_view name, AdslValue& value, const vector<string_view>& groups);
+ *     void entityEnd  ();
+ *     void include    (size_t line, string_view path);      // '#include "path"'
+ *     bool stopped    () const;
+ *
+ * The views point into the parsed text and die with the call. With
+ * RawDecoder, field() receives the value text (string_view&) instead.
+ */
+
+#include "../include/adsl/adsl.hpp"
+#include "adsl_scan.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace adsl {
+namespace detail {
+
+    /* isspace() in the C locale, without the library call */
+    static inline bool isSpace(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+    /* trim helpers */
+    static inline std::string_view ltrim(std::string_view s) { while (!s.empty() && isSpace(s.front())) s.remove_prefix(1); return s; }
+    static inline std::string_view rtrim(std::string_view s) { while (!s.empty() && isSpace(s.back()))  s.remove_suffix(1); return s; }
+    static inline std::string_view trimmed(std::string_view s){ return rtrim(ltrim(s)); }
+
+    static inline std::string toString(std::string_view s) { return std::string(s.data(), s.size()); }
+
+    /* Remove a // comment outside of quotes */
+    static inline std::string_view stripComment(std::string_view line)
+    {
+        bool inString = false;
+        for (std::size_t i = 0; i + 1 < line.size(); ++i)
+        {
+            if (line[i] == '"' && (i == 0 || line[i-1] != '\\'))
+                inString = !inString;
+
+            if (!inString && line[i] == '/' && line[i+1] == '/')
+                return line.substr(0, i);
+        }
+        return line;
+    }
+
+    /* true if the line starting at 'pos' is an entity header (first non-blank char is '#').
+     * An entity owns every line up to the next header, so text cut at such lines
+     * parses piece by piece (parallel chunks, incremental reparse). */
+    static inline bool isEntityLine(std::string_view data, std::size_t pos)
+    {
+        while (pos < data.size() && data[pos] != '\n' && isSpace(data[pos])) ++pos;
+        return pos < data.size() && data[pos] == '#';
+    }
+
+    /* Split a line of @groups, collects tokens into vector */
+    static inline void extractGroups(std::string_view s, std::vector<std::string_view>& outGroups)
+    {
+        std::size_t begin = 0;
+        for (std::size_t i = 0; i <= s.size(); ++i) {
+            char c = (i == s.size()) ? ' ' : s[i];
+            if (isSpace(c) || c == ',') {
+                if (i > begin && s[begin] == '@')
+                    outGroups.push_back(s.substr(begin + 1, i - begin - 1));
+                begin = i + 1;
+            }
+        }
+    }
+
+    /* '#include "path"' : the path, or an empty view if 'line' is an entity header
+     * (an entity type may still be called include, as long as no quote follows) */
+    static inline std::string_view includePath(std::string_view line)
+    {
+        static constexpr std::string_view kDirective = "#include";
+        if (line.substr(0, kDirective.size()) != kDirective) return {};
+        std::string_view rest = line.substr(kDirective.size());
+        if (rest.empty() || (!isSpace(rest.front()) && rest.front() != '"')) return {};
+        rest = ltrim(rest);
+        if (rest.empty() || rest.front() != '"') return {};
+        return rest;
+    }
+
+    static inline std::runtime_error lineError(std::size_t line, const std::string& what)
+    {
+        return std::runtime_error("Line " + std::to_string(line) + ": " + what);
+    }
+
+    class Arena;
+
+    /* Decode a value token (defined in adsl.cpp). Throws std::runtime_error without line info.
+     * With an arena, list and long string blocks are carved from it (adsl_value.hpp). */
+    AdslValue parseValue(std::string_view raw, Arena* arena = nullptr);
+
+    /* The same few names repeat on every line : this keeps the shared symbol
+     * table's lock out of the hot loop. Keys view the interned copies, which never move. */
+    class SymbolCache
+    {
+    public:
+        AdslSymbol get(std::string_view s)
+        {
+            auto it = m_symbols.find(s);
+            if (it != m_symbols.end()) return it->second;
+            AdslSymbol sym(s);
+            m_symbols.emplace(sym.view(), sym);
+            return sym;
+        }
+    private:
+        std::unordered_map<std::string_view, AdslSymbol> m_symbols;
+    };
+
+    /* Sets up lazy fields (AdslField::get() decodes them) */
+    struct FieldAccess
+    {
+        static void setRaw(AdslField& f, std::string_view raw, std::size_t line)
+        {
+            f.m_raw     = raw.data();
+            f.m_rawSize = static_cast<std::uint32_t>(raw.size());
+            f.m_line    = static_cast<std::uint32_t>(line);
+        }
+    };
+
+    /* How LineParser turns a value token into an AdslValue (see TimedDecoder) */
+    struct PlainDecoder
+    {
+        Arena* arena = nullptr;         // the database's, if it has one
+        AdslValue operator()(std::string_view raw) const { return parseValue(raw, arena); }
+    };
+
+    /* ... or leaves it as text, for lazy decoding (AdslValues::Lazy) */
+    struct RawDecoder
+    {
+        std::string_view operator()(std::string_view raw) const { return raw; }
+    };
+
+    /* Resumable : parse() may be called with successive pieces of a document
+     * as long as every piece ends on a line boundary (the last one may not). */
+    template<typename Sink, typename Decoder = PlainDecoder>
+    class LineParser
+    {
+    public:
+        explicit LineParser(Sink& sink, std::size_t linesBefore = 0, Decoder decoder = Decoder())
+            : m_sink(sink), m_decoder(decoder), m_lineno(linesBefore) {}
+
+        void parse(std::string_view data)
+        {
+            if (scanLevel() == ScanLevel::Scalar) { parseLines(data); return; }
+
+            /* index a window of whole lines, then run the grammar over it */
+            std::size_t pos = 0;
+            while (pos < data.size() && !m_sink.stopped())
+            {
+                std::size_t len = std::min(kWindow, data.size() - pos);
+                std::size_t usable;
+                for (;;)
+                {
+                    m_index.build(data.data() + pos, len);
+                    if (pos + len == data.size()) { usable = len; break; }      // may end unterminated
+                    std::size_t nl = m_index.lastNewline();
+                    if (nl != StructuralIndex::npos) { usable = nl + 1; break; }
+                    len = std::min(len * 2, data.size() - pos);                 // line longer than the window
+                }
+                parseIndexed(data.data() + pos, usable);
+                pos += usable;
+            }
+        }
+
+        /* end of input : closes the last entity */
+        void finish()
+        {
+            if (m_inEntity) { m_inEntity = false; m_sink.entityEnd(); }
+        }
+
+        std::size_t line()    const { return m_lineno; }
+        bool        stopped() const { return m_sink.stopped(); }
+
+    private:
+        static constexpr std::size_t kWindow = 64 * 1024;
+
+        /* Character loop (no SIMD kernel) */
+        void parseLines(std::string_view data)
+        {
+            std::size_t pos = 0;
+            while (pos < data.size() && !m_sink.stopped())
+            {
+                std::size_t nl = data.find('\n', pos);
+                if (nl == std::string_view::npos) nl = data.size();
+                parseLine(data.substr(pos, nl - pos));
+                pos = nl + 1;
+            }
+        }
+
+        void parseLine(std::string_view line)
+        {
+            ++m_lineno;
+            line = trimmed(stripComment(line));
+            if (!line.empty()) parseStatement(line);
+        }
+
+        /* Same as parseLines over base[0, size), which m_index describes. Lines
+         * are cut, trimmed and stripped with the bitmaps; only a line holding
+         * both a quote and a later "//" needs stripComment's quote tracking. */
+        void parseIndexed(const char* base, std::size_t size)
+        {
+            std::size_t a = 0;
+            while (a < size && !m_sink.stopped())
+            {
+                std::size_t b = m_index.nextNewline(a);
+                ++m_lineno;
+
+                std::size_t first = m_index.firstNonSpace(a, b);
+                if (first < b)
+                {
+                    std::size_t end     = b;
+                    std::size_t comment = m_index.firstComment(first, b);
+                    if (comment < b && m_index.hasQuote(first, comment)) {
+                        std::string_view line = trimmed(stripComment(std::string_view(base + a, b - a)));
+                        if (!line.empty()) parseStatement(line);
+                    } else {
+                        if (comment < b) end = comment;
+                        end = m_index.endNonSpace(first, end);
+                        if (end > first) parseStatement(std::string_view(base + first, end - first));
+                    }
+                }
+                a = b + 1;
+            }
+        }
+
+        /* One non-empty, trimmed, comment-free line */
+        void parseStatement(std::string_view line)
+        {
+
+            /* Group definition */
+            if (line.front() == '@')
+            {
+                std::size_t brk = line.find_first_of("[ \t");
+                std::string_view name = line.substr(1, brk == std::string_view::npos ? std::string_view::npos : brk - 1);
+
+                m_values.clear();
+                std::size_t open = line.find('[');
+                if (open != std::string_view::npos)
+                {
+                    std::size_t close = line.find_last_of(']');
+                    if (close == std::string_view::npos || close < open)
+                        throw lineError(m_lineno, "missing ] in group definition");
+                    std::string_view inside = trimmed(line.substr(open + 1, close - open - 1));
+                    /* same splitting rules as getline(ss, token, ','): no trailing empty token */
+                    std::size_t begin = 0;
+                    while (begin < inside.size()) {
+                        std::size_t comma = inside.find(',', begin);
+                        if (comma == std::string_view::npos) comma = inside.size();
+                        m_values.push_back(trimmed(inside.substr(begin, comma - begin)));
+                        begin = comma + 1;
+                    }
+                }
+                m_sink.group(m_lineno, name, m_values);
+                return;
+            }
+
+            /* Include : ends the current entity, like a header */
+            if (line.front() == '#')
+            {
+                std::string_view quoted = includePath(line);
+                if (!quoted.empty())
+                {
+                    if (quoted.size() < 3 || quoted.back() != '"')
+                        throw lineError(m_lineno, "bad include path -> " + toString(quoted));
+                    if (m_inEntity) { m_inEntity = false; m_sink.entityEnd(); }
+                    m_sink.include(m_lineno, quoted.substr(1, quoted.size() - 2));
+                    return;
+                }
+            }
+
+            /* Entity header */
+            if (line.front() == '#')
+            {
+                std::string_view tmp = line.substr(1);
+                m_groups.clear();
+                extractGroups(tmp, m_groups);
+
+                /* remove groups part to leave pure type */
+                std::size_t atPos = tmp.find('@');
+                std::string_view type = trimmed(atPos == std::string_view::npos ? tmp : tmp.substr(0, atPos));
+
+                if (type.empty())
+                    throw lineError(m_lineno, "empty entity type");
+
+                if (m_inEntity) m_sink.entityEnd();
+                m_inEntity = true;
+                m_sink.entityBegin(m_lineno, type, m_groups);
+                return;
+            }
+
+            /* Field */
+            if (line.front() == '-')
+            {
+                if (!m_inEntity)
+                    throw lineError(m_lineno, "field found outside entity");
+
+                std::string_view fld = trimmed(line.substr(1)); // drop '-'
+                /* find '=' */
+                std::size_t eq = fld.find('=');
+                if (eq == std::string_view::npos)
+                    throw lineError(m_lineno, "'=' expected in field");
+
+                std::string_view key  = trimmed(fld.substr(0, eq));
+                std::string_view rest = trimmed(fld.substr(eq + 1));
+
+                /* value stops at first @ or end of string */
+                std::size_t at = rest.find('@');
+                std::string_view valPart = trimmed(at == std::string_view::npos ? rest : rest.substr(0, at));
+
+                /* remove trailing ',' from value part */
+                if (!valPart.empty() && valPart.back() == ',')
+                    valPart.remove_suffix(1);
+
+                auto value = decodeValue(valPart);
+
+                /* groups after value */
+                m_groups.clear();
+                if (at != std::string_view::npos)
+                    extractGroups(rest.substr(at), m_groups);
+
+                m_sink.field(m_lineno, key, value, m_groups);
+                return;
+            }
+
+            throw lineError(m_lineno, "Unrecognised syntax -> " + toString(line));
+        }
+
+        auto decodeValue(std::string_view raw) const
+        {
+            try {
+                return m_decoder(raw);
+            } catch (const std::exception& ex) {
+                throw lineError(m_lineno, ex.what());
+            }
+        }
+
+        Sink&                         m_sink;
+        Decoder                       m_decoder;
+        StructuralIndex               m_index;
+        std::size_t                   m_lineno;
+        bool                          m_inEntity = false;
+        std::vector<std::string_view> m_groups;      // reused for every line
+        std::vector<std::string_view> m_values;
+    };
+
+    /* Sink for AdslHandler : gives the parser access to its private line / stop state */
+    struct HandlerAccess
+    {
+        AdslHandler& h;
+
+        void group(std::size_t line, std::string_view name, const std::vector<std::string_view>& values)
+        {
+            h.m_line = line;
+            h.onGroup(name, values);
+        }
+        void entityBegin(std::size_t line, std::string_view type, const std::vector<std::string_view>& groups)
+        {
+            h.m_line = line;
+            h.onEntityBegin(type, groups);
+        }
+        void field(std::size_t line, std::string_view name, AdslValue& value, const std::vector<std::string_view>& groups)
+        {
+            h.m_line = line;
+            h.onField(name, value, groups);
+        }
+        void entityEnd()     { h.onEntityEnd(); }
+        void include(std::size_t line, std::string_view path)
+        {
+            h.m_line = line;
+            h.onInclude(path);
+        }
+        bool stopped() const { return h.m_stopped; }
+    };
+
+    /* An '#include' directive met by DomBuilder, in document order */
+    struct IncludeRef
+    {
+        std::string path;               // as written
+        std::size_t line;
+        std::size_t entitiesBefore;     // entities of the same vector defined above it
+    };
+
+    /* Sink building the in-memory tree (AdslDatabase::entities + group definitions).
+     * Fields are collected in a scratch vector and moved into the entity once it
+     * ends, so every fields vector is allocated once at its exact size (which
+     * matters most when the entities live in an arena that never frees). */
+    template<typename GroupFn>
+    class DomBuilder
+    {
+    public:
+        DomBuilder(AdslStableVector<AdslEntity>& entities, GroupFn onGroup)
+            : m_entities(entities), m_onGroup(std::move(onGroup)) {}
+
+        void group(std::size_t, std::string_view name, const std::vector<std::string_view>& values)
+        {
+            AdslGroup g;
+            g.name = toString(name);
+            g.values.reserve(values.size());
+            for (auto v : values) g.values.push_back(toString(v));
+            m_onGroup(std::move(g));
+        }
+
+        void entityBegin(std::size_t, std::string_view type, const std::vector<std::string_view>& groups)
+        {
+            m_current = &m_entities.emplace_back();
+            m_current->type = m_symbols.get(type);
+            m_current->groups.reserve(groups.size());
+            for (auto g : groups) m_current->groups.push_back(m_symbols.get(g));
+        }
+
+        void field(std::size_t, std::string_view name, AdslValue& value, const std::vector<std::string_view>& groups)
+        {
+            /* same resource as the entity : moving it in below steals the groups */
+            AdslField& f = m_fields.emplace_back(m_entities.get_allocator());
+            f.name  = m_symbols.get(name);
+            f.value = std::move(value);
+            f.groups.reserve(groups.size());
+            for (auto g : groups) f.groups.push_back(m_symbols.get(g));
+        }
+
+        /* lazy : 'raw' must outlive the database (AdslDatabase keeps the input) */
+        void field(std::size_t line, std::string_view name, std::string_view& raw, const std::vector<std::string_view>& groups)
+        {
+            AdslValue empty;
+            field(line, name, empty, groups);
+            FieldAccess::setRaw(m_fields.back(), raw, line);
+        }
+
+        void entityEnd()
+        {
+            m_current->fields.reserve(m_fields.size());
+            for (auto& f : m_fields) m_current->fields.push_back(std::move(f));
+            m_fields.clear();
+        }
+
+        /* recorded only : resolveIncludes (adsl_include.hpp) splices the files in */
+        void include(std::size_t line, std::string_view path)
+        {
+            m_includes.push_back(IncludeRef{ toString(path), line, m_entities.size() });
+        }
+
+        bool stopped() const { return false; }
+
+        const std::vector<IncludeRef>& includes() const { return m_includes; }
+
+    private:
+        AdslStableVector<AdslEntity>& m_entities;
+        GroupFn                       m_onGroup;
+        AdslEntity*                   m_current = nullptr;  // entities never move
+        std::vector<AdslField>        m_fields;             // fields of m_current, reused
+        SymbolCache                   m_symbols;
+        std::vector<IncludeRef>       m_includes;
+    };
+
+    template<typename GroupFn>
+    DomBuilder<GroupFn> makeDomBuilder(AdslStableVector<AdslEntity>& entities, GroupFn onGroup)
+    {
+        return DomBuilder<GroupFn>(entities, std::move(onGroup));
+    }
+
+    /* Run fn(i) for i in [0,n) on 'threads' workers pulling indices from a shared counter */
+    template<typename Fn>
+    void parallelFor(std::size_t n, unsigned threads, Fn&& fn)
+    {
+        std::atomic<std::size_t> next{0};
+        auto worker = [&]{
+            for (std::size_t i = next++; i < n; i = next++) fn(i);
+        };
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < threads && t < n; ++t) pool.emplace_back(worker);
+        worker();
+        for (auto& th : pool) th.join();
+    }
+
+} // namespace detail
+} // namespace adsl
+
+#endif // ADSL_PARSER_HPP
@@ -0,0 +1,329 @@
+#include "../include/adsl/adsl_query.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+using namespace adsl;
+
+/* ******************************************************************** */
+/*  ------------------------------ Query ------------------------------ */
+/* ******************************************************************** */
+
+Query& Query::type(std::string_view type)
+{
+    m_type = AdslSymbol(type);
+    return *this;
+}
+
+Query& Query::inGroup(std::string_view group)
+{
+    m_groups.emplace_back(group);
+    return *this;
+}
+
+Query& Query::add(std::string_view field, Kind kind, CmpOp op)
+{
+    Predicate& p = m_predicates.emplace_back();
+    p.field = AdslSymbol(field);
+    p.kind  = kind;
+    p.op    = op;
+    return *this;
+}
+
+Query& Query::has(std::string_view field)
+{
+    return add(field, Kind::Has, CmpOp::Eq);
+}
+
+Query& Query::where(std::string_view field, CmpOp op, std::int64_t value)
+{
+    add(field, Kind::Number, op);
+    m_predicates.back().number   = static_cast<double>(value);
+    m_predicates.back().integer  = value;
+    m_predicates.back().integral = true;
+    return *this;
+}
+
+Query& Query::where(std::string_view field, CmpOp op, double value)
+{
+    add(field, Kind::Number, op);
+    m_predicates.back().number = value;
+    return *this;
+}
+
+Query& Query::where(std::string_view field, CmpOp op, bool value)
+{
+    add(field, Kind::Bool, op);
+    m_predicates.back().flag = value;
+    return *this;
+}
+
+Query& Query::where(std::string_view field, CmpOp op, std::string_view value)
+{
+    add(field, Kind::String, op);
+    m_predicates.back().text = std::string(value);
+    return *this;
+}
+
+Query& Query::contains(std::string_view field, std::int64_t value)
+{
+    add(field, Kind::ContainsNumber, CmpOp::Eq);
+    m_predicates.back().number   = static_cast<double>(value);
+    m_predicates.back().integer  = value;
+    m_predicates.back().integral = true;
+    return *this;
+}
+
+Query& Query::contains(std::string_view field, double value)
+{
+    add(field, Kind::ContainsNumber, CmpOp::Eq);
+    m_predicates.back().number = value;
+    return *this;
+}
+
+Query& Query::contains(std::string_view field, bool value)
+{
+    add(field, Kind::ContainsBool, CmpOp::Eq);
+    m_predicates.back().flag = value;
+    return *this;
+}
+
+Query& Query::contains(std::string_view field, std::string_view value)
+{
+    add(field, Kind::ContainsString, CmpOp::Eq);
+    m_predicates.back().text = std::string(value);
+    return *this;
+}
+
+QueryPlan Query::compile() const
+{
+    /* rough cost of one test : cheap scalar compares first, list walks last */
+    auto cost = [](Kind k) {
+        switch (k) {
+            case Kind::Has:    return 0;
+            case Kind::Bool:   return 1;
+            case Kind::Number: return 2;
+            case Kind::String: return 3;
+            default:           return 4;
+        }
+    };
+
+    QueryPlan plan;
+    plan.m_type       = m_type;
+    plan.m_groups     = m_groups;
+    plan.m_predicates = m_predicates;
+    std::stable_sort(plan.m_predicates.begin(), plan.m_predicates.end(),
+                     [&](const Predicate& a, const Predicate& b){ return cost(a.kind) < cost(b.kind); });
+    return plan;
+}
+
+/* ******************************************************************** */
+/*  ---------------------------- QueryPlan ---------------------------- */
+/* ******************************************************************** */
+
+namespace {
+
+    /* Calls fn with a comparator for 'op' : the switch runs once per batch, not per entity */
+    template<typename Fn>
+    void withOp(CmpOp op, Fn&& fn)
+    {
+        switch (op) {
+            case CmpOp::Eq: fn([](auto a, auto b){ return a == b; }); break;
+            case CmpOp::Ne: fn([](auto a, auto b){ return a != b; }); break;
+            case CmpOp::Lt: fn([](auto a, auto b){ return a <  b; }); break;
+            case CmpOp::Le: fn([](auto a, auto b){ return a <= b; }); break;
+            case CmpOp::Gt: fn([](auto a, auto b){ return a >  b; }); break;
+            case CmpOp::Ge: fn([](auto a, auto b){ return a >= b; }); break;
+        }
+    }
+
+    /* Entities of a type share their layout : try the slot the field had last time */
+    const AdslField* findField(const AdslEntity& e, AdslSymbol name, std::size_t& hint)
+    {
+        if (hint < e.fields.size() && e.fields[hint].name == name && !e.fields[hint].removed()) return &e.fields[hint];
+        for (std::size_t i = 0; i < e.fields.size(); ++i)
+            if (e.fields[i].name == name && !e.fields[i].removed()) { hint = i; return &e.fields[i]; }
+        return nullptr;
+    }
+
+    /* Keeps the entries of sel[0..n) for which test(entity) holds; returns the new n */
+    template<typename Test>
+    std::size_t keepIf(const AdslDatabase& db, std::size_t* sel, std::size_t n, Test test)
+    {
+        std::size_t out = 0;
+        for (std::size_t i = 0; i < n; ++i)
+            if (test(db.entities[sel[i]])) sel[out++] = sel[i];
+        return out;
+    }
+
+    /* a list of another type is an empty span */
+    template<typename T, typename X>
+    bool inList(AdslSpan<T> list, const X& x) { return std::find(list.begin(), list.end(), x) != list.end(); }
+
+    bool listHas(const AdslValue& v, bool x)               { return inList(v.bools(), x); }
+    bool listHas(const AdslValue& v, int x)                { return inList(v.ints(), x); }
+    bool listHas(const AdslValue& v, std::int64_t x)       { return inList(v.int64s(), x); }
+    bool listHas(const AdslValue& v, float x)              { return inList(v.floats(), x); }
+    bool listHas(const AdslValue& v, double x)             { return inList(v.doubles(), x); }
+    bool listHas(const AdslValue& v, const std::string& x) { return inList(v.strings(), std::string_view(x)); }
+}
+
+std::size_t QueryPlan::next(const AdslDatabase& db, Cursor& cursor, std::size_t* out) const
+{
+    if (!cursor.started)
+    {
+        /* drive from the smallest index list; no index -> scan every entity */
+        cursor.started = true;
+        cursor.driver  = m_type ? db.indexedByType(*m_type) : nullptr;
+        for (AdslSymbol g : m_groups) {
+            const std::vector<std::size_t>* list = db.indexedByGroup(g);
+            if (list && (!cursor.driver || list->size() < cursor.driver->size())) cursor.driver = list;
+        }
+        cursor.hints.assign(m_predicates.size(), 0);
+    }
+
+    const std::size_t total = cursor.driver ? cursor.driver->size() : db.entities.size();
+    std::size_t n = 0;
+    while (n == 0 && cursor.position < total)
+    {
+        n = std::min(kBatch, total - cursor.position);
+        for (std::size_t i = 0; i < n; ++i)
+            out[i] = cursor.driver ? (*cursor.driver)[cursor.position + i] : cursor.position + i;
+        cursor.position += n;
+
+        if (db.removedEntities())
+            n = keepIf(db, out, n, [](const AdslEntity& e){ return !e.removed(); });
+        if (m_type) {
+            AdslSymbol type = *m_type;
+            n = keepIf(db, out, n, [type](const AdslEntity& e){ return e.type == type; });
+        }
+        for (AdslSymbol g : m_groups)
+            n = keepIf(db, out, n, [g](const AdslEntity& e){
+                return std::find(e.groups.begin(), e.groups.end(), g) != e.groups.end();
+            });
+
+        for (std::size_t k = 0; k < m_predicates.size() && n; ++k)
+        {
+            const Query::Predicate& p = m_predicates[k];
+            std::size_t& hint = cursor.hints[k];
+            auto field = [&](const AdslEntity& e){ return findField(e, p.field, hint); };
+
+            switch (p.kind)
+            {
+            case Query::Kind::Has:
+                n = keepIf(db, out, n, [&](const AdslEntity& e){ return field(e) != nullptr; });
+                break;
+
+            case Query::Kind::Bool:
+                withOp(p.op, [&](auto cmp){
+                    n = keepIf(db, out, n, [&](const AdslEntity& e){
+                        const AdslField* f = field(e);
+                        if (!f || f->get().type() != AdslValueType::Bool) return false;
+                        return cmp(int(f->get().asBool()), int(p.flag));
+                    });
+                });
+                break;
+
+            case Query::Kind::Number:
+            {
+                /* float fields compare in float precision, like adsl::Column */
+                const double x  = p.number;
+                const float  xf = static_cast<float>(p.number);
+                withOp(p.op, [&](auto cmp){
+                    n = keepIf(db, out, n, [&](const AdslEntity& e){
+                        const AdslField* f = field(e);
+                        if (!f) return false;
+                        const AdslValue& value = f->get();
+                        switch (value.type()) {
+                            case AdslValueType::Int:    return cmp(double(value.asInt()), x);
+                            case AdslValueType::Float:  return cmp(value.asFloat(), xf);
+                            case AdslValueType::Int64:
+                                return p.integral ? cmp(value.asInt64(), p.integer) : cmp(double(value.asInt64()), x);
+                            case AdslValueType::Double: return cmp(value.asDouble(), x);
+                            default:                    return false;
+                        }
+                    });
+                });
+                break;
+            }
+
+            case Query::Kind::String:
+                withOp(p.op, [&](auto cmp){
+                    n = keepIf(db, out, n, [&](const AdslEntity& e){
+                        const AdslField* f = field(e);
+                        if (!f || f->get().type() != AdslValueType::String) return false;
+                        return cmp(f->get().asString().compare(p.text), 0);
+                    });
+                });
+                break;
+
+            case Query::Kind::ContainsBool:
+                n = keepIf(db, out, n, [&](const AdslEntity& e){
+                    const AdslField* f = field(e);
+                    return f && listHas(f->get(), p.flag);
+                });
+                break;
+
+            case Query::Kind::ContainsNumber:
+            {
+                const double x  = p.number;
+                const float  xf = static_cast<float>(p.number);
+                const bool   whole = p.integral || (x >= -0x1p63 && x < 0x1p63 && x == std::floor(x));
+                const std::int64_t xi = p.integral ? p.integer : whole ? std::int64_t(x) : 0;
+                const bool   inInt = whole && xi >= INT_MIN && xi <= INT_MAX;
+                n = keepIf(db, out, n, [&](const AdslEntity& e){
+                    const AdslField* f = field(e);
+                    if (!f) return false;
+                    const AdslValue& value = f->get();
+                    return (inInt && listHas(value, int(xi))) || (whole && listHas(value, xi))
+                        || listHas(value, xf) || listHas(value, x);
+                });
+                break;
+            }
+
+            case Query::Kind::ContainsString:
+                n = keepIf(db, out, n, [&](const AdslEntity& e){
+                    const AdslField* f = field(e);
+                    return f && listHas(f->get(), p.text);
+                });
+                break;
+            }
+        }
+    }
+    return n;
+}
+
+std::vector<std::size_t> QueryPlan::indices(const AdslDatabase& db) const
+{
+    std::vector<std::size_t> res;
+    Cursor cursor;
+    std::size_t batch[kBatch];
+    for (std::size_t n; (n = next(db, cursor, batch)) != 0; )
+        res.insert(res.end(), batch, batch + n);
+    return res;
+}
+
+std::vector<const AdslEntity*> QueryPlan::entities(const AdslDatabase& db) const
+{
+    std::vector<const AdslEntity*> res;
+    forEach(db, [&res](const AdslEntity& e){ res.push_back(&e); });
+    return res;
+}
+
+std::vector<AdslEntity*> QueryPlan::entities(AdslDatabase& db) const
+{
+    std::vector<AdslEntity*> res;
+    for (std::size_t i : indices(db)) res.push_back(&db.entities[i]);
+    return res;
+}
+
+std::size_t QueryPlan::count(const AdslDatabase& db) const
+{
+    std::size_t total = 0;
+    Cursor cursor;
+    std::size_t batch[kBatch];
+    for (std::size_t n; (n = next(db, cursor, batch)) != 0; )
+        total += n;
+    return total;
+}
@@ -0,0 +1,196 @@
+#include "adsl_scan.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #include <immintrin.h>
+    #define ADSL_SCAN_X86 1
+    #if defined(__GNUC__) || defined(__clang__)
+        #define ADSL_TARGET_AVX2 __attribute__((target("avx2")))
+    #else
+        #define ADSL_TARGET_AVX2
+    #endif
+#endif
+
+using namespace adsl::detail;
+
+namespace {
+
+    /* Classifies 'blocks' whole 64-byte blocks, one word per block in each output */
+    using Kernel = void (*)(const char* p, std::size_t blocks,
+                            std::uint64_t* newline, std::uint64_t* nonSpace,
+                            std::uint64_t* quote, std::uint64_t* slash);
+
+#ifdef ADSL_SCAN_X86
+
+    /* isspace() in the C locale : ' ' or '\t'..'\r'. SSE2 has no unsigned compare,
+     * so c - 9 <= 4 is tested as min(c - 9, 4) == c - 9. */
+    inline __m128i spaces16(__m128i v)
+    {
+        __m128i r = _mm_sub_epi8(v, _mm_set1_epi8(9));
+        return _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                            _mm_cmpeq_epi8(_mm_min_epu8(r, _mm_set1_epi8(4)), r));
+    }
+
+    inline std::uint64_t bits16(__m128i a, __m128i b, __m128i c, __m128i d)
+    {
+        return  std::uint64_t(std::uint16_t(_mm_movemask_epi8(a)))
+             | (std::uint64_t(std::uint16_t(_mm_movemask_epi8(b))) << 16)
+             | (std::uint64_t(std::uint16_t(_mm_movemask_epi8(c))) << 32)
+             | (std::uint64_t(std::uint16_t(_mm_movemask_epi8(d))) << 48);
+    }
+
+    void kernelSSE2(const char* p, std::size_t blocks,
+                    std::uint64_t* newline, std::uint64_t* nonSpace, std::uint64_t* quote, std::uint64_t* slash)
+    {
+        const __m128i nl = _mm_set1_epi8('\n'), qt = _mm_set1_epi8('"'), sl = _mm_set1_epi8('/');
+        for (std::size_t k = 0; k < blocks; ++k, p += 64)
+        {
+            __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16));
+            __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 32));
+            __m128i v3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 48));
+            newline[k]  =  bits16(_mm_cmpeq_epi8(v0, nl), _mm_cmpeq_epi8(v1, nl), _mm_cmpeq_epi8(v2, nl), _mm_cmpeq_epi8(v3, nl));
+            nonSpace[k] = ~bits16(spaces16(v0), spaces16(v1), spaces16(v2), spaces16(v3));
+            quote[k]    =  bits16(_mm_cmpeq_epi8(v0, qt), _mm_cmpeq_epi8(v1, qt), _mm_cmpeq_epi8(v2, qt), _mm_cmpeq_epi8(v3, qt));
+            slash[k]    =  bits16(_mm_cmpeq_epi8(v0, sl), _mm_cmpeq_epi8(v1, sl), _mm_cmpeq_epi8(v2, sl), _mm_cmpeq_epi8(v3, sl));
+        }
+    }
+
+    ADSL_TARGET_AVX2 inline __m256i spaces32(__m256i v)
+    {
+        __m256i r = _mm256_sub_epi8(v, _mm256_set1_epi8(9));
+        return _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                               _mm256_cmpeq_epi8(_mm256_min_epu8(r, _mm256_set1_epi8(4)), r));
+    }
+
+    ADSL_TARGET_AVX2 inline std::uint64_t bits32(__m256i lo, __m256i hi)
+    {
+        return std::uint64_t(std::uint32_t(_mm256_movemask_epi8(lo)))
+            | (std::uint64_t(std::uint32_t(_mm256_movemask_epi8(hi))) << 32);
+    }
+
+    ADSL_TARGET_AVX2
+    void kernelAVX2(const char* p, std::size_t blocks,
+                    std::uint64_t* newline, std::uint64_t* nonSpace, std::uint64_t* quote, std::uint64_t* slash)
+    {
+        const __m256i nl = _mm256_set1_epi8('\n'), qt = _mm256_set1_epi8('"'), sl = _mm256_set1_epi8('/');
+        for (std::size_t k = 0; k < blocks; ++k, p += 64)
+        {
+            __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+            newline[k]  =  bits32(_mm256_cmpeq_epi8(lo, nl), _mm256_cmpeq_epi8(hi, nl));
+            nonSpace[k] = ~bits32(spaces32(lo), spaces32(hi));
+            quote[k]    =  bits32(_mm256_cmpeq_epi8(lo, qt), _mm256_cmpeq_epi8(hi, qt));
+            slash[k]    =  bits32(_mm256_cmpeq_epi8(lo, sl), _mm256_cmpeq_epi8(hi, sl));
+        }
+    }
+
+    bool cpuHasAVX2()
+    {
+    #if defined(__GNUC__) || defined(__clang__)
+        return __builtin_cpu_supports("avx2");
+    #else
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        if (!osxsave || (_xgetbv(0) & 6) != 6) return false;    // OS saves the YMM registers
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    #endif
+    }
+
+#endif // ADSL_SCAN_X86
+
+    ScanLevel bestLevel()
+    {
+#ifdef ADSL_SCAN_X86
+        return cpuHasAVX2() ? ScanLevel::AVX2 : ScanLevel::SSE2;
+#else
+        return ScanLevel::Scalar;
+#endif
+    }
+
+    std::atomic<ScanLevel>& currentLevel()
+    {
+        static std::atomic<ScanLevel> level{ bestLevel() };
+        return level;
+    }
+
+    Kernel kernelFor(ScanLevel level)
+    {
+#ifdef ADSL_SCAN_X86
+        if (level == ScanLevel::AVX2) return kernelAVX2;
+        if (level == ScanLevel::SSE2) return kernelSSE2;
+#endif
+        (void)level;
+        return nullptr;
+    }
+}
+
+ScanLevel adsl::detail::scanLevel()
+{
+    return currentLevel().load(std::memory_order_relaxed);
+}
+
+ScanLevel adsl::detail::setScanLevel(ScanLevel level)
+{
+    if (int(level) > int(bestLevel())) level = bestLevel();
+    currentLevel().store(level, std::memory_order_relaxed);
+    return level;
+}
+
+void StructuralIndex::build(const char* data, std::size_t size)
+{
+    Kernel kernel = kernelFor(scanLevel());
+    const std::size_t full   = size / 64;
+    const std::size_t blocks = (size + 63) / 64;
+
+    m_size = size;
+    m_newline.resize(blocks);
+    m_nonSpace.resize(blocks);
+    m_quote.resize(blocks);
+    m_comment.resize(blocks + 1);                       // + a zero word for the pass below
+
+    if (!kernel) {
+        /* not used by the parser at this level; kept correct for completeness */
+        std::fill(m_newline.begin(), m_newline.end(), 0);
+        std::fill(m_nonSpace.begin(), m_nonSpace.end(), 0);
+        std::fill(m_quote.begin(), m_quote.end(), 0);
+        std::fill(m_comment.begin(), m_comment.end(), 0);
+        for (std::size_t i = 0; i < size; ++i) {
+            char c = data[i];
+            std::uint64_t bit = std::uint64_t(1) << (i & 63);
+            if (c == '\n') m_newline[i >> 6] |= bit;
+            if (!(c == ' ' || (c >= '\t' && c <= '\r'))) m_nonSpace[i >> 6] |= bit;
+            if (c == '"') m_quote[i >> 6] |= bit;
+            if (c == '/') m_comment[i >> 6] |= bit;
+        }
+    } else {
+        kernel(data, full, m_newline.data(), m_nonSpace.data(), m_quote.data(), m_comment.data());
+        if (blocks > full) {
+            /* tail padded with spaces : no class but "space" */
+            char tail[64];
+            std::memset(tail, ' ', sizeof(tail));
+            std::memcpy(tail, data + full * 64, size - full * 64);
+            kernel(tail, 1, &m_newline[full], &m_nonSpace[full], &m_quote[full], &m_comment[full]);
+        }
+    }
+
+    /* "//" : a slash followed by a slash, possibly at the start of the next block */
+    m_comment[blocks] = 0;
+    for (std::size_t k = 0; k < blocks; ++k)
+        m_comment[k] &= (m_comment[k] >> 1) | (m_comment[k + 1] << 63);
+}
+
+std::size_t StructuralIndex::lastNewline() const
+{
+    for (std::size_t k = m_newline.size(); k-- > 0; )
+        if (m_newline[k]) return (k << 6) + highestBit(m_newline[k]);
+    return npos;
+}
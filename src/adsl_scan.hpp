@@ -0,0 +1,108 @@
+#ifndef ADSL_SCAN_HPP
+#define ADSL_SCAN_HPP
+
+/* Internal : structural index for the line parser.
+ *
+ * A first pass classifies a window of text 64 bytes at a time with SIMD
+ * compares and stores one bit per byte for each class the grammar needs
+ * before it can look at a line :
+ *     newline    '\n'                      -> line boundaries
+ *     nonSpace   not isspace() (C locale)  -> trimming
+ *     quote      '"'                       -> comment markers inside strings
+ *     comment    first '/' of "//"         -> comment stripping
+ * The line parser then finds, trims and strips each line with a few word
+ * operations on these bitmaps instead of looking at every character.
+ *
+ * The kernel is picked once at run time (AVX2, else SSE2). Without either,
+ * scanLevel() is Scalar and the parser keeps its character loop.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+namespace adsl {
+namespace detail {
+
+    /* index of the lowest / highest set bit (bits != 0) */
+    inline unsigned lowestBit(std::uint64_t bits)
+    {
+#ifdef _MSC_VER
+        unsigned long i; _BitScanForward64(&i, bits); return unsigned(i);
+#else
+        return unsigned(__builtin_ctzll(bits));
+#endif
+    }
+    inline unsigned highestBit(std::uint64_t bits)
+    {
+#ifdef _MSC_VER
+        unsigned long i; _BitScanReverse64(&i, bits); return unsigned(i);
+#else
+        return 63u - unsigned(__builtin_clzll(bits));
+#endif
+    }
+
+    enum class ScanLevel { Scalar, SSE2, AVX2 };
+
+    ScanLevel scanLevel();                  // what the parser uses (best supported by default)
+    ScanLevel setScanLevel(ScanLevel level);// clamps to what the CPU supports; returns the level set
+
+    class StructuralIndex
+    {
+    public:
+        static constexpr std::size_t npos = std::size_t(-1);
+
+        // Classify data[0, size); positions below are relative to data
+        void build(const char* data, std::size_t size);
+
+        std::size_t size() const { return m_size; }
+
+        std::size_t nextNewline (std::size_t from) const { return firstSet(m_newline.data(), from, m_size); }
+        std::size_t lastNewline () const;                                       // npos if none
+        std::size_t firstNonSpace(std::size_t from, std::size_t to) const { return firstSet(m_nonSpace.data(), from, to); }
+        std::size_t endNonSpace (std::size_t from, std::size_t to) const;       // one past the last, 'from' if none
+        std::size_t firstComment(std::size_t from, std::size_t to) const { return firstSet(m_comment.data(), from, to); }
+        bool        hasQuote    (std::size_t from, std::size_t to) const { return firstSet(m_quote.data(), from, to) != to; }
+
+    private:
+        /* first set bit in [from, to), 'to' if none */
+        static std::size_t firstSet(const std::uint64_t* bits, std::size_t from, std::size_t to);
+
+        std::size_t                m_size = 0;
+        std::vector<std::uint64_t> m_newline, m_nonSpace, m_quote, m_comment;
+    };
+
+    inline std::size_t StructuralIndex::firstSet(const std::uint64_t* bits, std::size_t from, std::size_t to)
+    {
+        if (from >= to) return to;
+        std::size_t   word = from >> 6;
+        std::uint64_t w    = bits[word] & (~std::uint64_t(0) << (from & 63));
+        while (!w) {
+            if ((++word << 6) >= to) return to;
+            w = bits[word];
+        }
+        std::size_t pos = (word << 6) + lowestBit(w);
+        return pos < to ? pos : to;
+    }
+
+    inline std::size_t StructuralIndex::endNonSpace(std::size_t from, std::size_t to) const
+    {
+        if (from >= to) return from;
+        std::size_t   word = (to - 1) >> 6;
+        std::uint64_t w    = m_nonSpace[word] & (~std::uint64_t(0) >> (63 - ((to - 1) & 63)));
+        while (!w) {
+            if ((word << 6) <= from) return from;
+            w = m_nonSpace[--word];
+        }
+        std::size_t pos = (word << 6) + highestBit(w);
+        return pos >= from ? pos + 1 : from;
+    }
+
+} // namespace detail
+} // namespace adsl
+
+#endif // ADSL_SCAN_HPP
@@ -0,0 +1,157 @@
+#ifndef ADSL_STATS_HPP
+#define ADSL_STATS_HPP
+
+/* Internal : what the instrumented parse (AdslParseStats) is built from.
+ *
+ * Only the overloads taking an AdslParseStats* instantiate anything below;
+ * the plain entry points compile the parser with PlainDecoder and the bare
+ * DOM builder, as before.
+ *
+ * Timings are taken with a cycle counter where there is one (a few ns per
+ * read, against ~20 for steady_clock), and scaled to nanoseconds with the
+ * steady_clock time of the whole parse.
+ */
+
+#include "../include/adsl/adsl.hpp"
+#include "adsl_parser.hpp"
+
+#include <chrono>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+#endif
+
+namespace adsl {
+namespace detail {
+
+    inline std::uint64_t ticks()
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::uint64_t(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    /* Heap blocks, counted the way the containers allocate them */
+    struct HeapUse
+    {
+        std::size_t blocks = 0;
+        std::size_t bytes  = 0;
+
+        void add(std::size_t n) { if (n) { ++blocks; bytes += n; } }
+
+        template<typename T, typename A>
+        void addVector(const std::vector<T, A>& v) { add(v.capacity() * sizeof(T)); }
+
+        void addString(const std::string& s)
+        {
+            static const std::size_t inlineCapacity = std::string().capacity();
+            if (s.capacity() > inlineCapacity) add(s.capacity() + 1);
+        }
+
+        void addValue(const AdslValue& v);                  // adsl.cpp
+        void addGroup(const AdslGroup& g)
+        {
+            addString(g.name);
+            addVector(g.values);
+            for (const std::string& s : g.values) addString(s);
+        }
+    };
+
+    /* PlainDecoder (adsl_parser.hpp), timed */
+    struct TimedDecoder
+    {
+        std::uint64_t* ticks;
+        Arena*         arena = nullptr;
+        AdslValue operator()(std::string_view raw) const
+        {
+            std::uint64_t t = detail::ticks();
+            AdslValue v = parseValue(raw, arena);
+            *ticks += detail::ticks() - t;
+            return v;
+        }
+    };
+
+    /* Wraps a DOM builder : counts what goes through it, times it, and accounts
+     * for the blocks the database allocates to store it. */
+    template<typename Builder>
+    class StatsSink
+    {
+    public:
+        StatsSink(Builder& builder, AdslDatabase& db, AdslParseStats& stats)
+            : m_builder(builder), m_db(db), m_stats(stats) {}
+
+        void group(std::size_t line, std::string_view name, const std::vector<std::string_view>& values)
+        {
+            std::uint64_t t = ticks();
+            std::size_t known = m_db.groups.size();
+            m_builder.group(line, name, values);
+            auto it = m_db.groups.find(std::string(name));
+            if (it != m_db.groups.end()) m_heap.addGroup(it->second);
+            if (m_db.groups.size() != known) m_heap.add(sizeof(std::pair<const std::string, AdslGroup>) + 2 * sizeof(void*));
+            ++m_stats.groups;
+            m_buildTicks += ticks() - t;
+        }
+
+        void entityBegin(std::size_t line, std::string_view type, const std::vector<std::string_view>& groups)
+        {
+            std::uint64_t t = ticks();
+            std::size_t capacity = m_db.entities.capacity();
+            m_builder.entityBegin(line, type, groups);
+            m_heap.add((m_db.entities.capacity() - capacity) * sizeof(AdslEntity));   // a new segment, if any
+            m_heap.add(groups.size() * sizeof(AdslSymbol));
+            ++m_stats.entities;
+            m_buildTicks += ticks() - t;
+        }
+
+        void field(std::size_t line, std::string_view name, AdslValue& value, const std::vector<std::string_view>& groups)
+        {
+            std::uint64_t t = ticks();
+            ++m_stats.values[static_cast<std::size_t>(getAdslValueType(value))];
+            m_heap.addValue(value);
+            m_heap.add(groups.size() * sizeof(AdslSymbol));
+            m_builder.field(line, name, value, groups);
+            ++m_stats.fields;
+            ++m_entityFields;
+            m_buildTicks += ticks() - t;
+        }
+
+        void entityEnd()
+        {
+            std::uint64_t t = ticks();
+            m_builder.entityEnd();
+            closeEntity();
+            m_buildTicks += ticks() - t;
+        }
+
+        void include(std::size_t line, std::string_view path) { m_builder.include(line, path); }
+
+        bool stopped() const { return m_builder.stopped(); }
+
+        std::uint64_t  buildTicks() const { return m_buildTicks; }
+        const HeapUse& heap()       const { return m_heap; }
+
+    private:
+        void closeEntity()
+        {
+            m_heap.add(m_entityFields * sizeof(AdslField));     // fields vector, reserved at its size
+            m_entityFields = 0;
+        }
+
+        Builder&        m_builder;
+        AdslDatabase&   m_db;
+        AdslParseStats& m_stats;
+        HeapUse         m_heap;
+        std::uint64_t   m_buildTicks   = 0;
+        std::size_t     m_entityFields = 0;
+    };
+
+} // namespace detail
+} // namespace adsl
+
+#endif // ADSL_STATS_HPP
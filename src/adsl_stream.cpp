@@ -0,0 +1,183 @@
+#include "../include/adsl/adsl_stream.hpp"
+#include "adsl_arena.hpp"
+#include "adsl_include.hpp"
+#include "adsl_parser.hpp"
+
+#include <stdexcept>
+
+using namespace adsl;
+using namespace adsl::detail;
+
+/* ******************************************************************** */
+/*  ----------------------------- Targets ----------------------------- */
+/* ******************************************************************** */
+
+struct adsl::detail::StreamTarget
+{
+    virtual ~StreamTarget() = default;
+    virtual void        parse(std::string_view lines) = 0;     // whole lines (the last one may be cut at finish)
+    virtual void        finish() = 0;
+    virtual bool        stopped() const = 0;
+    virtual std::size_t line() const = 0;
+};
+
+namespace {
+
+    class HandlerTarget : public StreamTarget
+    {
+    public:
+        explicit HandlerTarget(AdslHandler& handler) : m_sink{ handler }, m_parser(m_sink) {}
+
+        void        parse(std::string_view lines) override { m_parser.parse(lines); }
+        void        finish() override                      { m_parser.finish(); }
+        bool        stopped() const override               { return m_parser.stopped(); }
+        std::size_t line() const override                  { return m_parser.line(); }
+
+    private:
+        HandlerAccess               m_sink;
+        LineParser<HandlerAccess>   m_parser;
+    };
+
+    /* DomBuilder, indexing every entity as soon as it is closed */
+    class DatabaseTarget : public StreamTarget
+    {
+    public:
+        DatabaseTarget(AdslDatabase& db, std::function<void(std::size_t)> onEntity)
+            : m_db(db)
+            , m_onEntity(std::move(onEntity))
+            , m_builder(db.entities, GroupSink{ &db })
+            , m_sink{ this }
+            , m_parser(m_sink, 0, PlainDecoder{ dynamic_cast<Arena*>(db.resource()) })
+        {
+        }
+
+        void        parse(std::string_view lines) override { m_parser.parse(lines); }
+        bool        stopped() const override               { return false; }
+        std::size_t line() const override                  { return m_parser.line(); }
+
+        void finish() override
+        {
+            m_parser.finish();
+            if (!m_builder.includes().empty()) {
+                resolveIncludes(m_db, m_builder.includes(), std::string());
+                m_db.reindex();
+            }
+        }
+
+    private:
+        /* definitions go straight to db.groups (last one wins) */
+        struct GroupSink
+        {
+            AdslDatabase* db;
+            void operator()(AdslGroup&& g) const
+            {
+                std::string name = g.name;
+                db->groups[name] = std::move(g);
+            }
+        };
+
+        struct Sink
+        {
+            DatabaseTarget* t;
+
+            void group(std::size_t line, std::string_view name, const std::vector<std::string_view>& values)
+            {
+                t->m_builder.group(line, name, values);
+            }
+            void entityBegin(std::size_t line, std::string_view type, const std::vector<std::string_view>& groups)
+            {
+                t->m_builder.entityBegin(line, type, groups);
+            }
+            void field(std::size_t line, std::string_view name, AdslValue& value, const std::vector<std::string_view>& groups)
+            {
+                t->m_builder.field(line, name, value, groups);
+            }
+            void entityEnd()
+            {
+                t->m_builder.entityEnd();
+                std::size_t entity = t->m_db.entities.size() - 1;
+                t->m_db.indexEntity(entity);
+                if (t->m_onEntity) t->m_onEntity(entity);
+            }
+            void include(std::size_t line, std::string_view path) { t->m_builder.include(line, path); }
+            bool stopped() const { return false; }
+        };
+
+        AdslDatabase&                    m_db;
+        std::function<void(std::size_t)> m_onEntity;
+        DomBuilder<GroupSink>            m_builder;
+        Sink                             m_sink;
+        LineParser<Sink>                 m_parser;
+    };
+
+} // namespace
+
+/* ******************************************************************** */
+/*  -------------------------- StreamParser --------------------------- */
+/* ******************************************************************** */
+
+StreamParser::StreamParser(AdslHandler& handler)
+    : m_target(new HandlerTarget(handler))
+{
+}
+
+StreamParser::StreamParser(AdslDatabase& db, std::function<void(std::size_t)> onEntity)
+{
+    db.clear();
+    m_target.reset(new DatabaseTarget(db, std::move(onEntity)));
+}
+
+StreamParser::~StreamParser() = default;
+
+/* A failed parse leaves the parser mid-line : nothing sensible can follow */
+void StreamParser::parse(std::string_view lines)
+{
+    try {
+        m_target->parse(lines);
+    } catch (...) {
+        m_done = true;
+        throw;
+    }
+}
+
+/* Complete lines are parsed from 'data' in place; only a line still open at
+ * either end goes through m_tail. */
+void StreamParser::feed(const char* data, std::size_t size)
+{
+    if (m_done) throw std::logic_error("StreamParser::feed after finish() or an error");
+    if (m_target->stopped()) return;
+
+    std::string_view in(data, size);
+    if (!m_tail.empty())
+    {
+        std::size_t nl = in.find('\n');
+        if (nl == std::string_view::npos) { m_tail.append(in); return; }
+        m_tail.append(in.substr(0, nl + 1));
+        parse(m_tail);
+        m_tail.clear();
+        in.remove_prefix(nl + 1);
+    }
+
+    std::size_t last = in.rfind('\n');
+    if (last == std::string_view::npos) { m_tail.assign(in); return; }
+    parse(in.substr(0, last + 1));
+    m_tail.assign(in.substr(last + 1));
+}
+
+bool StreamParser::finish()
+{
+    if (m_done) throw std::logic_error("StreamParser::finish after finish() or an error");
+    m_done = true;
+    if (!m_target->stopped()) {
+        if (!m_tail.empty()) parse(m_tail);
+        m_target->finish();
+    }
+    m_tail.clear();
+    m_tail.shrink_to_fit();
+    return true;
+}
+
+std::size_t StreamParser::lines() const
+{
+    return m_target->line();
+}
@@ -0,0 +1,138 @@
+#include "../include/adsl/adsl.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <ostream>
+#include <shared_mutex>
+#include <stdexcept>
+
+/* ******************************************************************** */
+/*  ------------------------- Symbol table  --------------------------- */
+/* ******************************************************************** */
+
+namespace {
+
+/* Process-wide, append-only until reset(). Names live in fixed-size blocks
+ * that are never moved, so id -> string is a lock-free read and the hash map
+ * can key on string_views into the blocks. */
+class SymbolTable
+{
+public:
+    static constexpr std::uint32_t kBlockBits = 12;
+    static constexpr std::uint32_t kBlockSize = 1u << kBlockBits;
+    static constexpr std::uint32_t kMaxBlocks = AdslSymbol::kMaxCount / kBlockSize;
+
+    SymbolTable()
+    {
+        for (auto& b : m_blocks) b.store(nullptr, std::memory_order_relaxed);
+        append("");                                                 // id 0
+    }
+
+    static SymbolTable& instance()
+    {
+        static SymbolTable* table = new SymbolTable;                // never destroyed:
+        return *table;                                              // symbols outlive statics
+    }
+
+    std::uint32_t intern(std::string_view s)
+    {
+        {
+            std::shared_lock<std::shared_mutex> lock(m_mutex);
+            auto it = m_ids.find(s);
+            if (it != m_ids.end()) return it->second;
+        }
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        auto it = m_ids.find(s);
+        if (it != m_ids.end()) return it->second;
+        return append(s);
+    }
+
+    std::optional<std::uint32_t> find(std::string_view s)
+    {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        auto it = m_ids.find(s);
+        if (it == m_ids.end()) return std::nullopt;
+        return it->second;
+    }
+
+    const std::string& name(std::uint32_t id) const
+    {
+        return m_blocks[id >> kBlockBits].load(std::memory_order_acquire)[id & (kBlockSize - 1)];
+    }
+
+    std::size_t count()
+    {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        return m_count;
+    }
+
+    /* frees every block; the caller guarantees no old id is read again */
+    void reset()
+    {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        m_ids.clear();
+        for (auto& b : m_blocks) delete[] b.exchange(nullptr, std::memory_order_acq_rel);
+        m_count = 0;
+        append("");
+    }
+
+private:
+    /* caller holds the unique lock (or is the constructor) */
+    std::uint32_t append(std::string_view s)
+    {
+        std::uint32_t id = m_count;
+        std::uint32_t block = id >> kBlockBits;
+        if (block >= kMaxBlocks)
+            throw std::runtime_error("ADSL symbol table full (see AdslSymbol::reset)");
+
+        std::string* names = m_blocks[block].load(std::memory_order_relaxed);
+        if (!names) names = new std::string[kBlockSize];
+        names[id & (kBlockSize - 1)].assign(s.data(), s.size());
+        m_blocks[block].store(names, std::memory_order_release);
+
+        m_ids.emplace(std::string_view(names[id & (kBlockSize - 1)]), id);
+        ++m_count;
+        return id;
+    }
+
+    std::shared_mutex                                  m_mutex;
+    std::unordered_map<std::string_view, std::uint32_t> m_ids;
+    std::atomic<std::string*>                          m_blocks[kMaxBlocks];
+    std::uint32_t                                      m_count = 0;
+};
+
+} // namespace
+
+AdslSymbol::AdslSymbol(std::string_view s)
+    : m_id(s.empty() ? 0 : SymbolTable::instance().intern(s))
+{
+}
+
+std::optional<AdslSymbol> AdslSymbol::find(std::string_view s)
+{
+    auto id = SymbolTable::instance().find(s);
+    if (!id) return std::nullopt;
+    AdslSymbol sym;
+    sym.m_id = *id;
+    return sym;
+}
+
+std::size_t AdslSymbol::count()
+{
+    return SymbolTable::instance().count();
+}
+
+void AdslSymbol::reset()
+{
+    SymbolTable::instance().reset();
+}
+
+const std::string& AdslSymbol::str() const
+{
+    return SymbolTable::instance().name(m_id);
+}
+
+std::ostream& operator<<(std::ostream& os, AdslSymbol s)
+{
+    return os << s.str();
+}
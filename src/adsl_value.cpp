@@ -0,0 +1,171 @@
+#include "adsl_value.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+using namespace adsl::detail;
+
+static_assert(sizeof(AdslValue) == 16, "AdslValue : 14 bytes of payload, length and tag");
+
+/* ******************************************************************** */
+/*  ------------------------- Value blocks ---------------------------- */
+/* ******************************************************************** */
+
+void* ValueAccess::allocate(AdslValue& v, AdslValueType type, std::size_t count, std::size_t bytes, Arena* arena)
+{
+    if (count > std::numeric_limits<std::uint32_t>::max())
+        throw std::length_error("ADSL value too large");
+
+    void* block = nullptr;
+    std::uint8_t tag = std::uint8_t(type);
+    if (bytes)
+    {
+        if (arena && bytes <= Arena::kLargeAllocation) {
+            block = arena->allocate(bytes, alignof(double));
+            tag |= AdslValue::kBorrowed;
+        } else {
+            block = ::operator new(bytes);
+        }
+    }
+
+    v.release();
+    std::uint32_t n = static_cast<std::uint32_t>(count);
+    std::memcpy(v.m_data, &block, sizeof(block));
+    std::memcpy(v.m_data + sizeof(void*), &n, sizeof(n));
+    v.m_small = type == AdslValueType::String ? AdslValue::kExternal : 0;
+    v.m_tag   = tag;
+    return block;
+}
+
+AdslValue ValueAccess::makeString(std::string_view s, Arena* arena)
+{
+    AdslValue v;
+    if (s.size() <= sizeof(v.m_data)) {
+        std::memcpy(v.m_data, s.data(), s.size());
+        v.m_small = static_cast<std::uint8_t>(s.size());
+        return v;
+    }
+    void* out = allocate(v, AdslValueType::String, s.size(), s.size(), arena);
+    std::memcpy(out, s.data(), s.size());
+    return v;
+}
+
+/* One block : the views first, then the characters they point at */
+AdslValue ValueAccess::makeStrings(AdslSpan<std::string_view> items, Arena* arena)
+{
+    std::size_t chars = 0;
+    for (std::string_view s : items) chars += s.size();
+
+    AdslValue v;
+    std::size_t head = items.size() * sizeof(std::string_view);
+    char* out = static_cast<char*>(allocate(v, AdslValueType::StringList, items.size(), head + chars, arena));
+    std::string_view* views = reinterpret_cast<std::string_view*>(out);
+    char* text = out + head;
+    for (std::size_t i = 0; i < items.size(); ++i)
+    {
+        if (!items[i].empty()) std::memcpy(text, items[i].data(), items[i].size());
+        new (&views[i]) std::string_view(text, items[i].size());
+        text += items[i].size();
+    }
+    return v;
+}
+
+std::size_t ValueAccess::blockBytes(const AdslValue& v)
+{
+    if (!v.hasBlock()) return 0;
+    std::size_t n = v.blockSize();
+    switch (v.type())
+    {
+        case AdslValueType::String:     return n;
+        case AdslValueType::IntList:    return n * sizeof(int);
+        case AdslValueType::FloatList:  return n * sizeof(float);
+        case AdslValueType::BoolList:   return n * sizeof(bool);
+        case AdslValueType::Int64List:  return n * sizeof(std::int64_t);
+        case AdslValueType::DoubleList: return n * sizeof(double);
+        case AdslValueType::StringList: {
+            std::size_t bytes = n * sizeof(std::string_view);
+            for (std::string_view s : v.strings()) bytes += s.size();
+            return bytes;
+        }
+        default:                        return 0;
+    }
+}
+
+/* ******************************************************************** */
+/*  ----------------------------- AdslValue --------------------------- */
+/* ******************************************************************** */
+
+AdslValue::AdslValue(std::string_view s)                   : AdslValue(ValueAccess::makeString(s, nullptr)) {}
+AdslValue::AdslValue(AdslSpan<std::string_view> items)     : AdslValue(ValueAccess::makeStrings(items, nullptr)) {}
+AdslValue::AdslValue(AdslSpan<int> items)                  : AdslValue(ValueAccess::makeList(AdslValueType::IntList, items, nullptr)) {}
+AdslValue::AdslValue(AdslSpan<float> items)                : AdslValue(ValueAccess::makeList(AdslValueType::FloatList, items, nullptr)) {}
+AdslValue::AdslValue(AdslSpan<bool> items)                 : AdslValue(ValueAccess::makeList(AdslValueType::BoolList, items, nullptr)) {}
+AdslValue::AdslValue(AdslSpan<std::int64_t> items)         : AdslValue(ValueAccess::makeList(AdslValueType::Int64List, items, nullptr)) {}
+AdslValue::AdslValue(AdslSpan<double> items)               : AdslValue(ValueAccess::makeList(AdslValueType::DoubleList, items, nullptr)) {}
+
+AdslValue::AdslValue(const std::vector<std::string>& items) : AdslValue()
+{
+    std::vector<std::string_view> views(items.begin(), items.end());
+    *this = ValueAccess::makeStrings(AdslSpan<std::string_view>(views.data(), views.size()), nullptr);
+}
+
+AdslValue::AdslValue(const std::vector<bool>& items) : AdslValue()
+{
+    bool* out = ValueAccess::makeList<bool>(*this, AdslValueType::BoolList, items.size(), nullptr);
+    std::copy(items.begin(), items.end(), out);
+}
+
+/* A copy owns its block, wherever the original's lives */
+AdslValue::AdslValue(const AdslValue& other) : AdslValue()
+{
+    if (!other.hasBlock()) {
+        std::memcpy(m_data, other.m_data, sizeof(m_data));
+        m_small = other.m_small;
+        m_tag   = other.m_tag;
+        return;
+    }
+    if (other.type() == AdslValueType::StringList) {
+        *this = ValueAccess::makeStrings(other.strings(), nullptr);
+        return;
+    }
+    std::size_t bytes = ValueAccess::blockBytes(other);
+    void* out = ValueAccess::allocate(*this, other.type(), other.blockSize(), bytes, nullptr);
+    if (bytes) std::memcpy(out, other.block(), bytes);
+}
+
+void AdslValue::release() noexcept
+{
+    if (hasBlock() && !(m_tag & kBorrowed)) ::operator delete(const_cast<void*>(block()));
+    m_small = 0;
+    m_tag   = std::uint8_t(AdslValueType::String);
+}
+
+namespace {
+    template<typename T>
+    bool sameItems(AdslSpan<T> a, AdslSpan<T> b)
+    {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+    }
+}
+
+bool operator==(const AdslValue& a, const AdslValue& b)
+{
+    if (a.type() != b.type()) return false;
+    switch (a.type())
+    {
+        case AdslValueType::String:     return a.asString() == b.asString();
+        case AdslValueType::Int:        return a.asInt()    == b.asInt();
+        case AdslValueType::Float:      return a.asFloat()  == b.asFloat();
+        case AdslValueType::Bool:       return a.asBool()   == b.asBool();
+        case AdslValueType::Int64:      return a.asInt64()  == b.asInt64();
+        case AdslValueType::Double:     return a.asDouble() == b.asDouble();
+        case AdslValueType::StringList: return sameItems(a.strings(), b.strings());
+        case AdslValueType::IntList:    return sameItems(a.ints(),    b.ints());
+        case AdslValueType::FloatList:  return sameItems(a.floats(),  b.floats());
+        case AdslValueType::BoolList:   return sameItems(a.bools(),   b.bools());
+        case AdslValueType::Int64List:  return sameItems(a.int64s(),  b.int64s());
+        case AdslValueType::DoubleList: return sameItems(a.doubles(), b.doubles());
+        default:                        return true;
+    }
+}
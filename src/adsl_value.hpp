@@ -0,0 +1,59 @@
+#ifndef ADSL_VALUE_HPP
+#define ADSL_VALUE_HPP
+
+/* Internal : building AdslValue blocks in place.
+ *
+ * The parser decodes lists straight into the value's block instead of a
+ * scratch vector. Given an arena, blocks up to Arena::kLargeAllocation are
+ * carved from it and marked borrowed (the value never frees them; the
+ * arena's release() does). Larger blocks, and every block built without an
+ * arena, belong to the value.
+ */
+
+#include "../include/adsl/adsl.hpp"
+#include "adsl_arena.hpp"
+
+namespace adsl {
+namespace detail {
+
+    struct ValueAccess
+    {
+        /* Turn 'v' into a list of 'count' uninitialised items and return them */
+        template<typename T>
+        static T* makeList(AdslValue& v, AdslValueType type, std::size_t count, Arena* arena)
+        {
+            return static_cast<T*>(allocate(v, type, count, count * sizeof(T), arena));
+        }
+
+        /* Shrink a list made by makeList to its first 'count' items */
+        static void setCount(AdslValue& v, std::size_t count)
+        {
+            std::uint32_t n = static_cast<std::uint32_t>(count);
+            std::memcpy(v.m_data + sizeof(void*), &n, sizeof(n));
+        }
+
+        static AdslValue makeString (std::string_view s, Arena* arena);
+        static AdslValue makeStrings(AdslSpan<std::string_view> items, Arena* arena);
+
+        template<typename T>
+        static AdslValue makeList(AdslValueType type, AdslSpan<T> items, Arena* arena)
+        {
+            AdslValue v;
+            T* out = makeList<T>(v, type, items.size(), arena);
+            if (!items.empty()) std::memcpy(out, items.data(), items.size() * sizeof(T));
+            return v;
+        }
+
+        static std::size_t blockBytes(const AdslValue& v);                  // 0 without a block
+        static std::size_t ownedBytes(const AdslValue& v)                   // blocks the value frees
+        {
+            return (v.m_tag & AdslValue::kBorrowed) ? 0 : blockBytes(v);
+        }
+
+        static void* allocate(AdslValue& v, AdslValueType type, std::size_t count, std::size_t bytes, Arena* arena);
+    };
+
+} // namespace detail
+} // namespace adsl
+
+#endif // ADSL_VALUE_HPP
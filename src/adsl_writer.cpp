@@ -0,0 +1,289 @@
+#include "../include/adsl/adsl_writer.hpp"
+#include "../include/adsl/adsl_api.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <ostream>
+
+#if defined(_WIN32)
+    #include <io.h>
+#else
+    #include <cerrno>
+    #include <unistd.h>
+#endif
+
+using namespace adsl;
+
+/* ******************************************************************** */
+/*  ------------------------------ Sinks ------------------------------ */
+/* ******************************************************************** */
+
+bool StringSink::write(const char* data, std::size_t size)
+{
+    m_out.append(data, size);
+    return true;
+}
+
+bool OStreamSink::write(const char* data, std::size_t size)
+{
+    m_out.write(data, static_cast<std::streamsize>(size));
+    return static_cast<bool>(m_out);
+}
+
+bool FileSink::write(const char* data, std::size_t size)
+{
+    return m_file && std::fwrite(data, 1, size, m_file) == size;
+}
+
+bool FdSink::write(const char* data, std::size_t size)
+{
+    while (size > 0)
+    {
+#if defined(_WIN32)
+        unsigned chunk = size > 0x40000000u ? 0x40000000u : static_cast<unsigned>(size);
+        int n = ::_write(m_fd, data, chunk);
+        if (n <= 0) return false;
+#else
+        ssize_t n = ::write(m_fd, data, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+#endif
+        data += n;
+        size -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+/* ******************************************************************** */
+/*  ------------------------------ Writer ----------------------------- */
+/* ******************************************************************** */
+
+namespace {
+    /* longest fixed-notation float : 39 integer digits or "0." + 45 fraction digits,
+     * plus sign and the ".0" suffix */
+    constexpr std::size_t kMaxFloatChars = 64;
+    constexpr std::size_t kMaxIntChars   = 21;
+
+    /* significant digits before any exponent, leading zeros excluded */
+    std::size_t significantDigits(const char* p, const char* end)
+    {
+        std::size_t n = 0;
+        for (; p < end && *p != 'e'; ++p)
+            if (*p >= '0' && *p <= '9' && (n || *p != '0')) ++n;
+        return n;
+    }
+}
+
+Writer::Writer(Sink& sink, std::size_t bufferSize)
+    : m_sink(sink), m_buffer(bufferSize < kMaxFloatChars ? kMaxFloatChars : bufferSize)
+{
+}
+
+Writer::~Writer()
+{
+    flush();
+}
+
+void Writer::drain()
+{
+    if (m_used == 0) return;
+    if (m_good) m_good = m_sink.write(m_buffer.data(), m_used);
+    m_written += m_used;
+    m_used = 0;
+}
+
+bool Writer::flush()
+{
+    drain();
+    return m_good;
+}
+
+void Writer::put(std::string_view s)
+{
+    while (!s.empty())
+    {
+        if (m_used == m_buffer.size()) drain();
+        std::size_t n = std::min(s.size(), m_buffer.size() - m_used);
+        std::memcpy(m_buffer.data() + m_used, s.data(), n);
+        m_used += n;
+        s.remove_prefix(n);
+    }
+}
+
+char* Writer::reserve(std::size_t n)
+{
+    if (m_buffer.size() - m_used < n) drain();
+    return m_buffer.data() + m_used;
+}
+
+void Writer::putInt(std::int64_t i)
+{
+    char* p = reserve(kMaxIntChars);
+    char* end = std::to_chars(p, m_buffer.data() + m_buffer.size(), i).ptr;
+    m_used = static_cast<std::size_t>(end - m_buffer.data());
+}
+
+void Writer::putFloat(float f)
+{
+    char* p   = reserve(kMaxFloatChars);
+    char* end = std::to_chars(p, m_buffer.data() + m_buffer.size(), f, std::chars_format::fixed).ptr;
+
+    /* keep the value a float when read back ("1" would parse as an int) */
+    if (std::isfinite(f) && std::memchr(p, '.', static_cast<std::size_t>(end - p)) == nullptr) {
+        *end++ = '.';
+        *end++ = '0';
+    }
+    m_used = static_cast<std::size_t>(end - m_buffer.data());
+}
+
+void Writer::putDouble(double d)
+{
+    char* p   = reserve(kMaxFloatChars);
+    char* end = std::to_chars(p, m_buffer.data() + m_buffer.size(), d).ptr;
+    if (!std::isfinite(d)) { m_used = static_cast<std::size_t>(end - m_buffer.data()); return; }
+
+    /* The reader takes a float whenever one keeps the written value, which is
+     * always so up to 9 significant digits. Fine if a float holds d exactly;
+     * otherwise ("0.1" would come back as 0.1f) trailing zeros take the digit
+     * count past 9. A "." (or an exponent) keeps the value a real. */
+    char* exp = std::find(p, end, 'e');
+    std::size_t zeros = 0;
+    float f = static_cast<float>(d);
+    if (std::isnormal(f) && double(f) != d) {
+        std::size_t digits = significantDigits(p, exp);
+        if (digits < 10) zeros = 10 - digits;
+    }
+    bool dot = std::find(p, exp, '.') != exp;
+    if (!dot && exp == end && zeros == 0) zeros = 1;    // "1" -> "1.0"
+
+    std::size_t insert = zeros + (dot || zeros == 0 ? 0 : 1);
+    std::memmove(exp + insert, exp, static_cast<std::size_t>(end - exp));
+    if (insert > zeros) *exp++ = '.';
+    std::memset(exp, '0', zeros);
+    m_used = static_cast<std::size_t>(end + insert - m_buffer.data());
+}
+
+void Writer::writeValue(const AdslValue& v)
+{
+    auto putList = [this](auto items, auto putItem) {
+        put('[');
+        for (std::size_t i = 0; i < items.size(); ++i) { if (i) put(','); putItem(items[i]); }
+        put(']');
+    };
+    switch (v.type())
+    {
+        case AdslValueType::String:     putQuoted(v.asString()); break;
+        case AdslValueType::Int:        putInt(v.asInt());       break;
+        case AdslValueType::Float:      putFloat(v.asFloat());   break;
+        case AdslValueType::Bool:       putBool(v.asBool());     break;
+        case AdslValueType::Int64:      putInt(v.asInt64());     break;
+        case AdslValueType::Double:     putDouble(v.asDouble()); break;
+        case AdslValueType::StringList: putList(v.strings(), [this](std::string_view s){ putQuoted(s); }); break;
+        case AdslValueType::IntList:    putList(v.ints(),    [this](int i){ putInt(i); });            break;
+        case AdslValueType::FloatList:  putList(v.floats(),  [this](float f){ putFloat(f); });        break;
+        case AdslValueType::BoolList:   putList(v.bools(),   [this](bool b){ putBool(b); });          break;
+        case AdslValueType::Int64List:  putList(v.int64s(),  [this](std::int64_t i){ putInt(i); });   break;
+        case AdslValueType::DoubleList: putList(v.doubles(), [this](double d){ putDouble(d); });      break;
+        default:                        break;
+    }
+}
+
+void Writer::writeGroup(const AdslGroup& g)
+{
+    put('@');
+    put(g.name);
+    if (!g.values.empty())
+    {
+        put('[');
+        for (std::size_t i = 0; i < g.values.size(); ++i) {
+            if (i) put(',');
+            put(g.values[i]);
+        }
+        put(']');
+    }
+    put('\n');
+}
+
+void Writer::writeField(const AdslField& f)
+{
+    put("    - ");
+    put(f.name.view());
+    put('=');
+    writeValue(f.get());
+
+    if (!f.groups.empty()) put(' ');
+    for (std::size_t i = 0; i < f.groups.size(); ++i) {
+        if (i) put(' ');
+        put('@');
+        put(f.groups[i].view());
+    }
+    put('\n');
+}
+
+void Writer::writeEntity(const AdslEntity& e)
+{
+    put('#');
+    put(e.type.view());
+    for (auto& g : e.groups) {
+        put(" @");
+        put(g.view());
+    }
+    put('\n');
+
+    for (const auto& f : e.fields)
+        if (!f.removed()) writeField(f);
+    put('\n');
+}
+
+void Writer::write(const AdslDatabase& db)
+{
+    for (const auto& kv : db.groups)
+        writeGroup(kv.second);
+    if (!db.groups.empty()) put('\n');
+
+    for (const auto& e : db.entities)
+        if (!e.removed()) writeEntity(e);
+}
+
+/* ******************************************************************** */
+/*  ---------------------------- Entry points ------------------------- */
+/* ******************************************************************** */
+
+bool adsl::serialize(const AdslDatabase& db, Sink& sink)
+{
+    Writer w(sink);
+    w.write(db);
+    return w.flush();
+}
+
+bool adsl::saveFile(const AdslDatabase& db, const std::string& path)
+{
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    std::setvbuf(file, nullptr, _IONBF, 0);         // Writer already buffers
+
+    FileSink sink(file);
+    bool ok = serialize(db, sink);
+    return (std::fclose(file) == 0) && ok;
+}
+
+std::string adsl::serialize(const AdslDatabase& db)
+{
+    std::string out;
+    StringSink sink(out);
+    serialize(db, sink);
+    return out;
+}
+
+/* Single value, same formatting as the writer */
+std::string adslValueToString(const AdslValue& v)
+{
+    std::string out;
+    StringSink sink(out);
+    Writer w(sink, 0);
+    w.writeValue(v);
+    w.flush();
+    return out;
+}
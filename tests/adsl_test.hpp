@@ -0,0 +1,36 @@
+#ifndef ADSL_TEST_HPP
+#define ADSL_TEST_HPP
+
+#include <cstdio>
+
+/* Checks for the test programs : failures are counted, printed with their
+ * line, and turned into the exit code by testResult() (ctest runs each one) */
+
+inline int g_failures = 0;
+
+#define CHECK(cond)                                                             \
+    do {                                                                        \
+        if (!(cond)) {                                                          \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                       \
+        }                                                                       \
+    } while (0)
+
+/* 'expr' must throw E */
+#define CHECK_THROWS(E, expr)                                                   \
+    do {                                                                        \
+        bool thrown_ = false;                                                   \
+        try { (void)(expr); } catch (const E&) { thrown_ = true; }              \
+        if (!thrown_) {                                                         \
+            std::fprintf(stderr, "%s:%d: no " #E " from: %s\n", __FILE__, __LINE__, #expr); \
+            ++g_failures;                                                       \
+        }                                                                       \
+    } while (0)
+
+inline int testResult()
+{
+    if (g_failures) std::fprintf(stderr, "%d failure(s)\n", g_failures);
+    return g_failures ? 1 : 0;
+}
+
+#endif // ADSL_TEST_HPP
@@ -0,0 +1,66 @@
+#include "../include/adsl/adsl_api.hpp"
+#include "adsl_test.hpp"
+
+#include <string>
+#include <string_view>
+
+/* Typed field access through the shape cache : every way of naming a field, and
+ * lookups by text that must not intern the names they miss */
+
+namespace {
+
+    const char* const kText =
+        "#person\n - name=\"Alice\"\n - age=30\n"
+        "#person\n - name=\"Bob\"\n - age=22\n"
+        "#person\n - age=41\n - name=\"Eve\"\n"         // another layout
+        "#car\n - brand=\"Volvo\"\n";
+
+    void lookups()
+    {
+        adsl::API api;
+        api.loadString(kText);
+        const auto people = std::as_const(api).entitiesByType("person");
+        CHECK(people.size() == 3);
+        const AdslEntity& eve = *people[2];
+
+        const std::string name = "age";
+        const AdslSymbol symbol("age");
+        CHECK(api.get<int>(eve, "age") == 41);
+        CHECK(api.get<int>(eve, name) == 41);
+        CHECK(api.get<int>(eve, std::string_view(name)) == 41);
+        CHECK(api.get<int>(eve, symbol) == 41);
+        CHECK(api.getOr<std::string>(eve, "name", "?") == "Eve");
+        CHECK(api.getOr<int>(*people[0], "age", 0) == 30);
+        CHECK(!api.get<std::string>(eve, "age"));           // another type
+        CHECK(api.getOr<int>(eve, "name", -1) == -1);
+        CHECK(api.field(*people[1], "name") && api.field(*people[1], "name")->get().asString() == "Bob");
+
+        AdslEntity& bob = *api.entitiesByType("person")[1];
+        AdslField* age = api.field(bob, "age");
+        CHECK(age && age->get().asInt() == 22);
+    }
+
+    void unknownNamesNotInterned()
+    {
+        adsl::API api;
+        api.loadString(kText);
+        const AdslEntity& alice = *std::as_const(api).entitiesByType("person")[0];
+
+        CHECK(!AdslSymbol::find("api_tests_never_a_field"));
+        CHECK(!api.get<int>(alice, "api_tests_never_a_field"));
+        CHECK(api.getOr<int>(alice, std::string("api_tests_never_a_field"), 7) == 7);
+        CHECK(!api.field(alice, std::string_view("api_tests_never_a_field")));
+        CHECK(!AdslSymbol::find("api_tests_never_a_field"));
+
+        /* a name known elsewhere, but not on this type */
+        CHECK(!api.get<std::string>(alice, "brand"));
+        CHECK(api.get<std::string>(*std::as_const(api).entitiesByType("car")[0], "brand") == "Volvo");
+    }
+}
+
+int main()
+{
+    lookups();
+    unknownNamesNotInterned();
+    return testResult();
+}
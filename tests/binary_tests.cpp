@@ -0,0 +1,128 @@
+#include "../include/adsl/adsl_api.hpp"
+#include "../include/adsl/adsl_binary.hpp"
+#include "adsl_test.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+/* .adslb : exact round trip, queries from the mapped file, and bad files rejected */
+
+namespace {
+
+    const char* const kText =
+        "@year2021[2021]\n"
+        "@tags[\"a\",\"b\"]\n"
+        "@vehicles\n"
+        "#person @employee\n"
+        " - name=\"Alice\" @hr\n"
+        " - age=30\n"
+        " - isActive=true\n"
+        " - skills=[\"C++\",\"ASM\"] @tech\n"
+        " - scores=[1,2,3]\n"
+        " - weights=[0.5,1.5]\n"
+        " - flags=[true,false]\n"
+        "#car @vehicles @year2021\n"
+        " - brand=\"Volvo\"\n"
+        " - price=42000.5\n"
+        " - serial=5000000000\n"
+        " - precise=0.1234567890123\n"
+        " - empty=\"\"\n"
+        "#car @vehicles\n"
+        " - brand=\"a string much longer than the inline size\" @tech\n";
+
+    std::string tempPath(const char* name)
+    {
+        return (std::filesystem::temp_directory_path() / name).string();
+    }
+
+    std::string readAll(const std::string& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    void writeAll(const std::string& path, const std::string& bytes)
+    {
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(bytes.data(), std::streamsize(bytes.size()));
+    }
+
+    void roundTrip()
+    {
+        AdslDatabase db;
+        parseAdslString(kText, db);
+        const std::string path = tempPath("adsl_binary_tests.adslb");
+        CHECK(adsl::saveBinary(db, path));
+        CHECK(readAll(path) == adsl::serializeBinary(db));
+
+        AdslDatabase back;
+        CHECK(adsl::loadBinary(path, back));
+        CHECK(back.groups.size() == db.groups.size());
+        for (const auto& [name, group] : db.groups)
+            CHECK(back.groups.count(name) && back.groups.at(name).values == group.values);
+        back.groups.clear();                                // unordered : written in any order
+        db.groups.clear();
+        CHECK(adsl::serialize(back) == adsl::serialize(db));
+        CHECK(back.findEntitiesByType("car").size() == 2);
+
+        adsl::BinaryDatabase bin;
+        CHECK(bin.open(path));
+        CHECK(bin.entityCount() == 3 && bin.groupCount() == 3);
+        CHECK(bin.findEntitiesByType("car").size() == 2);
+        CHECK(bin.findEntitiesByGroup("vehicles").size() == 2);
+        CHECK(bin.findFieldsByGroup("tech").size() == 2);
+        CHECK(bin.findEntitiesByType("nope").empty());
+
+        adsl::BinaryEntity person = bin.findEntitiesByType("person").at(0);
+        CHECK(person.field("age") && person.field("age")->asInt() == 30);
+        CHECK(person.field("skills") && person.field("skills")->stringAt(1) == "ASM");
+        adsl::BinaryEntity car = bin.entity(1);
+        CHECK(car.field("serial") && car.field("serial")->asInt64() == 5000000000LL);
+        CHECK(car.field("precise") && car.field("precise")->asDouble() == 0.1234567890123);
+        CHECK(car.hasGroup("year2021") && !car.hasGroup("employee"));
+
+        std::filesystem::remove(path);
+    }
+
+    /* Truncated, corrupted or foreign files throw runtime_error; a missing one returns false */
+    void badFiles()
+    {
+        AdslDatabase db;
+        parseAdslString(kText, db);
+        const std::string good = adsl::serializeBinary(db);
+        const std::string path = tempPath("adsl_binary_bad.adslb");
+        adsl::BinaryDatabase bin;
+
+        writeAll(path, good.substr(0, good.size() / 2));
+        CHECK_THROWS(std::runtime_error, bin.open(path));
+        writeAll(path, good.substr(0, 3));
+        CHECK_THROWS(std::runtime_error, bin.open(path));
+        writeAll(path, std::string());
+        CHECK_THROWS(std::runtime_error, bin.open(path));
+
+        std::string flipped = good;
+        flipped[flipped.size() - 9] ^= 0x5a;                // payload byte : checksum mismatch
+        writeAll(path, flipped);
+        CHECK_THROWS(std::runtime_error, bin.open(path));
+
+        std::string magic = good;
+        magic[0] ^= 0xff;
+        writeAll(path, magic);
+        CHECK_THROWS(std::runtime_error, bin.open(path));
+
+        AdslDatabase out;
+        CHECK_THROWS(std::runtime_error, adsl::loadBinary(path, out));
+
+        std::filesystem::remove(path);
+        CHECK(!bin.open(path));
+        CHECK(!adsl::loadBinary(path, out));
+    }
+}
+
+int main()
+{
+    roundTrip();
+    badFiles();
+    return testResult();
+}
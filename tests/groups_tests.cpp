@@ -0,0 +1,136 @@
+#include "../include/adsl/adsl_groups.hpp"
+#include "adsl_test.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+/* AdslIdSet, and GroupExpr against a per-entity scan, over several 65536-entity chunks */
+
+namespace {
+
+    bool has(const std::pmr::vector<AdslSymbol>& groups, const char* g)
+    {
+        return std::find(groups.begin(), groups.end(), AdslSymbol(g)) != groups.end();
+    }
+
+    /* Chunk 0 : sparse groups (arrays); chunk 1 : 'dense' on every entity, 'most'
+     * on most (bitmaps); then 'n' - 2 * 65536 entities in a partial last chunk. */
+    std::string corpus(std::size_t n)
+    {
+        std::string text;
+        text.reserve(n * 24);
+        for (std::size_t i = 0; i < n; ++i) {
+            const bool second = i >= 65536 && i < 2 * 65536;
+            text += "#t";
+            if (i % 97 == 0)            text += " @sparse";
+            if (second)                 text += " @dense";
+            if (second ? i % 10 != 0 : i % 3 == 0) text += " @most";
+            text += i % 50 == 0 ? "\n - x=1 @f\n" : "\n";
+        }
+        return text;
+    }
+
+    struct Case
+    {
+        adsl::GroupExpr expr;
+        bool (*test)(const AdslEntity&);
+    };
+
+    std::vector<Case> cases()
+    {
+        using adsl::inGroup;
+        auto sparse = inGroup("sparse"), dense = inGroup("dense"), most = inGroup("most");
+        auto field  = adsl::inFieldGroup("f"), none = inGroup("never_attached");
+        return {
+            { ~dense,           [](const AdslEntity& e){ return !has(e.groups, "dense"); } },
+            { ~~dense,          [](const AdslEntity& e){ return has(e.groups, "dense"); } },
+            { ~none,            [](const AdslEntity&)  { return true; } },
+            { none,             [](const AdslEntity&)  { return false; } },
+            { ~sparse & ~most,  [](const AdslEntity& e){ return !has(e.groups, "sparse") && !has(e.groups, "most"); } },
+            { dense & ~most,    [](const AdslEntity& e){ return has(e.groups, "dense") && !has(e.groups, "most"); } },
+            { most - dense,     [](const AdslEntity& e){ return has(e.groups, "most") && !has(e.groups, "dense"); } },
+            { sparse | dense,   [](const AdslEntity& e){ return has(e.groups, "sparse") || has(e.groups, "dense"); } },
+            { ~(sparse | most), [](const AdslEntity& e){ return !has(e.groups, "sparse") && !has(e.groups, "most"); } },
+            { ~field & sparse,  [](const AdslEntity& e){
+                return has(e.groups, "sparse") && !std::any_of(e.fields.begin(), e.fields.end(),
+                    [](const AdslField& f){ return !f.removed() && has(f.groups, "f"); }); } },
+        };
+    }
+
+    void checkAll(const AdslDatabase& db)
+    {
+        for (const Case& c : cases())
+        {
+            std::vector<std::size_t> expected;
+            for (std::size_t i = 0; i < db.entities.size(); ++i)
+                if (!db.entities[i].removed() && c.test(db.entities[i])) expected.push_back(i);
+
+            CHECK(c.expr.indices(db) == expected);
+            CHECK(c.expr.count(db) == expected.size());
+            CHECK(c.expr.toSet(db).ids() == expected);
+            std::size_t seen = 0;
+            c.expr.forEach(db, [&](const AdslEntity& e){ seen += db.indexOf(e) == expected.at(seen); });
+            CHECK(seen == expected.size());
+            CHECK(c.expr.entities(db).size() == expected.size());
+            for (std::size_t i : { std::size_t(0), db.entities.size() - 1 })
+                CHECK(c.expr.matches(db.entities[i]) == (!db.entities[i].removed() && c.test(db.entities[i])));
+        }
+    }
+
+    void idSet()
+    {
+        AdslIdSet s;
+        CHECK(s.empty() && s.count() == 0 && !s.contains(0));
+        for (std::size_t i = 0; i < 10000; ++i) s.insert(70000 + (i * 7919) % 10000);  // out of order
+        s.insert(5);
+        s.insert(5);
+        CHECK(s.count() == 10001 && s.contains(5) && s.contains(70000) && s.contains(79999) && !s.contains(80000));
+        std::vector<std::size_t> ids = s.ids();
+        CHECK(ids.size() == 10001 && std::is_sorted(ids.begin(), ids.end()) && ids.front() == 5);
+
+        const std::size_t dense = s.memoryBytes();
+        for (std::size_t i = 0; i < 10000; i += 2) s.erase(70000 + i);
+        s.erase(12345);                                     // not there
+        CHECK(s.count() == 5001 && !s.contains(70000) && s.contains(70001));
+        for (std::size_t i = 0; i < 10000; ++i) s.erase(70000 + i);
+        CHECK(s.count() == 1 && s.memoryBytes() < dense);   // back to an array, empty chunk gone
+        s.erase(5);
+        CHECK(s.empty());
+    }
+
+    void partialLastChunk()
+    {
+        AdslDatabase db;
+        parseAdslString(corpus(2 * 65536 + 1234), db);
+        CHECK(db.groupSet("dense") && db.groupSet("dense")->count() == 65536);
+        checkAll(db);
+
+        /* removed entities never match, NOT included */
+        for (std::size_t i = 0; i < db.entities.size(); i += 1009) db.removeEntity(i);
+        db.removeEntity(db.entities.size() - 1);
+        checkAll(db);
+        db.removeField(AdslFieldRef{ 50, 0 });              // field leaves fall back to a scan
+        checkAll(db);
+        db.compact();
+        checkAll(db);
+
+        /* no partial chunk at all, and a database without indexes */
+        AdslDatabase exact;
+        parseAdslString(corpus(2 * 65536), exact);
+        checkAll(exact);
+        exact.entities.emplace_back().type = "t";
+        CHECK(!exact.isIndexed() && !exact.groupSet("dense"));
+        checkAll(exact);
+
+        AdslDatabase empty;
+        CHECK((~adsl::inGroup("dense")).count(empty) == 0);
+    }
+}
+
+int main()
+{
+    idSet();
+    partialLastChunk();
+    return testResult();
+}
@@ -0,0 +1,149 @@
+#include "../include/adsl/adsl_api.hpp"
+#include "../include/adsl/adsl_incremental.hpp"
+#include "adsl_test.hpp"
+
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/* Document edits against a full parse of the same text */
+
+namespace {
+
+    /* entities, group definitions and indexes all as a fresh parse gives them */
+    bool sameAsReparse(const adsl::Document& doc)
+    {
+        AdslDatabase fresh;
+        parseAdslString(doc.text(), fresh);
+        const AdslDatabase& db = doc.db();
+
+        bool same = adsl::serialize(db) == adsl::serialize(fresh) && db.isIndexed();
+        same = same && db.groups.size() == fresh.groups.size();
+        for (const auto& [name, group] : fresh.groups)
+            same = same && db.groups.count(name) && db.groups.at(name).values == group.values;
+        for (const char* type : { "a", "b", "c" })
+            same = same && db.findEntitiesByType(type).size() == fresh.findEntitiesByType(type).size();
+        for (const char* group : { "g1", "g2", "g3", "f" }) {
+            same = same && db.findEntitiesByGroup(group).size() == fresh.findEntitiesByGroup(group).size();
+            same = same && db.findFieldsByGroup(group).size() == fresh.findFieldsByGroup(group).size();
+        }
+        for (std::size_t i = 0; i < db.entities.size(); ++i)
+            same = same && doc.text()[doc.entitySpan(i).first] == '#';
+        return same;
+    }
+
+    /* line starts, plus the end of the text */
+    std::vector<std::size_t> lineStarts(const std::string& text)
+    {
+        std::vector<std::size_t> starts{ 0 };
+        for (std::size_t i = 0; i < text.size(); ++i)
+            if (text[i] == '\n' && i + 1 < text.size()) starts.push_back(i + 1);
+        starts.push_back(text.size());
+        return starts;
+    }
+
+    /* Whole lines inserted, removed or replaced at random : headers appear and go,
+     * '@group' definitions move between blocks. An edit that makes the text invalid
+     * must throw and leave the document as it was. */
+    void randomEdits()
+    {
+        const char* const pool[] = {
+            "#a @g1\n", "#b\n", "#c @g2 @g1\n",
+            " - x=1 @f\n", " - y=\"s\"\n", " - z=[1,2] @g2\n", " - w=2.5 @f @g1\n",
+            "@g1[1]\n", "@g2\n", "@g3[\"v\",\"w\"]\n",
+            "// comment #not a header @g1\n", "\n",
+        };
+        AdslDatabase db;
+        adsl::Document doc(db);
+        doc.loadString("@g2\n#a @g1\n - x=1 @f\n#b\n - y=\"s\"\n@g1[1]\n#c @g2\n - z=[1,2] @g2\n");
+        CHECK(sameAsReparse(doc));
+
+        std::mt19937 rng(12);
+        std::size_t failed = 0;
+        for (int step = 0; step < 400; ++step)
+        {
+            const std::vector<std::size_t> starts = lineStarts(doc.text());
+            const std::size_t lines = starts.size() - 1;
+            const std::size_t line  = rng() % (lines + 1);
+            const std::size_t at    = starts[std::min(line, lines)];
+            const std::size_t len   = line < lines && rng() % 2 ? starts[line + 1] - at : 0;
+            const std::string with  = len && rng() % 2 ? std::string() : pool[rng() % (sizeof(pool) / sizeof(pool[0]))];
+
+            const std::string before = doc.text(), dump = adsl::serialize(db);
+            try {
+                doc.edit(at, len, with);
+            } catch (const std::runtime_error&) {
+                ++failed;
+                CHECK(doc.text() == before && adsl::serialize(db) == dump);
+                continue;
+            }
+            CHECK(sameAsReparse(doc));
+        }
+        CHECK(failed < 200);
+
+        /* update() diffs against the current text */
+        doc.update("#c @g2\n - z=[3] @g2\n@g3[\"v\"]\n#a\n - x=1 @f\n");
+        CHECK(sameAsReparse(doc));
+        doc.update("@g1\n" + doc.text() + "#b @g1\n");
+        CHECK(sameAsReparse(doc));
+    }
+
+    /* A '@group' definition moving to another block rebuilds db.groups */
+    void groupMoves()
+    {
+        AdslDatabase db;
+        adsl::Document doc(db);
+        doc.loadString("#a\n - x=1\n@g3[\"old\"]\n#b\n - y=2\n");
+        const std::size_t def = doc.text().find("@g3");
+        adsl::Document::Update u = doc.edit(def, 11, "");
+        CHECK(u.groupsChanged && db.groups.count("g3") == 0);
+        u = doc.edit(doc.text().size(), 0, "@g3[\"new\"]\n");
+        CHECK(u.groupsChanged && db.groups.at("g3").values == std::vector<std::string>{ "\"new\"" });
+        u = doc.edit(doc.text().find("x=1") + 2, 1, "5");       // a block without definitions
+        CHECK(!u.groupsChanged && u.removed == 1 && u.inserted == 1);
+        CHECK(sameAsReparse(doc));
+    }
+}
+
+
+/* An edit keeping the entity count replaces the block in place : the entities
+ * after it must keep their fields and groups (an empty erase used to move them
+ * onto themselves, emptying them) */
+static void sameCountEdit()
+{
+    AdslDatabase db;
+    adsl::Document doc(db);
+    doc.loadString("#a @g1\n - x=1 @f\n"
+                   "#b @g2\n - y=2 @f\n - z=3\n"
+                   "#c @g3\n - w=4 @f\n");
+
+    doc.edit(doc.text().find("x=1") + 2, 1, "9");
+    CHECK(db.entities.size() == 3);
+    CHECK(db.entities[0].fields.size() == 1 && db.entities[0].fields[0].get().asInt() == 9);
+    CHECK(db.entities[1].fields.size() == 2 && db.entities[1].groups.size() == 1);
+    CHECK(db.entities[1].fields[1].get().asInt() == 3);
+    CHECK(db.entities[2].fields.size() == 1 && db.entities[2].groups.size() == 1);
+    CHECK(db.entities[2].fields[0].get().asInt() == 4);
+
+    std::vector<const AdslField*> f = db.findFieldsByGroup("f");
+    CHECK(f.size() == 3);
+    int sum = 0;
+    for (const AdslField* field : f) sum += int(field->get().asInt());
+    CHECK(sum == 9 + 2 + 4);
+    CHECK(db.findEntitiesByGroup("g3").size() == 1);
+
+    doc.update("#a @g1\n - x=5 @f\n"
+               "#b @g2\n - y=2 @f\n - z=3\n"
+               "#c @g3\n - w=4 @f\n");
+    CHECK(db.entities.size() == 3 && db.entities[2].fields.size() == 1);
+    CHECK(db.findFieldsByGroup("f").size() == 3);
+}
+
+int main()
+{
+    sameCountEdit();
+    randomEdits();
+    groupMoves();
+    return testResult();
+}
@@ -0,0 +1,105 @@
+#include "../include/adsl/adsl_api.hpp"
+#include "adsl_test.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+/* AdslValues::Lazy : same values as an eager parse, decode errors on first read with their line */
+
+namespace {
+
+    const char* const kValid =
+        "@g[1]\n"
+        "#a @g\n"
+        " - i=42\n"
+        " - f=1.5 @g\n"
+        " - b=false\n"
+        " - s=\"a string longer than fourteen chars\"\n"
+        " - l=[1,2,3]\n"
+        " - q=[\"x\",\"y\"]\n"
+        " - big=9000000000\n"
+        "// comment\n"
+        "#b\n"
+        " - d=0.1234567890123\n";
+
+    /* the bad values sit on lines 6 and 8 */
+    const char* const kBad =
+        "#a\n"
+        " - x=1\n"
+        "\n"
+        "// comment\n"
+        "#b\n"
+        " - y=12abc\n"
+        " - ok=\"fine\"\n"
+        " - z=[1,\"s\"]\n";
+
+    bool throwsLine(const AdslField& f, const char* line)
+    {
+        try {
+            f.get();
+        } catch (const std::runtime_error& e) {
+            return std::string(e.what()).rfind(line, 0) == 0;
+        }
+        return false;
+    }
+
+    void sameAsEager()
+    {
+        AdslDatabase eager, lazy;
+        parseAdslString(kValid, eager);
+        parseAdslString(kValid, lazy, AdslValues::Lazy);
+        CHECK(lazy.isLazy() && !eager.isLazy());
+        CHECK(lazy.entities[0].fields[0].get().asInt() == 42);
+        CHECK(lazy.entities[0].fields[6].get().asInt64() == 9000000000LL);
+        CHECK(adsl::serialize(lazy) == adsl::serialize(eager));
+        CHECK(lazy.findFieldsByGroup("g").size() == 1);
+
+        /* copies share the retained text : the original may go first */
+        AdslDatabase* source = new AdslDatabase(AdslAllocation::Arena);
+        parseAdslString(kValid, *source, AdslValues::Lazy);
+        AdslDatabase copy(*source);
+        delete source;
+        copy.decodeAll();
+        CHECK(adsl::serialize(copy) == adsl::serialize(eager));
+
+        const std::string path = (std::filesystem::temp_directory_path() / "adsl_lazy_tests.adsl").string();
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << kValid;
+        AdslDatabase mapped;
+        CHECK(parseAdslFile(path, mapped, AdslValues::Lazy));
+        CHECK(adsl::serialize(mapped) == adsl::serialize(eager));
+        std::filesystem::remove(path);
+    }
+
+    void errorLines()
+    {
+        AdslDatabase eager;
+        CHECK_THROWS(std::runtime_error, parseAdslString(kBad, eager));
+
+        AdslDatabase db;
+        CHECK(parseAdslString(kBad, db, AdslValues::Lazy));    // nothing decoded yet
+        const AdslEntity& b = db.entities[1];
+        CHECK(db.entities[0].fields[0].get().asInt() == 1);
+        CHECK(throwsLine(b.fields[0], "Line 6:"));
+        CHECK(throwsLine(b.fields[0], "Line 6:"));              // still failing on a second read
+        CHECK(b.fields[1].get().asString() == "fine");
+        CHECK(throwsLine(b.fields[2], "Line 8:"));
+
+        AdslDatabase all;
+        parseAdslString(kBad, all, AdslValues::Lazy);
+        try {
+            all.decodeAll();
+            CHECK(!"decodeAll did not throw");
+        } catch (const std::runtime_error& e) {
+            CHECK(std::string(e.what()).rfind("Line 6:", 0) == 0);
+        }
+    }
+}
+
+int main()
+{
+    sameAsEager();
+    errorLines();
+    return testResult();
+}
@@ -0,0 +1,121 @@
+#include "../include/adsl/adsl_live.hpp"
+#include "adsl_test.hpp"
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* LiveDatabase : published versions, failed reloads, concurrent readers, the watcher */
+
+namespace {
+
+    std::string tempPath(const char* name)
+    {
+        return (std::filesystem::temp_directory_path() / name).string();
+    }
+
+    void writeAll(const std::string& path, const std::string& text)
+    {
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << text;
+    }
+
+    std::string entities(std::size_t n)
+    {
+        std::string text;
+        for (std::size_t i = 0; i < n; ++i) text += "#car @vehicles\n - id=" + std::to_string(i) + "\n";
+        return text;
+    }
+
+    void reloads()
+    {
+        const std::string path = tempPath("adsl_live_tests.adsl");
+        std::filesystem::remove(path);
+        adsl::LiveDatabase live(path);
+        CHECK(live.snapshot() && live.snapshot()->entities.empty());
+        CHECK(!live.reload());                              // no file yet
+        CHECK(!live.lastError().empty() && live.generation() == 0);
+
+        std::size_t published = 0;
+        live.onReload([&published](const adsl::Snapshot& s){ published = s->entities.size(); });
+
+        writeAll(path, entities(1));
+        CHECK(live.reload() && live.generation() == 1 && published == 1);
+        adsl::Snapshot first = live.snapshot();
+        CHECK(first->entities.size() == 1);
+
+        writeAll(path, entities(3));
+        CHECK(live.reload() && live.generation() == 2 && published == 3);
+        CHECK(live.snapshot()->findEntitiesByType("car").size() == 3);
+        CHECK(first->entities.size() == 1 && first->findEntitiesByGroup("vehicles").size() == 1);
+
+        /* a failed reload keeps the previous version */
+        writeAll(path, "#car\n - id=\"unterminated\n");
+        CHECK(!live.reload());
+        CHECK(!live.lastError().empty());
+        CHECK(live.generation() == 2 && live.snapshot()->entities.size() == 3 && published == 3);
+
+        writeAll(path, entities(2));
+        CHECK(live.reload() && live.generation() == 3 && live.snapshot()->entities.size() == 2);
+        std::filesystem::remove(path);
+    }
+
+    /* Readers see only whole versions while the writer reloads */
+    void concurrentReaders()
+    {
+        const std::string path = tempPath("adsl_live_readers.adsl");
+        writeAll(path, entities(10));
+        adsl::LiveDatabase live(path);
+        CHECK(live.reload());
+
+        std::atomic<bool> done{ false };
+        std::atomic<std::size_t> torn{ 0 };
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; ++t)
+            readers.emplace_back([&]{
+                while (!done.load()) {
+                    adsl::Snapshot s = live.snapshot();
+                    const std::size_t n = s->entities.size();
+                    if ((n != 10 && n != 20) || s->findEntitiesByType("car").size() != n) ++torn;
+                }
+            });
+        for (int i = 0; i < 40; ++i) {
+            writeAll(path, entities(i % 2 ? 10 : 20));
+            CHECK(live.reload());
+        }
+        done = true;
+        for (std::thread& t : readers) t.join();
+        CHECK(torn == 0);
+        std::filesystem::remove(path);
+    }
+
+    /* watch() picks up a save on its own (waits up to 5 s) */
+    void watcher()
+    {
+        const std::string path = tempPath("adsl_live_watch.adsl");
+        writeAll(path, entities(1));
+        adsl::LiveDatabase::Options options;
+        options.settle = std::chrono::milliseconds(10);
+        adsl::LiveDatabase live(path, options);
+        CHECK(live.reload());
+        CHECK(live.watch());
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        writeAll(path, entities(4));
+        for (int i = 0; i < 500 && live.snapshot()->entities.size() != 4; ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        CHECK(live.snapshot()->entities.size() == 4 && live.generation() >= 2);
+        live.stop();
+        std::filesystem::remove(path);
+    }
+}
+
+int main()
+{
+    reloads();
+    concurrentReaders();
+    watcher();
+    return testResult();
+}
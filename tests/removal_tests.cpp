@@ -0,0 +1,180 @@
+#include "../include/adsl/adsl_api.hpp"
+#include "../include/adsl/adsl_groups.hpp"
+#include "adsl_test.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+/* find* and GroupExpr against a scan of what is not removed, after removals and after compact() */
+
+namespace {
+
+    bool has(const std::pmr::vector<AdslSymbol>& groups, const char* g)
+    {
+        return std::find(groups.begin(), groups.end(), AdslSymbol(g)) != groups.end();
+    }
+
+    std::vector<const AdslEntity*> scanType(const AdslDatabase& db, const char* type)
+    {
+        std::vector<const AdslEntity*> res;
+        for (const AdslEntity& e : db.entities)
+            if (!e.removed() && e.type == type) res.push_back(&e);
+        return res;
+    }
+
+    std::vector<const AdslEntity*> scanGroup(const AdslDatabase& db, const char* group)
+    {
+        std::vector<const AdslEntity*> res;
+        for (const AdslEntity& e : db.entities)
+            if (!e.removed() && has(e.groups, group)) res.push_back(&e);
+        return res;
+    }
+
+    std::vector<const AdslField*> scanFieldGroup(const AdslDatabase& db, const char* group)
+    {
+        std::vector<const AdslField*> res;
+        for (const AdslEntity& e : db.entities)
+            if (!e.removed())
+                for (const AdslField& f : e.fields)
+                    if (!f.removed() && has(f.groups, group)) res.push_back(&f);
+        return res;
+    }
+
+    /* g1 & ~g2, g2 | @f fields, ~g1 : written out by hand rather than through GroupExpr::matches */
+    void checkGroupExprs(const AdslDatabase& db)
+    {
+        std::vector<std::size_t> andNot, orField, notG1;
+        for (std::size_t i = 0; i < db.entities.size(); ++i)
+        {
+            const AdslEntity& e = db.entities[i];
+            if (e.removed()) continue;
+            bool field = false;
+            for (const AdslField& f : e.fields) field = field || (!f.removed() && has(f.groups, "f"));
+            if (has(e.groups, "g1") && !has(e.groups, "g2")) andNot.push_back(i);
+            if (has(e.groups, "g2") || field) orField.push_back(i);
+            if (!has(e.groups, "g1")) notG1.push_back(i);
+        }
+        using adsl::inGroup;
+        CHECK((inGroup("g1") & ~inGroup("g2")).indices(db) == andNot);
+        CHECK((inGroup("g1") - inGroup("g2")).count(db) == andNot.size());
+        CHECK((inGroup("g2") | adsl::inFieldGroup("f")).indices(db) == orField);
+        CHECK((~inGroup("g1")).indices(db) == notG1);
+        CHECK((~inGroup("g1")).count(db) == notG1.size());
+    }
+
+    void checkAgainstScan(const AdslDatabase& db)
+    {
+        for (const char* type : { "a", "b", "c" }) CHECK(db.findEntitiesByType(type) == scanType(db, type));
+        for (const char* group : { "g1", "g2" })  CHECK(db.findEntitiesByGroup(group) == scanGroup(db, group));
+        CHECK(db.findFieldsByGroup("f") == scanFieldGroup(db, "f"));
+        checkGroupExprs(db);
+    }
+
+    std::string corpus(std::size_t n)
+    {
+        std::string text;
+        for (std::size_t i = 0; i < n; ++i) {
+            text += i % 3 == 0 ? "#a" : i % 3 == 1 ? "#b" : "#c";
+            if (i % 2 == 0) text += " @g1";
+            if (i % 5 == 0) text += " @g2";
+            text += "\n - x=" + std::to_string(i) + (i % 4 == 0 ? " @f" : "") + "\n - y=1 @f\n";
+        }
+        return text;
+    }
+
+    void removals(AdslDatabase& db)
+    {
+        const std::size_t n = db.entities.size();
+        CHECK(db.removeEntity(1));
+        CHECK(!db.removeEntity(1));
+        CHECK_THROWS(std::out_of_range, db.removeEntity(n));
+        CHECK(db.removeField(AdslFieldRef{ 0, 1 }));
+        CHECK(!db.removeField(AdslFieldRef{ 0, 1 }));
+        CHECK_THROWS(std::out_of_range, db.removeField(AdslFieldRef{ 0, 7 }));
+        for (std::size_t i = 4; i < n; i += 7) db.removeField(AdslFieldRef{ i, 0 });
+
+        const std::size_t live = scanType(db, "a").size() + scanType(db, "b").size() + scanType(db, "c").size();
+        std::size_t expected = 0;
+        for (const AdslEntity& e : db.entities) expected += !e.removed() && e.fields[0].get().asInt() % 6 == 3;
+        CHECK(db.removeIf([](const AdslEntity& e){ return e.fields[0].get().asInt() % 6 == 3; }) == expected);
+        CHECK(db.removedEntities() == n - live + expected);
+        checkAgainstScan(db);
+    }
+
+    void indexed()
+    {
+        AdslDatabase db;
+        parseAdslString(corpus(300), db);
+        CHECK(db.isIndexed());
+        removals(db);
+        CHECK(db.isIndexed());
+
+        const std::size_t live = db.entities.size() - db.removedEntities();
+        db.compact();
+        CHECK(db.isIndexed() && db.entities.size() == live);
+        CHECK(db.removedEntities() == 0 && db.removedFields() == 0);
+        checkAgainstScan(db);
+    }
+
+    /* Entities appended by hand : queries scan until reindex(). A compact() bringing
+     * 'entities' back to the count indexed earlier must not revive the old lists. */
+    void unindexed()
+    {
+        AdslDatabase db;
+        parseAdslString("#a\n#a\n#a\n", db);
+        db.entities.emplace_back().type = "b";
+        CHECK(!db.isIndexed());
+        db.removeEntity(0);
+        db.compact();
+        CHECK(db.findEntitiesByType("a").size() == 2);
+        CHECK(db.findEntitiesByType("b").size() == 1);
+        db.reindex();
+        CHECK(db.isIndexed() && db.findEntitiesByType("a").size() == 2);
+
+        AdslDatabase big;
+        parseAdslString(corpus(300), big);
+        AdslEntity& extra = big.entities.emplace_back();
+        extra.type = "a";
+        extra.groups.push_back("g1");
+        extra.fields.push_back(AdslField("x", AdslValue(3)));
+        extra.fields.push_back(AdslField("y", AdslValue(1), { "f" }));
+        removals(big);
+        big.compact();
+        checkAgainstScan(big);
+    }
+
+    /* setCompaction : remove* calls compact on their own past the threshold */
+    void automatic()
+    {
+        AdslDatabase db;
+        parseAdslString(corpus(100), db);
+        db.setCompaction(AdslCompaction{ 10, 0.1 });
+        for (std::size_t i = 0; i < 9; ++i) db.removeEntity(i * 2);
+        CHECK(db.removedEntities() == 9 && db.entities.size() == 100);
+        db.removeEntity(50);
+        CHECK(db.removedEntities() == 0 && db.entities.size() == 90);
+        checkAgainstScan(db);
+
+        adsl::API api;
+        api.loadString(corpus(30));
+        std::vector<AdslEntity*> as = api.entitiesByType("a");
+        CHECK(api.removeEntity(*as[0]) && !api.removeEntity(*as[0]));
+        CHECK(api.entitiesByType("a").size() == as.size() - 1);
+        CHECK(api.removeField(*as[1], as[1]->fields[0]));
+        CHECK(!api.field(*as[1], "x") && api.field(*as[1], "y"));
+        std::size_t seen = 0;
+        api.forEachEntity([&seen](AdslEntity&){ ++seen; });
+        CHECK(seen == 29);
+        CHECK(api.compact() == 2);
+        checkAgainstScan(api.db());
+    }
+}
+
+int main()
+{
+    indexed();
+    unindexed();
+    automatic();
+    return testResult();
+}
@@ -0,0 +1,150 @@
+#include "../include/adsl/adsl_api.hpp"
+#include "../include/adsl/adsl_stream.hpp"
+#include "adsl_test.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/* StreamParser fed in chunks of every small size : same result as one parse of the whole text */
+
+namespace {
+
+    /* comments, and '//' or '#' inside quoted strings, so chunk cuts land inside all of them */
+    const char* const kText =
+        "// leading comment\n"
+        "@g1[1,2]\n"
+        "#a @g1 // trailing comment\n"
+        " - url=\"http://example.com/#anchor\" @f\n"
+        " - path=\"//server/share\"\n"
+        " - list=[\"a//b\",\"c\"]   // list then comment\n"
+        "\n"
+        "#b\n"
+        " - x=1\n"
+        " - y=2.5 @f @g1\n"
+        "@g2\n"
+        "#c @g2\n"
+        " - s=\"// not a comment\"";              // no final newline
+
+    struct Event
+    {
+        char                     kind;          // G(roup) B(egin) F(ield) E(nd)
+        std::string              name;
+        std::vector<std::string> groups;        // or group values
+        AdslValue                value;
+        std::size_t              line = 0;
+
+        bool operator==(const Event& o) const
+        {
+            return kind == o.kind && name == o.name && groups == o.groups && value == o.value && line == o.line;
+        }
+    };
+
+    struct Recorder : AdslHandler
+    {
+        std::vector<Event> events;
+
+        static std::vector<std::string> copy(const std::vector<std::string_view>& v)
+        {
+            return std::vector<std::string>(v.begin(), v.end());
+        }
+        void onGroup(std::string_view name, const std::vector<std::string_view>& values) override
+        {
+            events.push_back(Event{ 'G', std::string(name), copy(values), AdslValue(), line() });
+        }
+        void onEntityBegin(std::string_view type, const std::vector<std::string_view>& groups) override
+        {
+            events.push_back(Event{ 'B', std::string(type), copy(groups), AdslValue(), line() });
+        }
+        void onField(std::string_view name, AdslValue& value, const std::vector<std::string_view>& groups) override
+        {
+            events.push_back(Event{ 'F', std::string(name), copy(groups), value, line() });
+        }
+        void onEntityEnd() override
+        {
+            events.push_back(Event{ 'E', std::string(), {}, AdslValue(), 0 });
+        }
+    };
+
+    void feedInChunks(adsl::StreamParser& parser, const std::string& text, std::size_t chunk)
+    {
+        for (std::size_t pos = 0; pos < text.size(); pos += chunk)
+            parser.feed(text.data() + pos, std::min(chunk, text.size() - pos));
+    }
+
+    void database()
+    {
+        AdslDatabase whole;
+        parseAdslString(kText, whole);
+        const std::string expected = adsl::serialize(whole);
+        CHECK(whole.entities.size() == 3);
+
+        for (std::size_t chunk : { 1, 2, 3, 5, 7, 64, 4096 })
+        {
+            AdslDatabase db;
+            std::vector<std::size_t> closed;
+            adsl::StreamParser parser(db, [&closed](std::size_t e){ closed.push_back(e); });
+            feedInChunks(parser, kText, chunk);
+            CHECK(closed.size() == 2);                      // the last entity waits for finish()
+            CHECK(parser.buffered() < 64);
+            CHECK(parser.finish());
+            CHECK(closed == (std::vector<std::size_t>{ 0, 1, 2 }));
+            CHECK(adsl::serialize(db) == expected);
+            CHECK(db.isIndexed() && db.findFieldsByGroup("f").size() == 2);
+            CHECK(db.entities[0].fields[0].get().asString() == "http://example.com/#anchor");
+            CHECK(db.entities[2].fields[0].get().asString() == "// not a comment");
+            CHECK(parser.lines() == 13);
+        }
+    }
+
+    void handler()
+    {
+        Recorder whole;
+        parseAdslString(kText, whole);
+        CHECK(whole.events.size() == 14);
+
+        for (std::size_t chunk : { 1, 2, 3, 11 })
+        {
+            Recorder r;
+            adsl::StreamParser parser(r);
+            feedInChunks(parser, kText, chunk);
+            parser.finish();
+            CHECK(r.events == whole.events);
+        }
+    }
+
+    /* errors carry the document line; the parser refuses input afterwards */
+    void errors()
+    {
+        const std::string bad = "#a\n - x=1\n - y=\"open\n - z=2\n";
+        for (std::size_t chunk : { 1, 2, 3 })
+        {
+            AdslDatabase db;
+            adsl::StreamParser parser(db);
+            std::string what;
+            try {
+                feedInChunks(parser, bad, chunk);
+                parser.finish();
+            } catch (const std::runtime_error& e) {
+                what = e.what();
+            }
+            CHECK(what.rfind("Line 3:", 0) == 0);
+            CHECK_THROWS(std::logic_error, parser.feed("#b\n"));
+        }
+
+        AdslDatabase db;
+        adsl::StreamParser parser(db);
+        parser.feed("#a\n");
+        parser.finish();
+        CHECK_THROWS(std::logic_error, parser.finish());
+    }
+}
+
+int main()
+{
+    database();
+    handler();
+    errors();
+    return testResult();
+}
@@ -0,0 +1,61 @@
+#include "../include/adsl/adsl_api.hpp"
+#include "adsl_test.hpp"
+
+#include <string>
+
+/* The process-wide symbol table : count(), and reset() between two workloads */
+
+namespace {
+
+    void internAndFind()
+    {
+        const std::size_t before = AdslSymbol::count();
+        CHECK(before >= 1);                                 // "" is always there
+        CHECK(AdslSymbol("").id() == 0 && AdslSymbol().empty());
+
+        AdslSymbol a("symbol_tests_a");
+        CHECK(AdslSymbol::count() == before + 1);
+        CHECK(AdslSymbol("symbol_tests_a") == a && AdslSymbol::count() == before + 1);
+        CHECK(AdslSymbol::find("symbol_tests_a") == a);
+        CHECK(!AdslSymbol::find("symbol_tests_b") && AdslSymbol::count() == before + 1);
+        CHECK(a == "symbol_tests_a" && a.size() == 14);
+    }
+
+    void resetBetweenWorkloads()
+    {
+        {
+            adsl::API api;
+            api.loadString("#first @g\n - name_one=1\n - name_two=\"x\"\n");
+            CHECK(api.entitiesByType("first").size() == 1);
+        }
+        CHECK(AdslSymbol::find("name_one") && AdslSymbol::count() > 4);
+
+        AdslSymbol::reset();
+        CHECK(AdslSymbol::count() == 1);
+        CHECK(!AdslSymbol::find("name_one") && !AdslSymbol::find("first"));
+        CHECK(AdslSymbol::find("") && AdslSymbol::find("")->id() == 0);
+        CHECK(AdslSymbol().str().empty());
+
+        /* the table starts over and works as before */
+        adsl::API api;
+        api.loadString("#second @g\n - name_one=2\n");
+        const AdslEntity& e = *std::as_const(api).entitiesByType("second").at(0);
+        CHECK(e.type == "second" && e.type.id() == 1);
+        CHECK(api.get<int>(e, "name_one") == 2);
+        CHECK(std::as_const(api).entitiesByGroup("g").size() == 1);
+        CHECK(!AdslSymbol::find("name_two"));
+
+        for (int i = 0; i < 10000; ++i) AdslSymbol("symbol_tests_" + std::to_string(i));   // past the first block
+        CHECK(AdslSymbol::count() == 4 + 10000);
+        AdslSymbol::reset();
+        CHECK(AdslSymbol::count() == 1 && !AdslSymbol::find("symbol_tests_9999"));
+        CHECK(AdslSymbol("again").id() == 1 && AdslSymbol("again") == "again");
+    }
+}
+
+int main()
+{
+    internAndFind();
+    resetBetweenWorkloads();
+    return testResult();
+}